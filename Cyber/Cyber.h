@@ -32,6 +32,9 @@
 #include <Cyber/Cyber962IOU.h>
 #include <Cyber/Cyber962PP.h>
 #include <Cyber/Cyber962PPInstructions.h>
+#include <Cyber/CyberOpcodeStatistics.h>
+#include <Cyber/CyberProfile.h>
+#include <Cyber/CyberTrace.h>
 
 
 #endif /* __CYBER_CYBER_H__ */
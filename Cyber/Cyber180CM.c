@@ -23,25 +23,54 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 
 CYBER_SOURCE_BEGIN
 
 
 struct Cyber180CM * _Nullable Cyber180CMCreate(struct Cyber962 * _Nonnull system, size_t capacity, int ports)
+{
+    return Cyber180CMCreateWithStorage(system, capacity, ports, Cyber180CMStorageDense);
+}
+
+
+struct Cyber180CM * _Nullable Cyber180CMCreateWithStorage(struct Cyber962 * _Nonnull system, size_t capacity, int ports, enum Cyber180CMStorage storage)
 {
     assert(system != NULL);
-    assert(   (capacity == (64 * 1) * 1048576)
+    assert(   (storage == Cyber180CMStorageSparse)
+           || (capacity == (64 * 1) * 1048576)
            || (capacity == (64 * 2) * 1048576)
            || (capacity == (64 * 3) * 1048576)
            || (capacity == (64 * 4) * 1048576));
+    assert((capacity > 0) && ((capacity % (64 * 1048576)) == 0));
     assert(ports >= 2);
 
     struct Cyber180CM *cm = calloc(1, sizeof(struct Cyber180CM));
 
     cm->_system = system;
     cm->_capacity = capacity;
-    cm->_storage = calloc(capacity / sizeof(CyberWord64), sizeof(CyberWord64));
+    cm->_storageKind = storage;
+
+    switch (storage) {
+        case Cyber180CMStorageDense:
+            cm->_storage = calloc(capacity / sizeof(CyberWord64), sizeof(CyberWord64));
+            break;
+
+        case Cyber180CMStorageSparse: {
+            // Only reserve address space; the host commits (zeroed) pages as they're first touched.
+            void *reservation = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            cm->_storage = (reservation != MAP_FAILED) ? reservation : NULL;
+        } break;
+    }
+
+    if (cm->_storage == NULL) {
+        assert(cm->_storage != NULL); // halt when built for debugging
+        free(cm);
+        return NULL;
+    }
+
     cm->_portCount = ports;
     cm->_ports = calloc(ports, sizeof(struct Cyber180CMPort *));
 
@@ -51,7 +80,7 @@ struct Cyber180CM * _Nullable Cyber180CMCreate(struct Cyber962 * _Nonnull system
 
     int err = pthread_mutex_init(&cm->_lock, NULL);
     if (err != 0) {
-        assert(err != 0); // halt when built for debugging
+        assert(err == 0); // halt here in debug builds
         Cyber180CMDispose(cm);
         return NULL;
     }
@@ -64,21 +93,76 @@ void Cyber180CMDispose(struct Cyber180CM * _Nullable cm)
 {
     if (cm == NULL) return;
 
-    free(cm->_storage);
+    switch (cm->_storageKind) {
+        case Cyber180CMStorageDense:
+            free(cm->_storage);
+            break;
+
+        case Cyber180CMStorageSparse:
+            munmap(cm->_storage, cm->_capacity);
+            break;
+    }
 
     for (int port = 0; port < cm->_portCount; port++) {
-        free(cm->_ports[port]);
+        Cyber180CMPortDispose(cm->_ports[port]);
     }
+    free(cm->_ports);
 
     int err = pthread_mutex_destroy(&cm->_lock);
     if (err != 0) {
-        assert(err != 0); // halt when built for debugging
+        assert(err == 0); // halt here in debug builds
     }
 
     free(cm);
 }
 
 
+size_t Cyber180CMGetCapacity(struct Cyber180CM *cm)
+{
+    assert(cm != NULL);
+
+    return cm->_capacity;
+}
+
+
+size_t Cyber180CMGetCommittedSize(struct Cyber180CM *cm)
+{
+    assert(cm != NULL);
+
+    if (cm->_storageKind == Cyber180CMStorageDense) {
+        return cm->_capacity;
+    }
+
+    // Ask the host which pages of the storage are resident, a chunk at a time to bound the size of the vector.
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t pagesPerChunk = 4096;
+    unsigned char residency[4096];
+    size_t committed = 0;
+
+    for (size_t offset = 0; offset < cm->_capacity; offset += (pagesPerChunk * pageSize)) {
+        size_t length = cm->_capacity - offset;
+        if (length > (pagesPerChunk * pageSize)) {
+            length = pagesPerChunk * pageSize;
+        }
+
+        int err = mincore(((CyberWord8 *)cm->_storage) + offset, length, (void *)residency);
+        if (err != 0) {
+            assert(err == 0); // halt here in debug builds
+            return cm->_capacity;
+        }
+
+        size_t pages = (length + pageSize - 1) / pageSize;
+        for (size_t page = 0; page < pages; page++) {
+            if (residency[page] & 1) {
+                committed += pageSize;
+            }
+        }
+    }
+
+    return committed;
+}
+
+
 struct Cyber180CMPort *Cyber180CMGetPortAtIndex(struct Cyber180CM *cm, int index)
 {
     assert(cm != NULL);
@@ -94,6 +178,12 @@ void Cyber180CMAcquireLock(struct Cyber180CM *cm)
 }
 
 
+bool Cyber180CMTryAcquireLock(struct Cyber180CM *cm)
+{
+    return pthread_mutex_trylock(&cm->_lock) == 0;
+}
+
+
 void Cyber180CMRelinquishLock(struct Cyber180CM *cm)
 {
     pthread_mutex_unlock(&cm->_lock);
@@ -30,6 +30,17 @@ struct Cyber180CMPort;
 struct Cyber962;
 
 
+/// How a Central Memory's storage is provided by the host.
+enum Cyber180CMStorage {
+
+    /// All of the storage is allocated and zeroed up front.
+    Cyber180CMStorageDense = 0,
+
+    /// The storage is reserved up front but host memory is only committed for the pages the guest actually touches, allowing large configurations on modest hosts.
+    Cyber180CMStorageSparse = 1,
+};
+
+
 /// Create a Cyber 180 Central Memory attached to a system.
 ///
 /// - Parameters:
@@ -46,11 +57,33 @@ struct Cyber962;
 /// - Returns: A Central Memory to connect to the system, or `NULL` on failure.
 CYBER_EXPORT struct Cyber180CM * _Nullable Cyber180CMCreate(struct Cyber962 * _Nonnull system, size_t capacity, int ports);
 
+/// Create a Cyber 180 Central Memory attached to a system, using the given kind of storage.
+///
+/// - Parameters:
+///   - system: The system to which the Central Processor is attached.
+///   - capacity: The amount of memory (in bytes) to support.
+///   - ports: The number of ports to support for accessing the Central Memory (minimum 2), which should be one per Central Processor and one per IOU in the system.
+///   - storage: How the host should provide the storage.
+///
+///   - Warning: With dense storage, only the capacities supported by ``Cyber180CMCreate`` are allowed. With sparse storage, any multiple of 64MB (8MW) is allowed, such as the 1GB (128MW) and larger configurations of Cyber 990-class systems.
+///
+/// - Returns: A Central Memory to connect to the system, or `NULL` on failure.
+CYBER_EXPORT struct Cyber180CM * _Nullable Cyber180CMCreateWithStorage(struct Cyber962 * _Nonnull system, size_t capacity, int ports, enum Cyber180CMStorage storage);
+
 
 /// Dispose of a Cyber180CM.
 CYBER_EXPORT void Cyber180CMDispose(struct Cyber180CM * _Nullable cm);
 
 
+/// Get the capacity of the Central Memory in bytes.
+CYBER_EXPORT size_t Cyber180CMGetCapacity(struct Cyber180CM *cm);
+
+/// Get the number of bytes of host memory actually committed to the Central Memory's storage.
+///
+/// For dense storage this is always the capacity; for sparse storage it's the size of the pages the guest has touched.
+CYBER_EXPORT size_t Cyber180CMGetCommittedSize(struct Cyber180CM *cm);
+
+
 /// Get a port that can be used to access the Central Memory given an index.
 CYBER_EXPORT struct Cyber180CMPort *Cyber180CMGetPortAtIndex(struct Cyber180CM *cm, int index);
 
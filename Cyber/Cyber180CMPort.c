@@ -17,12 +17,17 @@
 //  limitations under the License.
 //
 
-#include <Cyber/Cyber180CMPort.h>
+#include "Cyber180CMPort_Internal.h"
 
 #include "Cyber180CM_Internal.h"
+#include "Cyber962_Internal.h"
+#include "CyberCycleCounter.h"
+#include "CyberSwap.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 
 CYBER_SOURCE_BEGIN
@@ -37,16 +42,80 @@ struct Cyber180CMPort {
     /// The index of this port within the Central Memory.
     int _index;
 
+    /// Whether more than one thread accesses memory through this port.
+    bool _shared;
+
+    /// The span currently mapped via this port, if any.
+    struct Cyber180CMSpan * _Nullable _mappedSpan;
+
     // FIXME: Flesh out.
+
+    /// The sets of counters kept by threads sharing this port, which are added into its statistics.
+    struct Cyber180CMPortCounters * _Nullable _attachedCounters[CYBER180CMPORT_MAX_COUNTERS];
+
+    /// The counters for this port.
+    ///
+    /// These are written on every access, so they start on a cache line of their own. The lock counters are only written while the port access lock is held.
+    CYBER_CACHE_ALIGNED struct Cyber180CMPortStatistics _statistics;
 };
 
 
+_Thread_local struct Cyber180CMPortCounters * _Nullable Cyber180CMPortCurrentCounters = NULL;
+
+
+/// Count an access of `byteCount` bytes through a port, as a write if `write` is set and otherwise as a read.
+static inline void Cyber180CMPortCount(struct Cyber180CMPort *port, bool write, uint64_t byteCount)
+{
+    uint64_t *accesses;
+    uint64_t *bytes;
+
+    struct Cyber180CMPortCounters *counters = Cyber180CMPortCurrentCounters;
+    if ((counters != NULL) && (counters->port == port)) {
+        accesses = write ? &counters->writes : &counters->reads;
+        bytes = write ? &counters->bytesWritten : &counters->bytesRead;
+    } else if (!port->_shared) {
+        accesses = write ? &port->_statistics.writes : &port->_statistics.reads;
+        bytes = write ? &port->_statistics.bytesWritten : &port->_statistics.bytesRead;
+    } else {
+        // A thread without counters of its own may be accessing a shared port alongside others, so it needs atomic increments.
+        __atomic_fetch_add(write ? &port->_statistics.writes : &port->_statistics.reads, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(write ? &port->_statistics.bytesWritten : &port->_statistics.bytesRead, byteCount, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Only this thread writes these counters, so they don't need atomic increments, just stores other threads can read whole.
+    __atomic_store_n(accesses, *accesses + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(bytes, *bytes + byteCount, __ATOMIC_RELAXED);
+}
+
+
+/// Count a read of `byteCount` bytes through a port.
+static inline void Cyber180CMPortCountRead(struct Cyber180CMPort *port, uint64_t byteCount)
+{
+    Cyber180CMPortCount(port, false, byteCount);
+}
+
+
+/// Count a write of `byteCount` bytes through a port.
+static inline void Cyber180CMPortCountWrite(struct Cyber180CMPort *port, uint64_t byteCount)
+{
+    Cyber180CMPortCount(port, true, byteCount);
+}
+
+
 struct Cyber180CMPort * _Nullable Cyber180CMPortCreate(struct Cyber180CM * _Nonnull cm, int index)
 {
     assert(cm != NULL);
     assert((index >= 0) && (index < 5));
 
-    struct Cyber180CMPort *port = calloc(1, sizeof(struct Cyber180CMPort));
+    // Allocate on a cache line boundary so the counters, which are aligned within the structure, really are on a cache line of their own.
+    struct Cyber180CMPort *port = NULL;
+    int alloc_err = posix_memalign((void **)&port, CYBER_CACHE_LINE_SIZE, sizeof(struct Cyber180CMPort));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(port, 0, sizeof(struct Cyber180CMPort));
 
     port->_centralMemory = cm;
     port->_index = index;
@@ -63,12 +132,64 @@ void Cyber180CMPortDispose(struct Cyber180CMPort * _Nullable port)
 }
 
 
+void Cyber180CMPortSetShared(struct Cyber180CMPort *port, bool shared)
+{
+    assert(port != NULL);
+
+    port->_shared = shared;
+}
+
+
+void Cyber180CMPortAttachCounters(struct Cyber180CMPort *port, struct Cyber180CMPortCounters *counters, int index)
+{
+    assert(port != NULL);
+    assert(counters != NULL);
+    assert((index >= 0) && (index < CYBER180CMPORT_MAX_COUNTERS));
+
+    counters->port = port;
+
+    // Publish the counters with a release store, so anyone gathering statistics who sees them sees them set up.
+    __atomic_store_n(&port->_attachedCounters[index], counters, __ATOMIC_RELEASE);
+}
+
+
+void Cyber180CMPortDetachCounters(struct Cyber180CMPort *port, int index)
+{
+    assert(port != NULL);
+    assert((index >= 0) && (index < CYBER180CMPORT_MAX_COUNTERS));
+
+    __atomic_store_n(&port->_attachedCounters[index], NULL, __ATOMIC_RELEASE);
+}
+
+
 void Cyber180CMPortAcquireLock(struct Cyber180CMPort *port)
 {
     assert(port != NULL);
     struct Cyber180CM *cm = port->_centralMemory;
 
-    Cyber180CMAcquireLock(cm);
+    // Only time the wait when there is one, so an uncontended acquisition costs no more than it did.
+    if (!Cyber180CMTryAcquireLock(cm)) {
+        struct CyberTrace *trace = Cyber962GetTimelineTrace(cm->_system);
+        uint64_t startTicks = (trace != NULL) ? CyberCycleCounterRead() : 0;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        Cyber180CMAcquireLock(cm);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        // Attribute the wait to whichever processor is running on this thread, if any.
+        if (trace != NULL) {
+            CyberTraceAppendTimelineEvent(trace, CyberTraceCurrentStream, CyberTimelineEventLockWait, port->_index, 0, startTicks, CyberCycleCounterRead() - startTicks);
+        }
+
+        uint64_t waitNanoseconds = ((uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL) + (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+
+        // The lock is held, so these can't be written concurrently.
+        __atomic_store_n(&port->_statistics.contendedLockAcquisitions, port->_statistics.contendedLockAcquisitions + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&port->_statistics.lockWaitNanoseconds, port->_statistics.lockWaitNanoseconds + waitNanoseconds, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&port->_statistics.lockAcquisitions, port->_statistics.lockAcquisitions + 1, __ATOMIC_RELAXED);
 }
 
 
@@ -81,6 +202,31 @@ void Cyber180CMPortRelinquishLock(struct Cyber180CMPort *port)
 }
 
 
+void Cyber180CMPortGetStatistics(struct Cyber180CMPort *port, struct Cyber180CMPortStatistics *statistics)
+{
+    assert(port != NULL);
+    assert(statistics != NULL);
+
+    statistics->reads = __atomic_load_n(&port->_statistics.reads, __ATOMIC_RELAXED);
+    statistics->bytesRead = __atomic_load_n(&port->_statistics.bytesRead, __ATOMIC_RELAXED);
+    statistics->writes = __atomic_load_n(&port->_statistics.writes, __ATOMIC_RELAXED);
+    statistics->bytesWritten = __atomic_load_n(&port->_statistics.bytesWritten, __ATOMIC_RELAXED);
+    statistics->lockAcquisitions = __atomic_load_n(&port->_statistics.lockAcquisitions, __ATOMIC_RELAXED);
+    statistics->contendedLockAcquisitions = __atomic_load_n(&port->_statistics.contendedLockAcquisitions, __ATOMIC_RELAXED);
+    statistics->lockWaitNanoseconds = __atomic_load_n(&port->_statistics.lockWaitNanoseconds, __ATOMIC_RELAXED);
+
+    for (int index = 0; index < CYBER180CMPORT_MAX_COUNTERS; index++) {
+        struct Cyber180CMPortCounters *counters = __atomic_load_n(&port->_attachedCounters[index], __ATOMIC_ACQUIRE);
+        if (counters == NULL) continue;
+
+        statistics->reads += __atomic_load_n(&counters->reads, __ATOMIC_RELAXED);
+        statistics->bytesRead += __atomic_load_n(&counters->bytesRead, __ATOMIC_RELAXED);
+        statistics->writes += __atomic_load_n(&counters->writes, __ATOMIC_RELAXED);
+        statistics->bytesWritten += __atomic_load_n(&counters->bytesWritten, __ATOMIC_RELAXED);
+    }
+}
+
+
 void Cyber180CMPortReadWordsPhysical(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 *buffer, CyberWord32 wordCount)
 {
     assert(port != NULL);
@@ -99,6 +245,8 @@ void Cyber180CMPortReadWordsPhysical(struct Cyber180CMPort *port, CyberWord48 ad
             buffer[i] = storage[firstWord + i];
         }
     } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountRead(port, wordCount * sizeof(CyberWord64));
 }
 
 
@@ -120,6 +268,8 @@ void Cyber180CMPortWriteWordsPhysical(struct Cyber180CMPort *port, CyberWord48 a
             storage[firstWord + i] = buffer[i];
         }
     } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountWrite(port, wordCount * sizeof(CyberWord64));
 }
 
 
@@ -142,6 +292,8 @@ void Cyber180CMPortReadBytesPhysical(struct Cyber180CMPort *port, CyberWord48 ad
             buffer[i] = firstByte[i];
         }
     } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountRead(port, byteCount);
 }
 
 
@@ -165,6 +317,184 @@ void Cyber180CMPortWriteBytesPhysical(struct Cyber180CMPort *port, CyberWord48 a
         }
 
     } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountWrite(port, byteCount);
+}
+
+
+void Cyber180CMPortReadWordsSwapped(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 *buffer, CyberWord32 wordCount)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+    assert(buffer != NULL);
+    assert((address + (wordCount * sizeof(CyberWord64))) <= cm->_capacity); // Don't allow rollover.
+
+    Cyber180CMPortAcquireLock(port); {
+        CyberWord64 *storage = cm->_storage;
+        CyberWord48 firstWord = address / 8;
+
+        CyberWord64SwapMultiple(buffer, &storage[firstWord], wordCount);
+    } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountRead(port, wordCount * sizeof(CyberWord64));
+}
+
+
+void Cyber180CMPortWriteWordsSwapped(struct Cyber180CMPort *port, CyberWord48 address, const CyberWord64 *buffer, CyberWord32 wordCount)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+    assert(buffer != NULL);
+    assert((address + (wordCount * sizeof(CyberWord64))) <= cm->_capacity); // Don't allow rollover.
+
+    Cyber180CMPortAcquireLock(port); {
+        CyberWord64 *storage = cm->_storage;
+        CyberWord48 firstWord = address / 8;
+
+        CyberWord64SwapMultiple(&storage[firstWord], buffer, wordCount);
+    } Cyber180CMPortRelinquishLock(port);
+
+    Cyber180CMPortCountWrite(port, wordCount * sizeof(CyberWord64));
+}
+
+
+void Cyber180CMPortMapRange(struct Cyber180CMPort *port, CyberWord48 address, CyberWord32 length, enum Cyber180CMAccess access, struct Cyber180CMSpan *span)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert(span != NULL);
+    assert((access & Cyber180CMAccess_ReadWrite) != 0);
+    assert((address + length) <= cm->_capacity); // Don't allow rollover.
+
+    // The lock is held for as long as the span is mapped, so access through it is just as exclusive as a copy would have been.
+
+    Cyber180CMPortAcquireLock(port);
+
+    assert(port->_mappedSpan == NULL); // only one span per port at a time
+    port->_mappedSpan = span;
+
+    CyberWord8 *storageBytes = (CyberWord8 *)cm->_storage;
+
+    span->bytes = storageBytes + address;
+    span->address = address;
+    span->length = length;
+    span->access = access;
+
+    if (access & Cyber180CMAccess_Read) {
+        Cyber180CMPortCountRead(port, length);
+    }
+    if (access & Cyber180CMAccess_Write) {
+        Cyber180CMPortCountWrite(port, length);
+    }
+}
+
+
+void Cyber180CMPortUnmapRange(struct Cyber180CMPort *port, struct Cyber180CMSpan *span)
+{
+    assert(port != NULL);
+    assert(span != NULL);
+    assert(port->_mappedSpan == span); // must be the span mapped via this port
+
+    port->_mappedSpan = NULL;
+
+    span->bytes = NULL;
+    span->length = 0;
+
+    Cyber180CMPortRelinquishLock(port);
+}
+
+
+CyberWord64 Cyber180CMPortReadWordPhysical(struct Cyber180CMPort *port, CyberWord48 address)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+
+    CyberWord64 *storage = cm->_storage;
+    CyberWord48 wordIndex = address / 8;
+
+    Cyber180CMPortCountRead(port, sizeof(CyberWord64));
+
+    return __atomic_load_n(&storage[wordIndex], __ATOMIC_RELAXED);
+}
+
+void Cyber180CMPortWriteWordPhysical(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 word)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+
+    CyberWord64 *storage = cm->_storage;
+    CyberWord48 wordIndex = address / 8;
+
+    Cyber180CMPortCountWrite(port, sizeof(CyberWord64));
+
+    __atomic_store_n(&storage[wordIndex], word, __ATOMIC_RELAXED);
+}
+
+
+CyberWord64 Cyber180CMPortFetchOr64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 mask)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+
+    CyberWord64 *storage = cm->_storage;
+    CyberWord48 wordIndex = address / 8;
+
+    Cyber180CMPortCountRead(port, sizeof(CyberWord64));
+    Cyber180CMPortCountWrite(port, sizeof(CyberWord64));
+
+    return __atomic_fetch_or(&storage[wordIndex], mask, __ATOMIC_SEQ_CST);
+}
+
+CyberWord64 Cyber180CMPortFetchAnd64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 mask)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+
+    CyberWord64 *storage = cm->_storage;
+    CyberWord48 wordIndex = address / 8;
+
+    Cyber180CMPortCountRead(port, sizeof(CyberWord64));
+    Cyber180CMPortCountWrite(port, sizeof(CyberWord64));
+
+    return __atomic_fetch_and(&storage[wordIndex], mask, __ATOMIC_SEQ_CST);
+}
+
+bool Cyber180CMPortCompareExchange64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 *expected, CyberWord64 desired)
+{
+    assert(port != NULL);
+    struct Cyber180CM *cm = port->_centralMemory;
+
+    assert(address < cm->_capacity);
+    assert((address % 8) == 0); // must be on a word boundary
+    assert(expected != NULL);
+
+    CyberWord64 *storage = cm->_storage;
+    CyberWord48 wordIndex = address / 8;
+
+    Cyber180CMPortCountRead(port, sizeof(CyberWord64));
+    Cyber180CMPortCountWrite(port, sizeof(CyberWord64));
+
+    return __atomic_compare_exchange_n(&storage[wordIndex], expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 }
 
 
@@ -178,6 +508,8 @@ CyberWord64 Cyber180CMPortReadWordPhysical_Unlocked(struct Cyber180CMPort *port,
     CyberWord64 *storage = cm->_storage;
     CyberWord48 wordIndex = address / 8;
 
+    Cyber180CMPortCountRead(port, sizeof(CyberWord64));
+
     return storage[wordIndex];
 }
 
@@ -191,6 +523,8 @@ void Cyber180CMPortWriteWordPhysical_Unlocked(struct Cyber180CMPort *port, Cyber
     CyberWord64 *storage = cm->_storage;
     CyberWord48 wordIndex = address / 8;
 
+    Cyber180CMPortCountWrite(port, sizeof(CyberWord64));
+
     storage[wordIndex] = word;
 }
 
@@ -29,6 +29,65 @@ struct Cyber180CM;
 struct Cyber180CMPort;
 
 
+/// The kind of access that will be made to a mapped range of Central Memory.
+enum Cyber180CMAccess {
+
+    /// The range will only be read.
+    Cyber180CMAccess_Read = 1,
+
+    /// The range will only be written.
+    Cyber180CMAccess_Write = 2,
+
+    /// The range will be both read and written.
+    Cyber180CMAccess_ReadWrite = 3,
+};
+
+
+/// A range of Central Memory mapped for direct access through a port.
+///
+/// A span points directly into Central Memory storage, so its contents can be operated on in place instead of being copied through a buffer. The storage holds Cyber (big-endian) bytes, exactly as ``Cyber180CMPortReadBytesPhysical`` would return them.
+struct Cyber180CMSpan {
+
+    /// The first byte of the range in Central Memory storage.
+    CyberWord8 * _Nullable bytes;
+
+    /// The physical address of the first byte of the range.
+    CyberWord48 address;
+
+    /// The number of bytes in the range.
+    CyberWord32 length;
+
+    /// The access that will be made to the range.
+    enum Cyber180CMAccess access;
+};
+
+
+/// Live counters for a Central Memory port.
+struct Cyber180CMPortStatistics {
+
+    /// The number of reads made through the port, counting a read-modify-write as both a read and a write.
+    uint64_t reads;
+
+    /// The number of bytes read through the port.
+    uint64_t bytesRead;
+
+    /// The number of writes made through the port.
+    uint64_t writes;
+
+    /// The number of bytes written through the port.
+    uint64_t bytesWritten;
+
+    /// The number of times the port acquired the port access lock.
+    uint64_t lockAcquisitions;
+
+    /// The number of those acquisitions that had to wait for another port to relinquish the lock.
+    uint64_t contendedLockAcquisitions;
+
+    /// The total time spent waiting for the lock, in nanoseconds.
+    uint64_t lockWaitNanoseconds;
+};
+
+
 /// Create a Cyber 180 Central Memory access port and let it know its index.
 CYBER_EXPORT struct Cyber180CMPort * _Nullable Cyber180CMPortCreate(struct Cyber180CM *cm, int index);
 
@@ -43,6 +102,12 @@ CYBER_EXPORT void Cyber180CMPortAcquireLock(struct Cyber180CMPort *port);
 CYBER_EXPORT void Cyber180CMPortRelinquishLock(struct Cyber180CMPort *port);
 
 
+/// Get the live counters for a port.
+///
+/// - Note: This may be called from any thread; while the port is in use, the result is only a snapshot.
+CYBER_EXPORT void Cyber180CMPortGetStatistics(struct Cyber180CMPort *port, struct Cyber180CMPortStatistics *statistics);
+
+
 /// Read words from physical memory into a buffer.
 ///
 /// - Warning: This acquires and holds the port access lock.
@@ -64,6 +129,69 @@ CYBER_EXPORT void Cyber180CMPortReadBytesPhysical(struct Cyber180CMPort *port, C
 CYBER_EXPORT void Cyber180CMPortWriteBytesPhysical(struct Cyber180CMPort *port, CyberWord48 address, CyberWord8 *buffer, CyberWord32 byteCount);
 
 
+/// Read words from physical memory into a buffer, swapping them from Cyber (big-endian) to host byte order.
+///
+/// - Warning: This acquires and holds the port access lock.
+CYBER_EXPORT void Cyber180CMPortReadWordsSwapped(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 *buffer, CyberWord32 wordCount);
+
+/// Write words from a buffer to physical memory, swapping them from host to Cyber (big-endian) byte order.
+///
+/// - Warning: This acquires and holds the port access lock.
+CYBER_EXPORT void Cyber180CMPortWriteWordsSwapped(struct Cyber180CMPort *port, CyberWord48 address, const CyberWord64 *buffer, CyberWord32 wordCount);
+
+
+/// Map a range of physical memory for direct access, filling in `span`.
+///
+/// Any access made through the span must stay within its bounds and must match its access mode.
+///
+/// - Warning: This acquires the port access lock and holds it until ``Cyber180CMPortUnmapRange`` is called, so a port may only have one range mapped at a time and must not otherwise access memory while it does.
+CYBER_EXPORT void Cyber180CMPortMapRange(struct Cyber180CMPort *port, CyberWord48 address, CyberWord32 length, enum Cyber180CMAccess access, struct Cyber180CMSpan *span);
+
+/// Unmap a range of physical memory previously mapped via ``Cyber180CMPortMapRange``.
+///
+/// - Warning: This relinquishes the port access lock; the span must not be used afterwards.
+CYBER_EXPORT void Cyber180CMPortUnmapRange(struct Cyber180CMPort *port, struct Cyber180CMSpan *span);
+
+
+/// Read an aligned word from physical memory, without swapping it from Cyber (big-endian) byte order.
+///
+/// This is the fast path for word loads: An aligned word is accessed with a single host load, which is atomic with respect to other single-word accesses, so it doesn't acquire the port access lock.
+CYBER_EXPORT CyberWord64 Cyber180CMPortReadWordPhysical(struct Cyber180CMPort *port, CyberWord48 address);
+
+/// Write an aligned word to physical memory, without swapping it to Cyber (big-endian) byte order.
+///
+/// This is the fast path for word stores: An aligned word is accessed with a single host store, which is atomic with respect to other single-word accesses, so it doesn't acquire the port access lock.
+CYBER_EXPORT void Cyber180CMPortWriteWordPhysical(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 word);
+
+
+/// Atomically OR `mask` into an aligned word of physical memory.
+///
+/// Both `mask` and the result are in the same byte order as storage, which doesn't matter for a bitwise operation as long as the two agree.
+///
+/// - Returns: The word's previous value.
+///
+/// - Note: This doesn't acquire the port access lock, so it only serializes with other accesses to the same word.
+CYBER_EXPORT CyberWord64 Cyber180CMPortFetchOr64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 mask);
+
+/// Atomically AND `mask` into an aligned word of physical memory.
+///
+/// Both `mask` and the result are in the same byte order as storage, which doesn't matter for a bitwise operation as long as the two agree.
+///
+/// - Returns: The word's previous value.
+///
+/// - Note: This doesn't acquire the port access lock, so it only serializes with other accesses to the same word.
+CYBER_EXPORT CyberWord64 Cyber180CMPortFetchAnd64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 mask);
+
+/// Atomically replace an aligned word of physical memory with `desired` if it's equal to `*expected`.
+///
+/// Both words are in the same byte order as storage.
+///
+/// - Returns: `true` if the word was replaced; otherwise `false`, with the word's current value stored in `*expected`.
+///
+/// - Note: This doesn't acquire the port access lock, so it only serializes with other accesses to the same word.
+CYBER_EXPORT bool Cyber180CMPortCompareExchange64(struct Cyber180CMPort *port, CyberWord48 address, CyberWord64 *expected, CyberWord64 desired);
+
+
 /// Read a word from physical memory, without holding a lock.
 ///
 /// - Warning: This **DOES NOT** acquires and holds the port access lock itself.
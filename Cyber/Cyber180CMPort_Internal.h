@@ -0,0 +1,76 @@
+//
+//  Cyber180CMPort_Internal.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/Cyber180CMPort.h>
+
+#ifndef __CYBER_CYBER180CMPORT_INTERNAL_H__
+#define __CYBER_CYBER180CMPORT_INTERNAL_H__
+
+CYBER_HEADER_BEGIN
+
+
+/// Access counters kept by one of the threads sharing a port, such as a Peripheral Processor's on its I/O Unit's port.
+///
+/// These are written on every access, so each set is on cache lines of its own; that way the threads sharing a port neither contend on its counters nor need atomic increments.
+struct Cyber180CMPortCounters {
+
+    /// The port whose accesses these count, or `NULL` while they're not attached to one.
+    struct Cyber180CMPort * _Nullable port;
+
+    /// The number of reads made through the port.
+    uint64_t reads;
+
+    /// The number of bytes read through the port.
+    uint64_t bytesRead;
+
+    /// The number of writes made through the port.
+    uint64_t writes;
+
+    /// The number of bytes written through the port.
+    uint64_t bytesWritten;
+} CYBER_PROCESSOR_ALIGNED;
+
+
+/// The most sets of counters that can be attached to a port, one for each Peripheral Processor in an I/O Unit.
+#define CYBER180CMPORT_MAX_COUNTERS 20
+
+
+/// The counters the calling thread counts its accesses in, for the port they're attached to.
+///
+/// Accesses through any other port, or by a thread without counters of its own, are counted in the port's own counters.
+CYBER_EXPORT _Thread_local struct Cyber180CMPortCounters * _Nullable Cyber180CMPortCurrentCounters;
+
+
+/// Note whether more than one thread accesses memory through a port.
+///
+/// A port used by a single thread counts its lockless accesses with plain stores; a shared one, like an I/O Unit's port used by all of its Peripheral Processors, needs atomic increments so no counts are lost, unless the accessing thread has counters of its own attached to the port.
+CYBER_EXPORT void Cyber180CMPortSetShared(struct Cyber180CMPort *port, bool shared);
+
+/// Attach a set of counters to a port as its `index`th, so they're included in its statistics.
+CYBER_EXPORT void Cyber180CMPortAttachCounters(struct Cyber180CMPort *port, struct Cyber180CMPortCounters *counters, int index);
+
+/// Detach the `index`th set of counters from a port, dropping its counts from the port's statistics.
+///
+/// - Warning: No thread may still be counting in the set.
+CYBER_EXPORT void Cyber180CMPortDetachCounters(struct Cyber180CMPort *port, int index);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBER180CMPORT_INTERNAL_H__ */
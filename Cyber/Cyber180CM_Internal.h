@@ -38,7 +38,12 @@ struct Cyber180CM {
     /// Capacity of the Central Memory.
     size_t _capacity;
 
+    /// How the storage for the Central Memory is provided.
+    enum Cyber180CMStorage _storageKind;
+
     /// Storage for the Central Memory.
+    ///
+    /// - Note: Sparse storage is still contiguous, the host's virtual memory system acts as its page table.
     CyberWord64 *_storage;
 
     /// Number of ports.
@@ -59,6 +64,11 @@ struct Cyber180CM {
 /// Acquire the port access lock.
 CYBER_EXPORT void Cyber180CMAcquireLock(struct Cyber180CM *cm);
 
+/// Acquire the port access lock if no other port holds it.
+///
+/// - Returns: `true` if the lock was acquired.
+CYBER_EXPORT bool Cyber180CMTryAcquireLock(struct Cyber180CM *cm);
+
 /// Relinquish the port access lock.
 CYBER_EXPORT void Cyber180CMRelinquishLock(struct Cyber180CM *cm);
 
@@ -22,19 +22,24 @@
 #include <Cyber/Cyber180CMPort.h>
 
 #include "Cyber180CPInstructions_Internal.h"
+#include "Cyber962_Internal.h"
+#include "CyberCycleCounter.h"
+#include "CyberOpcodeStatistics_Internal.h"
 #include "CyberThread.h"
+#include "CyberTrace_Internal.h"
 
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 CYBER_SOURCE_BEGIN
 
 
+static void Cyber180CPThreadStart(struct CyberThread *thread, void * _Nullable cpv);
 static void Cyber180CPMainLoop(struct CyberThread *thread, void * _Nullable cpv);
-
-static void Cyber180CPSingleStep(struct Cyber180CP *cp);
+static void Cyber180CPThreadStop(struct CyberThread *thread, void * _Nullable cpv);
 
 
 struct Cyber180CP * _Nullable Cyber180CPCreate(struct Cyber962 * _Nonnull system, int index)
@@ -42,22 +47,45 @@ struct Cyber180CP * _Nullable Cyber180CPCreate(struct Cyber962 * _Nonnull system
     assert(system != NULL);
     assert((index >= 0) && (index <= 1));
 
-    struct Cyber180CP *cp = calloc(1, sizeof(struct Cyber180CP));
+    // Allocate on a cache line boundary so the registers, which are aligned within the structure, really are on cache lines of their own.
+    struct Cyber180CP *cp = NULL;
+    int alloc_err = posix_memalign((void **)&cp, CYBER_PROCESSOR_ALIGNMENT, sizeof(struct Cyber180CP));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(cp, 0, sizeof(struct Cyber180CP));
 
     cp->_system = system;
     cp->_index = index;
 
+#if CYBER_STATISTICS
+    // Every instruction updates the counters, so allocate them before there's a thread that could execute one.
+    cp->_opcodeStatistics = calloc(1, sizeof(struct Cyber180CPOpcodeStatistics));
+    if (cp->_opcodeStatistics == NULL) {
+        assert(cp->_opcodeStatistics != NULL); // halt here in debug builds
+        free(cp);
+        return NULL;
+    }
+#endif
+
     static struct CyberThreadFunctions Cyber180CPThreadFunctions = {
-        .start = NULL,
+        .start = Cyber180CPThreadStart,
         .loop = Cyber180CPMainLoop,
-        .stop = NULL,
-        .terminate = NULL,
+        .stop = Cyber180CPThreadStop,
+        .terminate = Cyber180CPThreadStop,
     };
 
-    char name[32];
-    snprintf(name, 32, "Cyber180CP-%d", index);
+    // In lockstep mode the system steps the CP itself, so it doesn't get a thread.
+    if (Cyber962GetRunMode(system) == Cyber962RunModeThreaded) {
+        char name[32];
+        snprintf(name, 32, "Cyber180CP-%d", index);
 
-    cp->_thread = CyberThreadCreate(name, &Cyber180CPThreadFunctions, cp);
+        struct CyberThreadAttributes attributes;
+        Cyber962GetCentralProcessorThreadAttributes(system, index, &attributes);
+
+        cp->_thread = CyberThreadCreateWithAttributes(name, &Cyber180CPThreadFunctions, cp, &attributes);
+    }
 
     cp->_mode = Cyber180CPModeMonitor;
 
@@ -69,29 +97,75 @@ void Cyber180CPDispose(struct Cyber180CP * _Nullable cp)
 {
     if (cp == NULL) return;
 
+    // Terminate and join the thread before freeing anything it uses.
+    CyberThreadDispose(cp->_thread);
+
+#if CYBER_STATISTICS
+    free(cp->_opcodeStatistics);
+#endif
+
     free(cp);
 }
 
 
+/// Record a change in a Central Processor's state to the system's timeline, if it's being traced.
+static void Cyber180CPRecordTimelineState(struct Cyber180CP *cp, enum CyberTimelineEvent event)
+{
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(cp->_system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_CP_STREAM(cp->_index), event, 0, 0, CyberCycleCounterRead(), 0);
+    }
+}
+
+
 void Cyber180CPStart(struct Cyber180CP *cp)
 {
     assert(cp != NULL);
 
-    CyberThreadStart(cp->_thread);
+    if (cp->_thread != NULL) {
+        CyberThreadStart(cp->_thread);
+    } else {
+        // In lockstep mode the system steps the CP on this thread, so this thread may record to its stream.
+        cp->_running = true;
+        Cyber180CPRecordTimelineState(cp, CyberTimelineEventRunning);
+    }
 }
 
 void Cyber180CPStop(struct Cyber180CP *cp)
 {
     assert(cp != NULL);
 
-    CyberThreadStop(cp->_thread);
+    if (cp->_thread != NULL) {
+        CyberThreadStop(cp->_thread);
+    } else {
+        cp->_running = false;
+        Cyber180CPRecordTimelineState(cp, CyberTimelineEventStopped);
+    }
 }
 
 void Cyber180CPShutDown(struct Cyber180CP *cp)
 {
     assert(cp != NULL);
 
-    CyberThreadTerminate(cp->_thread);
+    if (cp->_thread != NULL) {
+        CyberThreadTerminate(cp->_thread);
+    } else {
+        cp->_running = false;
+    }
+}
+
+
+/// The thread function called when a Central Processor starts running.
+static void Cyber180CPThreadStart(struct CyberThread *thread, void * _Nullable cpv)
+{
+    struct Cyber180CP *cp = (struct Cyber180CP *)cpv;
+    assert(cp != NULL);
+
+    Cyber962SafepointEnter(cp->_system);
+    cp->_safepointRegistered = true;
+
+    CyberTraceCurrentStream = CYBER_TRACE_CP_STREAM(cp->_index);
+    Cyber180CPRecordTimelineState(cp, CyberTimelineEventRunning);
 }
 
 
@@ -100,11 +174,66 @@ void Cyber180CPMainLoop(struct CyberThread *thread, void * _Nullable cpv)
     struct Cyber180CP *cp = (struct Cyber180CP *)cpv;
     assert(cp != NULL);
 
+    // Park here if the system is being paused, so the pause happens on an instruction boundary.
+    Cyber962SafepointPoll(cp->_system);
+
     // Run the main loop once.
     Cyber180CPSingleStep(cp);
 }
 
 
+/// The thread function called when a Central Processor stops running or is shut down.
+static void Cyber180CPThreadStop(struct CyberThread *thread, void * _Nullable cpv)
+{
+    struct Cyber180CP *cp = (struct Cyber180CP *)cpv;
+    assert(cp != NULL);
+
+    // The thread also stops once when it's created, before it has ever started.
+    if (cp->_safepointRegistered) {
+        Cyber180CPRecordTimelineState(cp, CyberTimelineEventStopped);
+        CyberTraceCurrentStream = -1;
+
+        cp->_safepointRegistered = false;
+        Cyber962SafepointLeave(cp->_system);
+    }
+}
+
+
+uint64_t Cyber180CPGetInstructionCount(struct Cyber180CP *cp)
+{
+    assert(cp != NULL);
+
+    return (  __atomic_load_n(&cp->_instructionCounts[Cyber180CPModeJob], __ATOMIC_RELAXED)
+            + __atomic_load_n(&cp->_instructionCounts[Cyber180CPModeMonitor], __ATOMIC_RELAXED));
+}
+
+
+void Cyber180CPGetStatistics(struct Cyber180CP *cp, struct Cyber180CPStatistics *statistics)
+{
+    assert(cp != NULL);
+    assert(statistics != NULL);
+
+    statistics->jobInstructions = __atomic_load_n(&cp->_instructionCounts[Cyber180CPModeJob], __ATOMIC_RELAXED);
+    statistics->monitorInstructions = __atomic_load_n(&cp->_instructionCounts[Cyber180CPModeMonitor], __ATOMIC_RELAXED);
+}
+
+
+bool Cyber180CPGetOpcodeStatistics(struct Cyber180CP *cp, struct Cyber180CPOpcodeStatistics *statistics)
+{
+    assert(cp != NULL);
+    assert(statistics != NULL);
+
+    memset(statistics, 0, sizeof(struct Cyber180CPOpcodeStatistics));
+
+#if CYBER_STATISTICS
+    CyberOpcodeCounterAccumulate(statistics->opcodes, cp->_opcodeStatistics->opcodes, CYBER180CP_OPCODE_COUNT);
+    return true;
+#else
+    return false;
+#endif
+}
+
+
 struct Cyber180CMPort * _Nonnull Cyber180CPGetCentralMemoryPort(struct Cyber180CP *cp)
 {
     assert(cp != NULL);
@@ -192,6 +321,57 @@ void Cyber180CPReadBytes(struct Cyber180CP *cp, CyberWord64 virtualAddress, Cybe
 }
 
 
+bool Cyber180CPReadWord(struct Cyber180CP *cp, CyberWord64 virtualAddress, CyberWord64 *word)
+{
+    assert(cp != NULL);
+    assert(word != NULL);
+
+    if ((virtualAddress % 8) != 0) {
+        Cyber180CPSetMonitorCondition(cp, Cyber180CPMonitorConditionAddressSpecificationError);
+        return false;
+    }
+
+    CyberWord64 physicalAddress = Cyber180CPTranslateAddress(cp, virtualAddress);
+
+    struct Cyber180CMPort *port = Cyber180CPGetCentralMemoryPort(cp);
+    *word = CyberWord64Swap(Cyber180CMPortReadWordPhysical(port, physicalAddress));
+    return true;
+}
+
+
+bool Cyber180CPWriteWord(struct Cyber180CP *cp, CyberWord64 virtualAddress, CyberWord64 word)
+{
+    assert(cp != NULL);
+
+    if ((virtualAddress % 8) != 0) {
+        Cyber180CPSetMonitorCondition(cp, Cyber180CPMonitorConditionAddressSpecificationError);
+        return false;
+    }
+
+    CyberWord64 physicalAddress = Cyber180CPTranslateAddress(cp, virtualAddress);
+
+    struct Cyber180CMPort *port = Cyber180CPGetCentralMemoryPort(cp);
+    Cyber180CMPortWriteWordPhysical(port, physicalAddress, CyberWord64Swap(word));
+    return true;
+}
+
+
+void Cyber180CPSetMonitorCondition(struct Cyber180CP *cp, enum Cyber180CPMonitorCondition condition)
+{
+    assert(cp != NULL);
+
+    cp->_regMCR |= condition;
+
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(cp->_system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_CP_STREAM(cp->_index), CyberTimelineEventInterrupt, 0, condition, CyberCycleCounterRead(), 0);
+    }
+
+    // Monitor condition interrupts aren't implemented, so stop the processor instead, leaving the condition in MCR and P at the faulting instruction, rather than let guest code run on past it.
+    Cyber180CPStop(cp);
+}
+
+
 CyberWord64 Cyber180CPTranslateAddress(struct Cyber180CP *cp, CyberWord64 virtualAddress)
 {
     assert(cp != NULL);
@@ -216,22 +396,101 @@ union Cyber180CPInstructionWord Cyber180CPReadInstructionWord(struct Cyber180CP
     struct Cyber180CMPort *port = Cyber180CPGetCentralMemoryPort(cp);
     Cyber180CMPortReadBytesPhysical(port, physicalAddress, (CyberWord8 *)&minimalWord, sizeof(CyberWord16));
 
-    result._raw = ((CyberWord32)minimalWord) << 16;
+    result._raw = ((CyberWord32)CyberWord16Swap(minimalWord)) << 16;
 
     CyberWord64 advance = Cyber180CPInstructionAdvance(result);
     if (advance == 4) {
         Cyber180CMPortReadBytesPhysical(port, physicalAddress + 2, (CyberWord8 *)&minimalWord, sizeof(CyberWord16));
-        result._raw |= ((CyberWord32)minimalWord);
+        result._raw |= ((CyberWord32)CyberWord16Swap(minimalWord));
     }
 
     return result;
 }
 
 
+/// Append a record of an instruction that just executed to the instruction trace, as differences from the previous record when possible.
+static void Cyber180CPTraceInstruction(struct Cyber180CP *cp, struct CyberTrace *trace, CyberWord64 address, union Cyber180CPInstructionWord instructionWord)
+{
+    CyberWord8 record[CYBER_INSTRUCTION_TRACE_MAX_RECORD_BYTES];
+    size_t length = 1;
+
+    // Start over from a keyframe when the trace has restarted or dropped a record, since there's nothing to take differences from.
+    const uint32_t generation = CyberTraceGetGeneration(trace);
+    const bool keyframe = !cp->_traceSynchronized || (cp->_traceGeneration != generation);
+
+    // Only the jk instructions, 0x00-0x3F and 0x70-0x7F, are 2 bytes long; this is Cyber180CPInstructionAdvance without the calls, since it runs on every instruction.
+    const CyberWord8 opcode = instructionWord._raw >> 24;
+    const CyberWord64 instructionLength = ((opcode < 0x40) || ((opcode & 0xF0) == 0x70)) ? 2 : 4;
+
+    CyberWord8 flags = (instructionLength == 4) ? CyberInstructionTraceFlagLong : 0;
+    if (keyframe) {
+        flags |= CyberInstructionTraceFlagKeyframe;
+        length += CyberTraceEncodeVarint(&record[length], address);
+    }
+
+    record[length++] = (CyberWord8)(instructionWord._raw >> 24);
+    record[length++] = (CyberWord8)(instructionWord._raw >> 16);
+    if (instructionLength == 4) {
+        record[length++] = (CyberWord8)(instructionWord._raw >> 8);
+        record[length++] = (CyberWord8)(instructionWord._raw >> 0);
+    }
+
+    const CyberWord64 fallthrough = address + instructionLength;
+    if (cp->_regP != fallthrough) {
+        flags |= CyberInstructionTraceFlagJump;
+        length += CyberTraceEncodeZigzag(&record[length], cp->_regP - fallthrough);
+    }
+
+    if (keyframe) {
+        for (int i = 0; i < 16; i++) {
+            length += CyberTraceEncodeVarint(&record[length], cp->_regX[i]);
+        }
+        for (int i = 0; i < 16; i++) {
+            length += CyberTraceEncodeVarint(&record[length], cp->_regA[i]);
+        }
+        memcpy(cp->_traceX, cp->_regX, sizeof(cp->_traceX));
+        memcpy(cp->_traceA, cp->_regA, sizeof(cp->_traceA));
+    } else if ((memcmp(cp->_regX, cp->_traceX, sizeof(cp->_traceX)) != 0) || (memcmp(cp->_regA, cp->_traceA, sizeof(cp->_traceA)) != 0)) {
+        // Most instructions change at most a register or two, so it's worth finding out whether any changed before working out which.
+        uint32_t changedRegisters = 0;
+        for (int i = 0; i < 16; i++) {
+            if (cp->_regX[i] != cp->_traceX[i]) changedRegisters |= 1U << i;
+            if (cp->_regA[i] != cp->_traceA[i]) changedRegisters |= 1U << (16 + i);
+        }
+
+        flags |= CyberInstructionTraceFlagRegisters;
+        length += CyberTraceEncodeVarint(&record[length], changedRegisters);
+        for (int i = 0; i < 16; i++) {
+            if ((changedRegisters & (1U << i)) == 0) continue;
+            length += CyberTraceEncodeZigzag(&record[length], cp->_regX[i] - cp->_traceX[i]);
+            cp->_traceX[i] = cp->_regX[i];
+        }
+        for (int i = 0; i < 16; i++) {
+            if ((changedRegisters & (1U << (16 + i))) == 0) continue;
+            length += CyberTraceEncodeZigzag(&record[length], cp->_regA[i] - cp->_traceA[i]);
+            cp->_traceA[i] = cp->_regA[i];
+        }
+    }
+
+    record[0] = flags;
+
+    // If the writer has fallen behind, drop the record rather than wait for it, and resynchronize with a keyframe.
+    cp->_traceSynchronized = CyberTraceAppend(trace, CYBER_TRACE_CP_STREAM(cp->_index), record, length);
+    cp->_traceGeneration = generation;
+}
+
+
 void Cyber180CPSingleStep(struct Cyber180CP *cp)
 {
     assert(cp != NULL);
 
+#if CYBER_STATISTICS
+    uint64_t startCycles = CyberCycleCounterRead();
+#endif
+
+    // Count the instruction in the mode it started executing in, since it may exchange to the other.
+    const enum Cyber180CPMode mode = cp->_mode;
+
     CyberWord64 oldP = cp->_regP;
     union Cyber180CPInstructionWord instructionWord = Cyber180CPReadInstructionWord(cp, oldP);
     Cyber180CPInstruction instruction = Cyber180CPInstructionDecode(cp, instructionWord, oldP);
@@ -245,6 +504,18 @@ void Cyber180CPSingleStep(struct Cyber180CP *cp)
         // TODO: Illegal instruction interrupt
         assert(false);
     }
+
+    // Only this thread writes the count, so it doesn't need an atomic increment, just a store other threads can read whole.
+    __atomic_store_n(&cp->_instructionCounts[mode], cp->_instructionCounts[mode] + 1, __ATOMIC_RELAXED);
+
+    struct CyberTrace *trace = __atomic_load_n(&cp->_system->_instructionTrace, __ATOMIC_ACQUIRE);
+    if ((trace != NULL) && CyberTraceIsEnabled(trace)) {
+        Cyber180CPTraceInstruction(cp, trace, oldP, instructionWord);
+    }
+
+#if CYBER_STATISTICS
+    CyberOpcodeCounterRecord(&cp->_opcodeStatistics->opcodes[instructionWord._jkiD.opcode], CyberCycleCounterRead() - startCycles);
+#endif
 }
 
 
@@ -27,6 +27,7 @@ CYBER_HEADER_BEGIN
 
 struct Cyber962;
 struct Cyber180CMPort;
+struct Cyber180CPOpcodeStatistics;
 
 
 /// A Cyber180CP implements a Cyber 180 Central Processor.
@@ -67,6 +68,35 @@ CYBER_EXPORT void Cyber180CPStop(struct Cyber180CP *cp);
 CYBER_EXPORT void Cyber180CPShutDown(struct Cyber180CP *cp);
 
 
+/// Get the number of instructions this Central Processor has executed.
+///
+/// - Note: This may be called from any thread; while the Central Processor is running, the result is only a snapshot.
+CYBER_EXPORT uint64_t Cyber180CPGetInstructionCount(struct Cyber180CP *cp);
+
+
+/// Live counters for a Central Processor.
+struct Cyber180CPStatistics {
+
+    /// The number of instructions executed in job mode.
+    uint64_t jobInstructions;
+
+    /// The number of instructions executed in monitor mode.
+    uint64_t monitorInstructions;
+};
+
+/// Get the live counters for a Central Processor.
+///
+/// - Note: This may be called from any thread; while the Central Processor is running, the result is only a snapshot.
+CYBER_EXPORT void Cyber180CPGetStatistics(struct Cyber180CP *cp, struct Cyber180CPStatistics *statistics);
+
+/// Get the execution statistics for each opcode this Central Processor has executed.
+///
+/// - Returns: `true` if opcode statistics are collected, or `false` with `statistics` left all zero if they're not.
+///
+/// - Note: This may be called from any thread; while the Central Processor is running, the result is only a snapshot.
+CYBER_EXPORT bool Cyber180CPGetOpcodeStatistics(struct Cyber180CP *cp, struct Cyber180CPOpcodeStatistics *statistics);
+
+
 /// Gets the Central Memory port that can be used by this Central Processor to access the Central Memory.
 CYBER_EXPORT struct Cyber180CMPort * _Nonnull Cyber180CPGetCentralMemoryPort(struct Cyber180CP *cp);
 
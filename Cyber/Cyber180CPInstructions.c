@@ -20,6 +20,9 @@
 #include "Cyber180CPInstructions_Internal.h"
 
 #include "Cyber180CP_Internal.h"
+#include "Cyber962_Internal.h"
+#include "CyberCycleCounter.h"
+#include "CyberTrace_Internal.h"
 
 #include <assert.h>
 #include <stdbool.h>
@@ -135,6 +138,7 @@ Cyber180CPInstruction _Nullable Cyber180CPInstructionDecode(struct Cyber180CP *p
         Cyber180CPInstruction_SUMPFV, // 0x5c
         Cyber180CPInstruction_GTHIV, // 0x5d
         Cyber180CPInstruction_SCTIV, // 0x5e
+        NULL, // 0x5f
 
         NULL, // 0x60
         NULL, // 0x61
@@ -415,6 +419,11 @@ CyberWord64 Cyber180CPInstruction_SYNC(struct Cyber180CP *processor, union Cyber
 
 CyberWord64 Cyber180CPInstruction_EXCHANGE(struct Cyber180CP *processor, union Cyber180CPInstructionWord word, CyberWord64 address)
 {
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(processor->_system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_CP_STREAM(processor->_index), CyberTimelineEventExchange, 0, address, CyberCycleCounterRead(), 0);
+    }
+
     return 0;// TODO: Implement
 }
 
@@ -1076,12 +1085,11 @@ CyberWord64 Cyber180CPInstruction_LX(struct Cyber180CP *processor, union Cyber18
     CyberWord48 Aj = Cyber180CPGetA(processor, word._jkQ.j);
     CyberWord16 Q = word._jkQ.Q;
     CyberWord64 sourcePVA = Cyber180CPInstruction_CalculateAddressUsingSignedDisplacement16(Aj, Q);
-    if ((sourcePVA % 8) != 0) {
-        // TODO: Address Specification Error (2.8.1.5)
-    }
     CyberWord64 value;
-    Cyber180CPReadBytes(processor, sourcePVA, (CyberWord8 *)&value, 8);
-    Cyber180CPSetX(processor, word._jkQ.k, CyberWord64Swap(value));
+    if (!Cyber180CPReadWord(processor, sourcePVA, &value)) {
+        return ~0x0; // leave P at this instruction
+    }
+    Cyber180CPSetX(processor, word._jkQ.k, value);
     return 4;
 }
 
@@ -1092,23 +1100,39 @@ CyberWord64 Cyber180CPInstruction_SX(struct Cyber180CP *processor, union Cyber18
     CyberWord48 Aj = Cyber180CPGetA(processor, word._jkQ.j);
     CyberWord16 Q = word._jkQ.Q;
     CyberWord64 destinationPVA = Cyber180CPInstruction_CalculateAddressUsingSignedDisplacement16(Aj, Q);
-    if ((destinationPVA % 8) != 0) {
-        // TODO: Address Specification Error (2.8.1.5)
-    }
     CyberWord64 Xk = Cyber180CPGetX(processor, word._jkQ.k);
-    CyberWord64 value = CyberWord64Swap(Xk);
-    Cyber180CPWriteBytes(processor, destinationPVA, (CyberWord8 *)&value, 8);
+    if (!Cyber180CPWriteWord(processor, destinationPVA, Xk)) {
+        return ~0x0; // leave P at this instruction
+    }
     return 4;
 }
 
 
+/// Load Ak from (Aj displaced by Q) (2.2.1.6, 84jkQ)
+///
+/// - Note: An address is 6 bytes and needn't be on a word boundary, so this uses the byte path rather than the word path.
 CyberWord64 Cyber180CPInstruction_LA(struct Cyber180CP *processor, union Cyber180CPInstructionWord word, CyberWord64 address)
 {
-    return 0;// TODO: Implement
+    int64_t Aj = processor->_regA[word._jkQ.j] & 0x0000FFFFFFFFFFFF;
+    int64_t signed_Q = Signed32FromSigned16ViaExtend(word._jkQ.Q);
+    CyberWord48 AjQ = (Aj + signed_Q) & 0x0000FFFFFFFFFFFF;
+
+    CyberWord8 bytes[6];
+    Cyber180CPReadBytes(processor, AjQ, bytes, 6);
+
+    // Don't need to swap after load because this swaps for us if necessary.
+    CyberWord48 value = (  (((CyberWord48)bytes[0]) << 40) | (((CyberWord48)bytes[1]) << 32)
+                         | (((CyberWord48)bytes[2]) << 24) | (((CyberWord48)bytes[3]) << 16)
+                         | (((CyberWord48)bytes[4]) <<  8) | (((CyberWord48)bytes[5]) <<  0));
+    Cyber180CPSetA(processor, word._jkQ.k, value);
+
+    return 4;
 }
 
 
 /// Store Ak at (Aj displaced by Q) (2.2.1.6, 85jkQ)
+///
+/// - Note: An address is 6 bytes and needn't be on a word boundary, so this uses the byte path rather than the word path.
 CyberWord64 Cyber180CPInstruction_SA(struct Cyber180CP *processor, union Cyber180CPInstructionWord word, CyberWord64 address)
 {
     int64_t Ak = processor->_regA[word._jkQ.k] & 0x0000FFFFFFFFFFFF;
@@ -1116,8 +1140,16 @@ CyberWord64 Cyber180CPInstruction_SA(struct Cyber180CP *processor, union Cyber18
     int64_t signed_Q = Signed32FromSigned16ViaExtend(word._jkQ.Q);
     CyberWord48 AjQ = (Aj + signed_Q) & 0x0000FFFFFFFFFFFF;
 
-    CyberWord8 *pAk = ((CyberWord8 *)&Ak) + 2;
-    Cyber180CPWriteBytes(processor, AjQ, pAk, 6);
+    // Don't need to swap before store as this swaps for us if necessary.
+    CyberWord8 bytes[6] = {
+        ((Ak >> 40) & 0xFF),
+        ((Ak >> 32) & 0xFF),
+        ((Ak >> 24) & 0xFF),
+        ((Ak >> 16) & 0xFF),
+        ((Ak >>  8) & 0xFF),
+        ((Ak >>  0) & 0xFF),
+    };
+    Cyber180CPWriteBytes(processor, AjQ, bytes, 6);
 
     return 4;
 }
@@ -1316,12 +1348,11 @@ CyberWord64 Cyber180CPInstruction_LXI(struct Cyber180CP *processor, union Cyber1
     CyberWord48 Aj = Cyber180CPGetA(processor, word._jkiD.j);
     CyberWord12 D = word._jkiD.D;
     CyberWord48 sourcePVA = Cyber180CPInstruction_CalculateAddressUsingIndex32WithDisplacement12Times8(Aj, XiR, D);
-    if ((sourcePVA % 8) != 0) {
-        // TODO: Address Specification Error (2.8.1.5)
-    }
     CyberWord64 value;
-    Cyber180CPReadBytes(processor, sourcePVA, (CyberWord8 *)&value, 8);
-    Cyber180CPSetX(processor, word._jkQ.k, CyberWord64Swap(value));
+    if (!Cyber180CPReadWord(processor, sourcePVA, &value)) {
+        return ~0x0; // leave P at this instruction
+    }
+    Cyber180CPSetX(processor, word._jkQ.k, value);
     return 4;
 }
 
@@ -1333,12 +1364,10 @@ CyberWord64 Cyber180CPInstruction_SXI(struct Cyber180CP *processor, union Cyber1
     CyberWord48 Aj = Cyber180CPGetA(processor, word._jkiD.j);
     CyberWord12 D = word._jkiD.D;
     CyberWord48 destinationPVA = Cyber180CPInstruction_CalculateAddressUsingIndex32WithDisplacement12Times8(Aj, XiR, D);
-    if ((destinationPVA % 8) != 0) {
-        // TODO: Address Specification Error (2.8.1.5)
-    }
     CyberWord64 Xk = Cyber180CPGetX(processor, word._jkQ.k);
-    CyberWord64 value = CyberWord64Swap(Xk);
-    Cyber180CPWriteBytes(processor, destinationPVA, (CyberWord8 *)&value, 8);
+    if (!Cyber180CPWriteWord(processor, destinationPVA, Xk)) {
+        return ~0x0; // leave P at this instruction
+    }
     return 4;
 }
 
@@ -1480,9 +1509,26 @@ CyberWord64 Cyber180CPInstruction_CALLREL(struct Cyber180CP *processor, union Cy
 }
 
 
+/// Keypoint, class `j`, code (right half of `Xk`) + `Q` (`B1jkQ`)
+///
+/// Nothing is done to the processor's state; if keypoints are being traced, a record of this one is appended to the trace.
 CyberWord64 Cyber180CPInstruction_KEYPOINT(struct Cyber180CP *processor, union Cyber180CPInstructionWord word, CyberWord64 address)
 {
-    return 0;// TODO: Implement
+    struct CyberTrace *trace = __atomic_load_n(&processor->_system->_keypointTrace, __ATOMIC_ACQUIRE);
+    if ((trace != NULL) && CyberTraceIsEnabled(trace)) {
+        CyberWord32 Xk = (CyberWord32) Cyber180CPGetX(processor, word._jkQ.k);
+        struct CyberKeypointRecord record = {
+            .ticks = CyberCycleCounterRead(),
+            .address = address,
+            .code = Xk + word._jkQ.Q,
+            .processorKind = CyberTraceProcessorKindCentral,
+            .inputOutputUnit = 0,
+            .processorIndex = processor->_index,
+            .keypointClass = word._jkQ.j,
+        };
+        (void) CyberTraceAppend(trace, CYBER_TRACE_CP_STREAM(processor->_index), &record, sizeof(record));
+    }
+    return 4;
 }
 
 
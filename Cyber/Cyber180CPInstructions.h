@@ -47,7 +47,7 @@ union Cyber180CPInstructionWord {
     CyberWord32 _raw;
 
     struct {
-#if BIG_ENDIAN
+#if CYBER_BIG_ENDIAN
         unsigned opcode : 8;
         unsigned j : 4;
         unsigned k : 4;
@@ -63,7 +63,7 @@ union Cyber180CPInstructionWord {
     } CYBER_PACKED _jkiD;
 
     struct {
-#if BIG_ENDIAN
+#if CYBER_BIG_ENDIAN
         unsigned opcode : 4;
         unsigned S : 4;
         unsigned j : 4;
@@ -81,7 +81,7 @@ union Cyber180CPInstructionWord {
     } CYBER_PACKED _SjkiD;
 
     struct {
-#if BIG_ENDIAN
+#if CYBER_BIG_ENDIAN
         unsigned opcode : 8;
         unsigned j : 4;
         unsigned k : 4;
@@ -95,7 +95,7 @@ union Cyber180CPInstructionWord {
     } CYBER_PACKED _jk;
 
     struct {
-#if BIG_ENDIAN
+#if CYBER_BIG_ENDIAN
         unsigned opcode : 8;
         unsigned j : 4;
         unsigned k : 4;
@@ -43,6 +43,28 @@ enum Cyber180CPMode {
 };
 
 
+/// The monitor conditions a Central Processor can detect, as masks for the Monitor Condition Register (2.8.1).
+///
+/// - Note: The Cyber uses IBM-style bit numbering, so MCR bit 48 is the leftmost bit of the 16-bit register.
+enum Cyber180CPMonitorCondition {
+
+    /// Detected Uncorrectable Error (MCR48)
+    Cyber180CPMonitorConditionDetectedUncorrectableError = 1 << (63 - 48),
+
+    /// Instruction Specification Error (MCR51)
+    Cyber180CPMonitorConditionInstructionSpecificationError = 1 << (63 - 51),
+
+    /// Address Specification Error (MCR52), such as a word access to an address that isn't a multiple of 8 (2.8.1.5)
+    Cyber180CPMonitorConditionAddressSpecificationError = 1 << (63 - 52),
+
+    /// Access Violation (MCR54)
+    Cyber180CPMonitorConditionAccessViolation = 1 << (63 - 54),
+
+    /// Environment Specification Error (MCR55)
+    Cyber180CPMonitorConditionEnvironmentSpecificationError = 1 << (63 - 55),
+};
+
+
 struct Cyber180CP {
 
     /// The system that this is a part of.
@@ -54,16 +76,24 @@ struct Cyber180CP {
     /// The port that this Central Processor can use to access Central Memory.
     struct Cyber180CMPort *_centralMemoryPort;
 
-    /// The thread that represents this Central Processor.
-    struct CyberThread *_thread;
+    /// The thread that represents this Central Processor, or `NULL` when the system runs in lockstep.
+    struct CyberThread * _Nullable _thread;
 
-    /// The current operating mode of this Central Processor.
-    enum Cyber180CPMode _mode;
+    /// Whether this Central Processor is running, when the system runs in lockstep.
+    bool _running;
+
+    /// Whether this Central Processor's thread is registered with the system's safepoints.
+    bool _safepointRegistered;
 
     // Registers
+    //
+    // The registers are written on every instruction by the thread running this Central Processor, so they start on a cache line of their own, away from the configuration above that other threads read.
 
     /// Program Address Register (program counter), 64 bits
-    CyberWord64 _regP;
+    CYBER_PROCESSOR_ALIGNED CyberWord64 _regP;
+
+    /// The current operating mode of this Central Processor.
+    enum Cyber180CPMode _mode;
 
     /// Address Registers, 48 bits
     CyberWord48 _regA[16];
@@ -71,14 +101,48 @@ struct Cyber180CP {
     /// Operand Registers, 64 bits
     CyberWord64 _regX[16];
 
+    /// Monitor Condition Register, 16 bits
+    CyberWord16 _regMCR;
+
+    /// User Condition Register, 16 bits
+    CyberWord16 _regUCR;
+
     // FIXME: Flesh out register set.
 
     // Caching
 
     // FIXME: Flesh out cache.
+
+    // Statistics
+
+    /// The number of instructions this Central Processor has executed in each ``Cyber180CPMode``; written only by the thread running it, but may be read from any thread.
+    uint64_t _instructionCounts[2];
+
+#if CYBER_STATISTICS
+    /// Execution statistics for each opcode; written only by the thread running this Central Processor, but may be read from any thread.
+    struct Cyber180CPOpcodeStatistics *_opcodeStatistics;
+#endif
+
+    // Tracing
+
+    /// Whether the instruction trace has a record of this Central Processor's registers to encode differences from, which it doesn't until a keyframe is recorded or after a record is dropped.
+    bool _traceSynchronized;
+
+    /// The trace generation that the recorded registers belong to.
+    uint32_t _traceGeneration;
+
+    /// The Address Registers as of the last instruction trace record.
+    CyberWord48 _traceA[16];
+
+    /// The Operand Registers as of the last instruction trace record.
+    CyberWord64 _traceX[16];
 };
 
 
+/// Execute a single instruction.
+CYBER_EXPORT void Cyber180CPSingleStep(struct Cyber180CP *cp);
+
+
 /// Get the value of the Ai register.
 CYBER_EXPORT CyberWord48 Cyber180CPGetA(struct Cyber180CP *cp, int i);
 
@@ -95,6 +159,12 @@ CYBER_EXPORT CyberWord64 Cyber180CPGetXOr0(struct Cyber180CP *cp, int i);
 CYBER_EXPORT void Cyber180CPSetX(struct Cyber180CP *cp, int i, CyberWord64 value);
 
 
+/// Set a monitor condition in the Monitor Condition Register, and stop the processor.
+///
+/// Monitor condition interrupts aren't delivered yet, so stopping is how the processor halts at the fault; an instruction that detects a condition should return all 1s, so `P` is left at that instruction.
+CYBER_EXPORT void Cyber180CPSetMonitorCondition(struct Cyber180CP *cp, enum Cyber180CPMonitorCondition condition);
+
+
 /// Translate a virtual address to a physical address.
 CYBER_EXPORT CyberWord64 Cyber180CPTranslateAddress(struct Cyber180CP *cp, CyberWord64 virtualAddress);
 
@@ -105,6 +175,16 @@ CYBER_EXPORT void Cyber180CPWriteBytes(struct Cyber180CP *cp, CyberWord64 virtua
 /// Read bytes from a virtual address.
 CYBER_EXPORT void Cyber180CPReadBytes(struct Cyber180CP *cp, CyberWord64 virtualAddress, CyberWord8 *buf, CyberWord32 count);
 
+/// Read a word from a virtual address, swapping it to host byte order.
+///
+/// - Returns: `true` if the word was read, or `false` if the address is not on a word boundary, in which case an Address Specification Error has been set.
+CYBER_EXPORT bool Cyber180CPReadWord(struct Cyber180CP *cp, CyberWord64 virtualAddress, CyberWord64 *word);
+
+/// Write a word to a virtual address, swapping it to Cyber byte order.
+///
+/// - Returns: `true` if the word was written, or `false` if the address is not on a word boundary, in which case an Address Specification Error has been set.
+CYBER_EXPORT bool Cyber180CPWriteWord(struct Cyber180CP *cp, CyberWord64 virtualAddress, CyberWord64 word);
+
 
 CYBER_HEADER_END
 
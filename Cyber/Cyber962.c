@@ -17,76 +17,88 @@
 //  limitations under the License.
 //
 
-#include <Cyber/Cyber962.h>
+#include "Cyber962_Internal.h"
 
 #include <Cyber/Cyber180CM.h>
-#include <Cyber/Cyber180CP.h>
+#include "Cyber180CM_Internal.h"
+#include "Cyber180CP_Internal.h"
 #include "Cyber962IOU_Internal.h"
+#include "Cyber962PP_Internal.h"
+#include "CyberCycleCounter.h"
+#include "CyberOpcodeStatistics_Internal.h"
+#include "CyberProfile_Internal.h"
+#include "CyberThread.h"
+#include "CyberTrace_Internal.h"
 
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 
 CYBER_SOURCE_BEGIN
 
 
-/// A Cyber 962 system.
-///
-/// A Cyber 962 system always consists of:
-/// - One or two Central Processor (CP)
-/// - One Central Memory (CM) containing:
-///   - 32MB (4MW) RAM
-/// - One I/O Unit (IOU) containing:
-///   - 10 CIO (Concurrent I/O) Peripheral Processors
-///   - 8 DMA channels
-///
-/// One or two adaditional IOU can be added with:
-/// - 10-20 CIO PP
-/// - 10-20 DMA channels
-///
-/// The CM can be expanded to the following sizes:
-/// - 64MB (8MW)
-/// - 128MB (16MW)
-/// - 192MB (24MW)
-/// - 256MB (32MW)
-struct Cyber962 {
-    /// The Central Memory in this system.
-    struct Cyber180CM *_centralMemory;
-
-    /// The one or two Central Processors in this system.
-    struct Cyber180CP * _Nullable _centralProcessors[2];
+static void Cyber962PlanPlacement(struct Cyber962 *system);
 
-    /// The I/O Units in this system.
-    struct Cyber962IOU * _Nullable _inputOutputUnits[3];
 
-    /// The human-readable name or identifier of this system.
-    char *_identifier;
-};
+struct Cyber962 * _Nullable Cyber962Create(const char *identifier, size_t memorySize, int centralProcessors, int inputOutputUnits)
+{
+    struct Cyber962Configuration configuration = {
+        .memorySize = memorySize,
+        .centralProcessors = centralProcessors,
+        .inputOutputUnits = inputOutputUnits,
+        .runMode = Cyber962RunModeThreaded,
+        .centralProcessorInstructionsPerRound = 1,
+        .placementPolicy = Cyber962PlacementPolicyNone,
+    };
+
+    return Cyber962CreateWithConfiguration(identifier, &configuration);
+}
 
 
-struct Cyber962 * _Nullable Cyber962Create(const char *identifier, size_t memorySize, int centralProcessors, int inputOutputUnits)
+struct Cyber962 * _Nullable Cyber962CreateWithConfiguration(const char *identifier, const struct Cyber962Configuration *configuration)
 {
     assert(identifier != NULL);
-    assert(memorySize <= (256 * 1024 * 1024));
-    assert((centralProcessors > 0) && (centralProcessors <= 2));
-    assert((inputOutputUnits > 0) && (inputOutputUnits <= 3));
+    assert(configuration != NULL);
+    assert((configuration->centralProcessors > 0) && (configuration->centralProcessors <= 2));
+    assert((configuration->inputOutputUnits > 0) && (configuration->inputOutputUnits <= 3));
+    assert(configuration->centralProcessorInstructionsPerRound > 0);
+
+    const size_t memorySize = configuration->memorySize;
+    const int centralProcessors = configuration->centralProcessors;
+    const int inputOutputUnits = configuration->inputOutputUnits;
 
     // Create the system components and connect them together.
 
-    struct Cyber962 *system = calloc(1, sizeof(struct Cyber962));
+    struct Cyber962 *system = NULL;
+    int alloc_err = posix_memalign((void **)&system, CYBER_PROCESSOR_ALIGNMENT, sizeof(struct Cyber962));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(system, 0, sizeof(struct Cyber962));
 
     system->_identifier = strdup(identifier);
+    system->_configuration = *configuration;
+
+    Cyber962PlanPlacement(system);
 
     const int portCount = centralProcessors + inputOutputUnits; // total number of Central Memory ports
     const int cpCMPortsBase = 0; // base index of Central Memory ports for CP instances
     const int iouCMPortsBase = centralProcessors; // base index of Central Memory ports for IOU instances
 
-    struct Cyber180CM *centralMemory = Cyber180CMCreate(system, memorySize, portCount);
+    // Only commit host memory for the pages actually touched by the guest in configurations larger than a real Cyber 962.
+    enum Cyber180CMStorage storage = (memorySize > (256 * 1024 * 1024)) ? Cyber180CMStorageSparse : Cyber180CMStorageDense;
+    struct Cyber180CM *centralMemory = Cyber180CMCreateWithStorage(system, memorySize, portCount, storage);
     system->_centralMemory = centralMemory;
 
     for (int cp = 0; cp < centralProcessors; cp++) {
         struct Cyber180CP *centralProcessor = Cyber180CPCreate(system, cp);
+        if (centralProcessor == NULL) {
+            Cyber962Dispose(system);
+            return NULL;
+        }
         struct Cyber180CMPort *centralMemoryPort = Cyber180CMGetPortAtIndex(system->_centralMemory, cpCMPortsBase + cp);
         Cyber180CPSetCentralMemoryPort(centralProcessor, centralMemoryPort);
         system->_centralProcessors[cp] = centralProcessor;
@@ -105,12 +117,86 @@ struct Cyber962 * _Nullable Cyber962Create(const char *identifier, size_t memory
 }
 
 
-void Cyber962Dispose(struct Cyber962 * _Nullable system)
+/// Get the monotonic clock in nanoseconds.
+static uint64_t Cyber962GetNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
+/// Wait until `deadline`, on the monotonic clock, for a terminated processor thread to exit, if the processor has one.
+static bool Cyber962JoinProcessorThread(struct CyberThread * _Nullable thread, uint64_t deadline)
 {
-    if (system == NULL) return;
+    if (thread == NULL) return true;
 
-    Cyber180CMDispose(system->_centralMemory);
+    const uint64_t now = Cyber962GetNanoseconds();
+    return CyberThreadJoin(thread, (deadline > now) ? (deadline - now) : 0);
+}
+
+
+bool Cyber962Dispose(struct Cyber962 * _Nullable system)
+{
+    if (system == NULL) return true;
+
+    // The profiler reads the processors, so it has to stop before they're disposed of.
+    if (system->_profiler != NULL) {
+        CyberProfileDispose(CyberProfilerStop(system->_profiler));
+    }
+
+    // Ask every processor thread to terminate first, so they all wind down in parallel rather than one at a time as they're joined.
+    for (int cp = 0; cp < 2; cp++) {
+        struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+        if (centralProcessor != NULL) {
+            Cyber180CPShutDown(centralProcessor);
+        }
+    }
+
+    for (int iou = 0; iou < 3; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+        if (inputOutputUnit == NULL) continue;
+
+        for (int pp = 0; pp < 20; pp++) {
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+            if (peripheralProcessor != NULL) {
+                Cyber962PPShutdown(peripheralProcessor);
+            }
+        }
+    }
+
+    // Threads parked at a safepoint only notice they've been terminated once they're released.
+    if (Cyber962IsPaused(system)) {
+        Cyber962ResumeAll(system);
+    }
+
+    // Wait for every processor thread against one deadline, so even a system with many processors shuts down within a bound.
+    const uint64_t deadline = Cyber962GetNanoseconds() + CYBER_THREAD_JOIN_TIMEOUT;
+    bool joined = true;
+    for (int cp = 0; cp < 2; cp++) {
+        struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+        if (centralProcessor != NULL) {
+            joined = Cyber962JoinProcessorThread(centralProcessor->_thread, deadline) && joined;
+        }
+    }
+    for (int iou = 0; iou < 3; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+        if (inputOutputUnit == NULL) continue;
+
+        for (int pp = 0; pp < 20; pp++) {
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+            if (peripheralProcessor != NULL) {
+                joined = Cyber962JoinProcessorThread(peripheralProcessor->_thread, deadline) && joined;
+            }
+        }
+    }
 
+    // A thread that's still running may be using anything in the system, so leak all of it rather than free it out from under the thread.
+    if (!joined) {
+        return false;
+    }
+
+    // Every processor thread has been joined, so nothing uses Central Memory or the system by the time those are freed.
     Cyber180CPDispose(system->_centralProcessors[0]);
     Cyber180CPDispose(system->_centralProcessors[1]);
 
@@ -118,7 +204,16 @@ void Cyber962Dispose(struct Cyber962 * _Nullable system)
     Cyber962IOUDispose(system->_inputOutputUnits[1]);
     Cyber962IOUDispose(system->_inputOutputUnits[2]);
 
+    Cyber180CMDispose(system->_centralMemory);
+
+    CyberTraceDispose(system->_keypointTrace);
+    CyberTraceDispose(system->_instructionTrace);
+    CyberTraceDispose(system->_timelineTrace);
+
     free(system->_identifier);
+    free(system);
+
+    return true;
 }
 
 
@@ -130,6 +225,240 @@ char *Cyber962GetIdentifier(struct Cyber962 *system)
 }
 
 
+enum Cyber962RunMode Cyber962GetRunMode(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    return system->_configuration.runMode;
+}
+
+
+void Cyber962RunLockstepRounds(struct Cyber962 *system, uint64_t rounds)
+{
+    assert(system != NULL);
+    assert(system->_configuration.runMode == Cyber962RunModeLockstep);
+    assert(!Cyber962IsPaused(system));
+
+    const int cpInstructionsPerRound = system->_configuration.centralProcessorInstructionsPerRound;
+
+    // Each processor runs on this thread in turn, so timeline records and access counts from shared code like Central Memory ports go to the one being stepped.
+    const int callerStream = CyberTraceCurrentStream;
+    struct Cyber180CMPortCounters * const callerCounters = Cyber180CMPortCurrentCounters;
+
+    for (uint64_t round = 0; round < rounds; round++) {
+        for (int cp = 0; cp < 2; cp++) {
+            struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+            if ((centralProcessor == NULL) || !centralProcessor->_running) continue;
+
+            CyberTraceCurrentStream = CYBER_TRACE_CP_STREAM(cp);
+            Cyber180CMPortCurrentCounters = NULL;
+            // A CP stops itself on a monitor condition, so check before each instruction.
+            for (int instruction = 0; (instruction < cpInstructionsPerRound) && centralProcessor->_running; instruction++) {
+                Cyber180CPSingleStep(centralProcessor);
+            }
+        }
+
+        for (int iou = 0; iou < 3; iou++) {
+            struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+            if (inputOutputUnit == NULL) continue;
+
+            for (int pp = 0; pp < 20; pp++) {
+                // PPs that haven't been created yet can't be running.
+                struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+                if ((peripheralProcessor == NULL) || !peripheralProcessor->_running) continue;
+
+                CyberTraceCurrentStream = CYBER_TRACE_PP_STREAM(iou, pp);
+                Cyber180CMPortCurrentCounters = &peripheralProcessor->_centralMemoryCounters;
+                Cyber962PPSingleStep(peripheralProcessor);
+            }
+        }
+    }
+
+    CyberTraceCurrentStream = callerStream;
+    Cyber180CMPortCurrentCounters = callerCounters;
+}
+
+
+void Cyber962PauseAll(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    // Request the pause by making the epoch odd. This is sequentially consistent so that either a thread registering in Cyber962SafepointEnter is counted below, or it sees the request when it polls before its first instruction.
+    uint32_t epoch = atomic_fetch_add_explicit(&system->_safepointEpoch, 1, memory_order_seq_cst);
+    assert((epoch & 1) == 0); // pauses don't nest
+    (void) epoch;
+
+    // Wait for every running thread to acknowledge the request by parking. Threads that stop or terminate in the meantime no longer need to be waited for.
+    for (;;) {
+        uint32_t changes = atomic_load_explicit(&system->_safepointChanges, memory_order_seq_cst);
+        uint32_t parked = atomic_load_explicit(&system->_safepointParkedThreads, memory_order_seq_cst);
+        uint32_t running = atomic_load_explicit(&system->_safepointRunningThreads, memory_order_seq_cst);
+        if (parked >= running) break;
+
+        CyberFutexWait(&system->_safepointChanges, changes);
+    }
+}
+
+
+void Cyber962ResumeAll(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    uint32_t epoch = atomic_fetch_add_explicit(&system->_safepointEpoch, 1, memory_order_seq_cst);
+    assert((epoch & 1) == 1); // must be paused
+    (void) epoch;
+
+    CyberFutexWakeAll(&system->_safepointEpoch);
+}
+
+
+bool Cyber962IsPaused(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    return (atomic_load_explicit(&system->_safepointEpoch, memory_order_acquire) & 1) != 0;
+}
+
+
+/// Bump the safepoint change counter and wake any thread waiting in Cyber962PauseAll.
+static void Cyber962SafepointNoteChange(struct Cyber962 *system)
+{
+    atomic_fetch_add_explicit(&system->_safepointChanges, 1, memory_order_seq_cst);
+    CyberFutexWakeAll(&system->_safepointChanges);
+}
+
+
+/// Wait, counted as parked, for as long as the system is paused.
+static void Cyber962SafepointWait(struct Cyber962 *system)
+{
+    // Recheck after every wake, since a new pause may have been requested between a resume and this thread getting to run again.
+    uint32_t epoch;
+    while ((epoch = atomic_load_explicit(&system->_safepointEpoch, memory_order_seq_cst)) & 1) {
+        atomic_fetch_add_explicit(&system->_safepointParkedThreads, 1, memory_order_seq_cst);
+        Cyber962SafepointNoteChange(system);
+
+        while (atomic_load_explicit(&system->_safepointEpoch, memory_order_seq_cst) == epoch) {
+            CyberFutexWait(&system->_safepointEpoch, epoch);
+        }
+
+        atomic_fetch_sub_explicit(&system->_safepointParkedThreads, 1, memory_order_seq_cst);
+    }
+}
+
+
+void Cyber962SafepointEnter(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    atomic_fetch_add_explicit(&system->_safepointRunningThreads, 1, memory_order_seq_cst);
+    Cyber962SafepointNoteChange(system);
+
+    // Don't let a thread starting during a pause record anything until it's over, since whoever paused the system may be recording to this processor's streams, for example the state its timeline starts in.
+    Cyber962SafepointWait(system);
+}
+
+
+void Cyber962SafepointLeave(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    uint32_t running = atomic_fetch_sub_explicit(&system->_safepointRunningThreads, 1, memory_order_seq_cst);
+    assert(running > 0);
+    (void) running;
+    Cyber962SafepointNoteChange(system);
+}
+
+
+void Cyber962SafepointPark(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    // Show the time parked on the timeline of the processor this thread runs.
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CyberTraceCurrentStream, CyberTimelineEventParked, 0, 0, CyberCycleCounterRead(), 0);
+    }
+
+    Cyber962SafepointWait(system);
+
+    // Tracing may have started or stopped during the pause.
+    trace = Cyber962GetTimelineTrace(system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CyberTraceCurrentStream, CyberTimelineEventRunning, 0, 0, CyberCycleCounterRead(), 0);
+    }
+}
+
+
+/// Work out which host CPUs each processor's threads should run on, according to the placement policy.
+static void Cyber962PlanPlacement(struct Cyber962 *system)
+{
+    if (system->_configuration.placementPolicy == Cyber962PlacementPolicyNone) return;
+
+    assert(system->_configuration.placementPolicy == Cyber962PlacementPolicyIsolated);
+
+    const int hostCPUs = CyberThreadGetHostCPUCount();
+    uint64_t used = 0;
+
+    // Pin each CP to one hardware thread of its own core, and keep anything else off that core entirely.
+    for (int cp = 0; cp < system->_configuration.centralProcessors; cp++) {
+        for (int cpu = 0; cpu < hostCPUs; cpu++) {
+            if ((used & (1ULL << cpu)) == 0) {
+                system->_centralProcessorCPUMasks[cp] = 1ULL << cpu;
+                used |= CyberThreadGetSiblingCPUMask(cpu);
+                break;
+            }
+        }
+    }
+
+    // Collect the remaining cores, each as the mask of its hardware threads.
+    uint64_t cores[64];
+    int coreCount = 0;
+    for (int cpu = 0; cpu < hostCPUs; cpu++) {
+        if ((used & (1ULL << cpu)) == 0) {
+            uint64_t siblings = CyberThreadGetSiblingCPUMask(cpu) & ~used;
+            cores[coreCount++] = siblings;
+            used |= siblings;
+        }
+    }
+
+    // Group each PP barrel on the hardware threads of one core, sharing cores round-robin if there are more barrels than cores. If there are no cores left, leave the PPs unpinned.
+    if (coreCount > 0) {
+        int barrelIndex = 0;
+        for (int iou = 0; iou < system->_configuration.inputOutputUnits; iou++) {
+            for (int barrel = 0; barrel < 5; barrel++) {
+                system->_barrelCPUMasks[iou][barrel] = cores[barrelIndex % coreCount];
+                barrelIndex += 1;
+            }
+        }
+    }
+}
+
+
+void Cyber962GetCentralProcessorThreadAttributes(struct Cyber962 *system, int index, struct CyberThreadAttributes *attributes)
+{
+    assert(system != NULL);
+    assert((index >= 0) && (index <= 1));
+    assert(attributes != NULL);
+
+    *attributes = (struct CyberThreadAttributes){
+        .cpuMask = system->_centralProcessorCPUMasks[index],
+    };
+}
+
+
+void Cyber962GetPeripheralProcessorThreadAttributes(struct Cyber962 *system, int inputOutputUnitIndex, int barrel, struct CyberThreadAttributes *attributes)
+{
+    assert(system != NULL);
+    assert((inputOutputUnitIndex >= 0) && (inputOutputUnitIndex <= 2));
+    assert((barrel >= 0) && (barrel < 5));
+    assert(attributes != NULL);
+
+    *attributes = (struct CyberThreadAttributes){
+        .cpuMask = system->_barrelCPUMasks[inputOutputUnitIndex][barrel],
+    };
+}
+
+
 struct Cyber180CM *Cyber962GetCentralMemory(struct Cyber962 *system)
 {
     assert(system != NULL);
@@ -156,4 +485,276 @@ struct Cyber962IOU * _Nullable Cyber962GetInputOutputUnit(struct Cyber962 *syste
 }
 
 
+void Cyber962GetStatistics(struct Cyber962 *system, struct Cyber962Statistics *statistics)
+{
+    assert(system != NULL);
+    assert(statistics != NULL);
+
+    memset(statistics, 0, sizeof(struct Cyber962Statistics));
+
+    statistics->nanoseconds = Cyber962GetNanoseconds();
+
+    statistics->centralProcessorCount = system->_configuration.centralProcessors;
+    for (int cp = 0; cp < statistics->centralProcessorCount; cp++) {
+        Cyber180CPGetStatistics(system->_centralProcessors[cp], &statistics->centralProcessors[cp]);
+    }
+
+    statistics->inputOutputUnitCount = system->_configuration.inputOutputUnits;
+    for (int iou = 0; iou < statistics->inputOutputUnitCount; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+
+        for (int index = 0; index < 20; index++) {
+            // Only look at PPs and channels that have been created, rather than creating them.
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[index], __ATOMIC_ACQUIRE);
+            if (peripheralProcessor != NULL) {
+                statistics->peripheralProcessorInstructions[iou][index] = Cyber962PPGetInstructionCount(peripheralProcessor);
+            }
+
+            struct Cyber962IOChannel *inputOutputChannel = __atomic_load_n(&inputOutputUnit->_inputOutputChannels[index], __ATOMIC_ACQUIRE);
+            if (inputOutputChannel != NULL) {
+                Cyber962IOChannelGetStatistics(inputOutputChannel, &statistics->inputOutputChannels[iou][index]);
+            }
+        }
+    }
+
+    struct Cyber180CM *centralMemory = system->_centralMemory;
+    statistics->centralMemoryPortCount = centralMemory->_portCount;
+    for (int port = 0; port < statistics->centralMemoryPortCount; port++) {
+        Cyber180CMPortGetStatistics(centralMemory->_ports[port], &statistics->centralMemoryPorts[port]);
+    }
+}
+
+
+bool Cyber962GetCentralProcessorOpcodeStatistics(struct Cyber962 *system, struct Cyber180CPOpcodeStatistics *statistics)
+{
+    assert(system != NULL);
+    assert(statistics != NULL);
+
+    memset(statistics, 0, sizeof(struct Cyber180CPOpcodeStatistics));
+
+#if CYBER_STATISTICS
+    for (int cp = 0; cp < 2; cp++) {
+        struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+        if (centralProcessor == NULL) continue;
+
+        CyberOpcodeCounterAccumulate(statistics->opcodes, centralProcessor->_opcodeStatistics->opcodes, CYBER180CP_OPCODE_COUNT);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+bool Cyber962GetPeripheralProcessorOpcodeStatistics(struct Cyber962 *system, struct Cyber962PPOpcodeStatistics *statistics)
+{
+    assert(system != NULL);
+    assert(statistics != NULL);
+
+    memset(statistics, 0, sizeof(struct Cyber962PPOpcodeStatistics));
+
+#if CYBER_STATISTICS
+    for (int iou = 0; iou < 3; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+        if (inputOutputUnit == NULL) continue;
+
+        for (int pp = 0; pp < 20; pp++) {
+            // PPs that haven't been created yet haven't executed anything.
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+            if (peripheralProcessor == NULL) continue;
+
+            CyberOpcodeCounterAccumulate(statistics->opcodes, peripheralProcessor->_opcodeStatistics->opcodes, CYBER962PP_OPCODE_COUNT);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/// The size of each processor's keypoint ring, enough for a few thousand records between drains.
+#define CYBER962_KEYPOINT_RING_BYTES (64 * 1024)
+
+/// The size of each Central Processor's instruction ring, enough for several milliseconds of instructions between drains at a few bytes each.
+#define CYBER962_INSTRUCTION_RING_BYTES (4 * 1024 * 1024)
+
+/// The size of each processor's timeline ring, enough for a few thousand events between drains.
+#define CYBER962_TIMELINE_RING_BYTES (256 * 1024)
+
+
+/// Start one of a system's traces, creating it first if it's never been started.
+static bool Cyber962StartTrace(struct CyberTrace * _Nullable * _Nonnull tracep, enum CyberTraceKind kind, int streamCount, size_t ringBytes, const char *path)
+{
+    struct CyberTrace *trace = *tracep;
+    if (trace == NULL) {
+        trace = CyberTraceCreate(kind, streamCount, ringBytes);
+        if (trace == NULL) {
+            return false;
+        }
+        __atomic_store_n(tracep, trace, __ATOMIC_RELEASE);
+    }
+
+    return CyberTraceStart(trace, path);
+}
+
+/// Stop one of a system's traces, if it's started.
+static bool Cyber962StopTrace(struct CyberTrace * _Nullable trace, uint64_t * _Nullable dropped)
+{
+    if ((trace == NULL) || !CyberTraceIsEnabled(trace)) {
+        if (dropped != NULL) {
+            *dropped = 0;
+        }
+        return true;
+    }
+
+    return CyberTraceStop(trace, dropped);
+}
+
+
+bool Cyber962StartKeypointTrace(struct Cyber962 *system, const char *path)
+{
+    assert(system != NULL);
+    assert(path != NULL);
+
+    return Cyber962StartTrace(&system->_keypointTrace, CyberTraceKindKeypoint, CYBER_TRACE_STREAM_COUNT, CYBER962_KEYPOINT_RING_BYTES, path);
+}
+
+bool Cyber962StopKeypointTrace(struct Cyber962 *system, uint64_t * _Nullable dropped)
+{
+    assert(system != NULL);
+
+    return Cyber962StopTrace(system->_keypointTrace, dropped);
+}
+
+
+bool Cyber962StartInstructionTrace(struct Cyber962 *system, const char *path)
+{
+    assert(system != NULL);
+    assert(path != NULL);
+
+    // Only the Central Processors record instructions, so only their streams are needed.
+    return Cyber962StartTrace(&system->_instructionTrace, CyberTraceKindInstruction, 2, CYBER962_INSTRUCTION_RING_BYTES, path);
+}
+
+bool Cyber962StopInstructionTrace(struct Cyber962 *system, uint64_t * _Nullable dropped)
+{
+    assert(system != NULL);
+
+    return Cyber962StopTrace(system->_instructionTrace, dropped);
+}
+
+
+/// Get the timeline state of a processor whose thread, if it has one, isn't executing instructions.
+static enum CyberTimelineEvent Cyber962GetTimelineState(struct CyberThread * _Nullable thread, bool safepointRegistered, bool running)
+{
+    if (thread != NULL) {
+        // A thread that's registered is running its main loop, so it's parked.
+        return safepointRegistered ? CyberTimelineEventParked : CyberTimelineEventStopped;
+    } else {
+        return running ? CyberTimelineEventRunning : CyberTimelineEventStopped;
+    }
+}
+
+/// Record every processor's state to the start of its timeline, or the end of every processor's timeline.
+///
+/// - Warning: No processor may be executing instructions, since this appends to their streams from the calling thread. Processor threads that start while the system is paused wait in ``Cyber962SafepointEnter`` until it's resumed, so they don't record to their streams meanwhile.
+static void Cyber962RecordTimelineStates(struct Cyber962 *system, struct CyberTrace *trace, bool end)
+{
+    const uint64_t ticks = CyberCycleCounterRead();
+
+    for (int cp = 0; cp < 2; cp++) {
+        struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+        if (centralProcessor == NULL) continue;
+
+        enum CyberTimelineEvent event = end ? CyberTimelineEventEnd : Cyber962GetTimelineState(centralProcessor->_thread, centralProcessor->_safepointRegistered, centralProcessor->_running);
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_CP_STREAM(cp), event, 0, 0, ticks, 0);
+    }
+
+    for (int iou = 0; iou < 3; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+        if (inputOutputUnit == NULL) continue;
+
+        for (int pp = 0; pp < 20; pp++) {
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+            if (peripheralProcessor == NULL) continue;
+
+            enum CyberTimelineEvent event = end ? CyberTimelineEventEnd : Cyber962GetTimelineState(peripheralProcessor->_thread, peripheralProcessor->_safepointRegistered, peripheralProcessor->_running);
+            CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_PP_STREAM(iou, pp), event, 0, 0, ticks, 0);
+        }
+    }
+}
+
+
+bool Cyber962StartTimelineTrace(struct Cyber962 *system, const char *path)
+{
+    assert(system != NULL);
+    assert(path != NULL);
+
+    // Pause the processor threads, if they aren't already, so this thread can record where each processor's timeline starts.
+    const bool pause = (system->_configuration.runMode == Cyber962RunModeThreaded) && !Cyber962IsPaused(system);
+    if (pause) {
+        Cyber962PauseAll(system);
+    }
+
+    bool started = Cyber962StartTrace(&system->_timelineTrace, CyberTraceKindTimeline, CYBER_TRACE_STREAM_COUNT, CYBER962_TIMELINE_RING_BYTES, path);
+    if (started) {
+        Cyber962RecordTimelineStates(system, system->_timelineTrace, false);
+    }
+
+    if (pause) {
+        Cyber962ResumeAll(system);
+    }
+
+    return started;
+}
+
+bool Cyber962StopTimelineTrace(struct Cyber962 *system, uint64_t * _Nullable dropped)
+{
+    assert(system != NULL);
+
+    struct CyberTrace *trace = system->_timelineTrace;
+    if ((trace == NULL) || !CyberTraceIsEnabled(trace)) {
+        return Cyber962StopTrace(trace, dropped);
+    }
+
+    const bool pause = (system->_configuration.runMode == Cyber962RunModeThreaded) && !Cyber962IsPaused(system);
+    if (pause) {
+        Cyber962PauseAll(system);
+    }
+
+    Cyber962RecordTimelineStates(system, trace, true);
+    bool stopped = CyberTraceStop(trace, dropped);
+
+    if (pause) {
+        Cyber962ResumeAll(system);
+    }
+
+    return stopped;
+}
+
+
+bool Cyber962StartProfiler(struct Cyber962 *system, double samplesPerSecond)
+{
+    assert(system != NULL);
+    assert(system->_profiler == NULL); // profiling must not already be started
+    assert(samplesPerSecond > 0);
+
+    system->_profiler = CyberProfilerStart(system, samplesPerSecond);
+    return (system->_profiler != NULL);
+}
+
+struct CyberProfile * _Nullable Cyber962StopProfiler(struct Cyber962 *system)
+{
+    assert(system != NULL);
+
+    if (system->_profiler == NULL) {
+        return NULL;
+    }
+
+    struct CyberProfile *profile = CyberProfilerStop(system->_profiler);
+    system->_profiler = NULL;
+    return profile;
+}
+
 CYBER_SOURCE_END
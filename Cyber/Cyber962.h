@@ -19,6 +19,10 @@
 
 #include <Cyber/CyberTypes.h>
 
+#include <Cyber/Cyber180CMPort.h>
+#include <Cyber/Cyber180CP.h>
+#include <Cyber/Cyber962IOChannel.h>
+
 #ifndef __CYBER_CYBER962_H__
 #define __CYBER_CYBER962_H__
 
@@ -27,8 +31,58 @@ CYBER_HEADER_BEGIN
 
 struct Cyber180CP;
 struct Cyber180CM;
+struct Cyber180CPOpcodeStatistics;
 struct Cyber962;
 struct Cyber962IOU;
+struct Cyber962PPOpcodeStatistics;
+struct CyberProfile;
+
+
+/// How a Cyber 962 system runs its processors.
+enum Cyber962RunMode {
+
+    /// Each Central Processor and Peripheral Processor runs freely on its own host thread.
+    Cyber962RunModeThreaded = 0,
+
+    /// All Central Processors and Peripheral Processors are stepped cooperatively on the caller's thread in a fixed interleaving, via ``Cyber962RunLockstepRounds``.
+    ///
+    /// This is deterministic, so runs are reproducible, and it avoids dozens of host threads contending for Central Memory on small hosts.
+    Cyber962RunModeLockstep = 1,
+};
+
+
+/// How the threads of a Cyber 962 system are placed on host CPUs, when it runs in threaded mode.
+enum Cyber962PlacementPolicy {
+
+    /// Let the host schedule threads wherever it likes.
+    Cyber962PlacementPolicyNone = 0,
+
+    /// Pin each Central Processor to a core of its own, so it doesn't migrate and lose its caches, and group each Peripheral Processor barrel on the sibling hardware threads of one of the remaining cores.
+    Cyber962PlacementPolicyIsolated = 1,
+};
+
+
+/// The configuration of a Cyber 962 system.
+struct Cyber962Configuration {
+
+    /// Size of the Central Memory in bytes; sizes above 256MB use sparse storage.
+    size_t memorySize;
+
+    /// Number of Central Processors in the system, 1 or 2.
+    int centralProcessors;
+
+    /// Number of Input/Output Units in the system, 1 to 3.
+    int inputOutputUnits;
+
+    /// How the system runs its processors.
+    enum Cyber962RunMode runMode;
+
+    /// In lockstep mode, the number of instructions each Central Processor executes per round; each Peripheral Processor executes one instruction per round.
+    int centralProcessorInstructionsPerRound;
+
+    /// In threaded mode, how processor threads are placed on host CPUs.
+    enum Cyber962PlacementPolicy placementPolicy;
+};
 
 
 /// Creates a Cyber 962 system.
@@ -39,19 +93,59 @@ struct Cyber962IOU;
 ///
 /// - Parameters:
 ///   - identifier: Name or other human-readable identifier for the system.
-///   - memorySize: Size of the Central Memory in bytes.
+///   - memorySize: Size of the Central Memory in bytes; sizes above 256MB use sparse storage.
 ///   - centralProcessors: Number of Central Processors in the system, 1 or 2.
 ///   - inputOutputUnits: Number of Input/Output Units in the system, 1 to 3.
 ///
 /// - Returns: A configured Cyber 962 system or `NULL` on failure.
 CYBER_EXPORT struct Cyber962 * _Nullable Cyber962Create(const char * _Nonnull identifier, size_t memorySize, int centralProcessors, int inputOutputUnits);
 
+/// Creates a Cyber 962 system from a configuration.
+///
+/// - Note: The number of Peripheral Processors per I/O Unit is fixed at 20.
+///
+/// - Parameters:
+///   - identifier: Name or other human-readable identifier for the system.
+///   - configuration: The configuration of the system, which is copied.
+///
+/// - Returns: A configured Cyber 962 system or `NULL` on failure.
+CYBER_EXPORT struct Cyber962 * _Nullable Cyber962CreateWithConfiguration(const char * _Nonnull identifier, const struct Cyber962Configuration *configuration);
+
 /// Disposes of a Cyber 962 system.
-CYBER_EXPORT void Cyber962Dispose(struct Cyber962 * _Nullable system);
+///
+/// Terminates every processor thread and waits for all of them to exit, for at most ``CYBER_THREAD_JOIN_TIMEOUT`` in total, before freeing the system.
+///
+/// - Returns: `true` if the system was disposed of, or `false` if a processor thread didn't exit in time, in which case the system is leaked, since that thread may still be using it.
+CYBER_EXPORT bool Cyber962Dispose(struct Cyber962 * _Nullable system);
 
 /// Get the identifier from a Cyber 962 system; the caller must free the result.
 CYBER_EXPORT char *Cyber962GetIdentifier(struct Cyber962 *system);
 
+/// Get the run mode of the given Cyber 962 system.
+CYBER_EXPORT enum Cyber962RunMode Cyber962GetRunMode(struct Cyber962 *system);
+
+/// Run a Cyber 962 system in lockstep mode for the given number of rounds.
+///
+/// Each round, every running Central Processor in turn executes the configured number of instructions, and then every running Peripheral Processor in each I/O Unit in turn executes one instruction.
+///
+/// - Warning: The system must have been created in ``Cyber962RunModeLockstep``.
+CYBER_EXPORT void Cyber962RunLockstepRounds(struct Cyber962 *system, uint64_t rounds);
+
+/// Pause every Central Processor and Peripheral Processor thread of a Cyber 962 system at an instruction boundary.
+///
+/// When this returns, no processor thread is executing an instruction or will execute one until ``Cyber962ResumeAll`` is called, so the machine state is coherent and can be examined or modified, for example to take a snapshot, attach a debugger, or collect statistics. Processors that are stopped stay stopped, and processors started while the system is paused wait until it's resumed before doing anything.
+///
+/// In lockstep mode there are no processor threads, so this only records that the system is paused.
+///
+/// - Warning: Pauses don't nest: Only one caller may pause a system at a time, and it must not be one of the system's own processor threads.
+CYBER_EXPORT void Cyber962PauseAll(struct Cyber962 *system);
+
+/// Resume every processor thread of a Cyber 962 system paused by ``Cyber962PauseAll``.
+CYBER_EXPORT void Cyber962ResumeAll(struct Cyber962 *system);
+
+/// Get whether a Cyber 962 system is paused by ``Cyber962PauseAll``.
+CYBER_EXPORT bool Cyber962IsPaused(struct Cyber962 *system);
+
 /// Get the Central Memory for the given Cyber 962 system.
 CYBER_EXPORT struct Cyber180CM *Cyber962GetCentralMemory(struct Cyber962 *system);
 
@@ -62,6 +156,129 @@ CYBER_EXPORT struct Cyber180CP * _Nullable Cyber962GetCentralProcessor(struct Cy
 CYBER_EXPORT struct Cyber962IOU * _Nullable Cyber962GetInputOutputUnit(struct Cyber962 *system, int index);
 
 
+/// Live counters for a whole Cyber 962 system.
+struct Cyber962Statistics {
+
+    /// The host's monotonic clock when the counters were read, in nanoseconds, for computing rates between snapshots.
+    uint64_t nanoseconds;
+
+    /// The number of Central Processors in the system.
+    int centralProcessorCount;
+
+    /// The counters for each Central Processor.
+    struct Cyber180CPStatistics centralProcessors[2];
+
+    /// The number of I/O Units in the system.
+    int inputOutputUnitCount;
+
+    /// The number of instructions each Peripheral Processor of each I/O Unit has executed, which is 0 for those not yet created.
+    uint64_t peripheralProcessorInstructions[3][20];
+
+    /// The counters for each I/O Channel of each I/O Unit, which are 0 for those not yet created.
+    struct Cyber962IOChannelStatistics inputOutputChannels[3][20];
+
+    /// The number of Central Memory ports, one for each Central Processor followed by one for each I/O Unit.
+    int centralMemoryPortCount;
+
+    /// The counters for each Central Memory port.
+    struct Cyber180CMPortStatistics centralMemoryPorts[5];
+};
+
+
+/// Get the live counters for a whole system.
+///
+/// Every counter is written by only the thread it counts for, on a cache line of its own, so reading them doesn't slow down the processors.
+///
+/// - Note: This may be called from any thread. Each counter is read whole, but while the system is running they're read at slightly different times; for a snapshot in which all counters agree, call this while the system is paused by ``Cyber962PauseAll``.
+CYBER_EXPORT void Cyber962GetStatistics(struct Cyber962 *system, struct Cyber962Statistics *statistics);
+
+
+/// Get the execution statistics for each opcode, summed across all of the system's Central Processors.
+///
+/// - Returns: `true` if opcode statistics are collected, or `false` with `statistics` left all zero if they're not.
+///
+/// - Note: This may be called from any thread; while the system is running, the result is only a snapshot.
+CYBER_EXPORT bool Cyber962GetCentralProcessorOpcodeStatistics(struct Cyber962 *system, struct Cyber180CPOpcodeStatistics *statistics);
+
+/// Get the execution statistics for each opcode, summed across all of the system's Peripheral Processors.
+///
+/// - Returns: `true` if opcode statistics are collected, or `false` with `statistics` left all zero if they're not.
+///
+/// - Note: This may be called from any thread; while the system is running, the result is only a snapshot.
+CYBER_EXPORT bool Cyber962GetPeripheralProcessorOpcodeStatistics(struct Cyber962 *system, struct Cyber962PPOpcodeStatistics *statistics);
+
+
+/// Start tracing guest keypoints to a new binary trace file at `path`.
+///
+/// While tracing, every Central Processor `KEYPOINT` and Peripheral Processor `KPT` instruction appends a ``CyberKeypointRecord`` to a ring buffer belonging to its processor, without taking a lock, and a background thread drains the rings to the file; read it back with ``CyberTraceReaderOpen``. A record is dropped rather than making its processor wait if the processor's ring is full.
+///
+/// - Returns: `true` if tracing started, or `false` if the file couldn't be created.
+///
+/// - Warning: Only one thread may start and stop tracing, and tracing must not already be started.
+CYBER_EXPORT bool Cyber962StartKeypointTrace(struct Cyber962 *system, const char *path);
+
+/// Stop tracing guest keypoints, writing any records still buffered and closing the trace file.
+///
+/// - Parameters:
+///   - dropped: Set to the number of records dropped because a processor's ring was full, or 0 if tracing wasn't started, if not `NULL`.
+///
+/// - Returns: `true` if tracing wasn't started or the whole trace was written, or `false` if writing the trace file failed, leaving it truncated.
+CYBER_EXPORT bool Cyber962StopKeypointTrace(struct Cyber962 *system, uint64_t * _Nullable dropped);
+
+
+/// Start tracing every Central Processor instruction to a new binary trace file at `path`.
+///
+/// While tracing, each Central Processor encodes every instruction it executes, with its address and the registers it changed, as a compact record of differences from the one before, and appends it to a ring buffer of its own without taking a lock; a background thread drains the rings to the file. See ``CyberInstructionTraceFlags`` for the format and ``CyberInstructionTraceDecode`` to read it back. A record is dropped rather than making its processor wait if the processor's ring is full, and the processor then records a keyframe so decoding can resume.
+///
+/// - Returns: `true` if tracing started, or `false` if the file couldn't be created.
+///
+/// - Warning: Only one thread may start and stop tracing, and tracing must not already be started.
+CYBER_EXPORT bool Cyber962StartInstructionTrace(struct Cyber962 *system, const char *path);
+
+/// Stop tracing Central Processor instructions, writing any records still buffered and closing the trace file.
+///
+/// - Parameters:
+///   - dropped: Set to the number of records dropped because a processor's ring was full, or 0 if tracing wasn't started, if not `NULL`.
+///
+/// - Returns: `true` if tracing wasn't started or the whole trace was written, or `false` if writing the trace file failed, leaving it truncated.
+CYBER_EXPORT bool Cyber962StopInstructionTrace(struct Cyber962 *system, uint64_t * _Nullable dropped);
+
+
+/// Start tracing a timeline of what each processor is doing to a new binary trace file at `path`.
+///
+/// The timeline records when each processor runs, parks at a safepoint, and stops, along with exchange jumps, monitor conditions, channel activity and transfers, and waits for the Central Memory access lock, all timestamped with the host cycle counter so events on different processors line up. Each processor appends ``CyberTimelineRecord``s to a ring buffer of its own without taking a lock, and a background thread drains the rings to the file. A record is dropped rather than making its processor wait if the processor's ring is full.
+///
+/// Processor threads are briefly paused, unless the system is already paused, so the state each processor starts in can be recorded.
+///
+/// - Returns: `true` if tracing started, or `false` if the file couldn't be created.
+///
+/// - Warning: Only one thread may start and stop tracing, and tracing must not already be started. In lockstep mode, that must be the thread that runs the system.
+CYBER_EXPORT bool Cyber962StartTimelineTrace(struct Cyber962 *system, const char *path);
+
+/// Stop tracing the timeline, ending each processor's timeline, writing any records still buffered, and closing the trace file.
+///
+/// - Parameters:
+///   - dropped: Set to the number of records dropped because a processor's ring was full, or 0 if tracing wasn't started, if not `NULL`.
+///
+/// - Returns: `true` if tracing wasn't started or the whole trace was written, or `false` if writing the trace file failed, leaving it truncated.
+CYBER_EXPORT bool Cyber962StopTimelineTrace(struct Cyber962 *system, uint64_t * _Nullable dropped);
+
+
+/// Start sampling where the guest is spending its time.
+///
+/// A thread of its own reads `P` of each running Central and Peripheral Processor `samplesPerSecond` times a second, without stopping or otherwise disturbing them, and counts how often each processor is found at each address. Nothing is sampled while the system is paused.
+///
+/// - Returns: `true` if profiling started, or `false` if the profiler couldn't be created.
+///
+/// - Warning: Only one thread may start and stop profiling, and profiling must not already be started.
+CYBER_EXPORT bool Cyber962StartProfiler(struct Cyber962 *system, double samplesPerSecond);
+
+/// Stop sampling where the guest is spending its time.
+///
+/// - Returns: The profile of the samples taken, which the caller must dispose of with ``CyberProfileDispose``, or `NULL` if profiling wasn't started.
+CYBER_EXPORT struct CyberProfile * _Nullable Cyber962StopProfiler(struct Cyber962 *system);
+
+
 CYBER_HEADER_END
 
 #endif /* __CYBER_CYBER962_H__ */
@@ -19,8 +19,13 @@
 
 #include "Cyber962IOChannel_Internal.h"
 
+#include "Cyber962IOU_Internal.h"
+#include "Cyber962_Internal.h"
+#include "CyberCycleCounter.h"
+
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 CYBER_SOURCE_BEGIN
@@ -31,7 +36,14 @@ struct Cyber962IOChannel * _Nullable Cyber962IOChannelCreate(struct Cyber962IOU
     assert(inputOutputUnit != NULL);
     assert((index >= 0) && (index < 20));
 
-    struct Cyber962IOChannel *ioc = calloc(1, sizeof(struct Cyber962IOChannel));
+    // Allocate on a cache line boundary so the channel state, which is aligned within the structure, doesn't share a cache line with other channels.
+    struct Cyber962IOChannel *ioc = NULL;
+    int alloc_err = posix_memalign((void **)&ioc, CYBER_CACHE_LINE_SIZE, sizeof(struct Cyber962IOChannel));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(ioc, 0, sizeof(struct Cyber962IOChannel));
 
     ioc->_inputOutputUnit = inputOutputUnit;
     ioc->_index = index;
@@ -92,4 +104,58 @@ void Cyber962IOChannelSetFunctions(struct Cyber962IOChannel *ioc, struct Cyber96
 }
 
 
+CyberWord32 Cyber962IOChannelRead(struct Cyber962IOChannel *ioc, CyberWord16 *buffer, CyberWord32 count)
+{
+    assert(ioc != NULL);
+    assert(ioc->_functions != NULL);
+    assert(buffer != NULL);
+
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(ioc->_inputOutputUnit->_system);
+    uint64_t startTicks = (trace != NULL) ? CyberCycleCounterRead() : 0;
+
+    CyberWord32 read = ioc->_functions->readFunction(ioc, ioc->_functions->context, buffer, count);
+
+    // The transfer is made by whichever Peripheral Processor is running on this thread.
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CyberTraceCurrentStream, CyberTimelineEventChannelInput, ioc->_index, read, startTicks, CyberCycleCounterRead() - startTicks);
+    }
+
+    // Any Peripheral Processor may use the channel, so the counter needs an atomic increment.
+    __atomic_fetch_add(&ioc->_wordsRead, read, __ATOMIC_RELAXED);
+
+    return read;
+}
+
+
+CyberWord32 Cyber962IOChannelWrite(struct Cyber962IOChannel *ioc, CyberWord16 *buffer, CyberWord32 count)
+{
+    assert(ioc != NULL);
+    assert(ioc->_functions != NULL);
+    assert(buffer != NULL);
+
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(ioc->_inputOutputUnit->_system);
+    uint64_t startTicks = (trace != NULL) ? CyberCycleCounterRead() : 0;
+
+    CyberWord32 written = ioc->_functions->writeFunction(ioc, ioc->_functions->context, buffer, count);
+
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CyberTraceCurrentStream, CyberTimelineEventChannelOutput, ioc->_index, written, startTicks, CyberCycleCounterRead() - startTicks);
+    }
+
+    __atomic_fetch_add(&ioc->_wordsWritten, written, __ATOMIC_RELAXED);
+
+    return written;
+}
+
+
+void Cyber962IOChannelGetStatistics(struct Cyber962IOChannel *ioc, struct Cyber962IOChannelStatistics *statistics)
+{
+    assert(ioc != NULL);
+    assert(statistics != NULL);
+
+    statistics->wordsRead = __atomic_load_n(&ioc->_wordsRead, __ATOMIC_RELAXED);
+    statistics->wordsWritten = __atomic_load_n(&ioc->_wordsWritten, __ATOMIC_RELAXED);
+}
+
+
 CYBER_SOURCE_END
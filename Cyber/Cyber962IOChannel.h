@@ -74,6 +74,33 @@ struct Cyber962IOChannelFunctions {
 };
 
 
+/// Read words from the device implementing the channel.
+///
+/// - Returns: The number of words read.
+CYBER_EXPORT CyberWord32 Cyber962IOChannelRead(struct Cyber962IOChannel *ioc, CyberWord16 *buffer, CyberWord32 count);
+
+/// Write words to the device implementing the channel.
+///
+/// - Returns: The number of words written.
+CYBER_EXPORT CyberWord32 Cyber962IOChannelWrite(struct Cyber962IOChannel *ioc, CyberWord16 *buffer, CyberWord32 count);
+
+
+/// Live counters for an I/O Channel.
+struct Cyber962IOChannelStatistics {
+
+    /// The number of words read from the channel.
+    uint64_t wordsRead;
+
+    /// The number of words written to the channel.
+    uint64_t wordsWritten;
+};
+
+/// Get the live counters for an I/O Channel.
+///
+/// - Note: This may be called from any thread; while the channel is in use, the result is only a snapshot.
+CYBER_EXPORT void Cyber962IOChannelGetStatistics(struct Cyber962IOChannel *ioc, struct Cyber962IOChannelStatistics *statistics);
+
+
 /// Indicates whether the channel is active or inactive.
 CYBER_EXPORT bool Cyber962IOChannelIsActive(struct Cyber962IOChannel *ioc);
 
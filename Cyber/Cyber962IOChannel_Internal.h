@@ -40,8 +40,13 @@ struct Cyber962IOChannel {
     /// The index of this I/O Channel in the I/O Unit.
     int _index;
 
+    /// The functions used for this channel.
+    struct Cyber962IOChannelFunctions *_functions;
+
     /// Whether the channel is active or inactive.
-    bool _active;
+    ///
+    /// The channel state is written by whichever Peripheral Processors use the channel, so it starts on a cache line of its own, away from the configuration above.
+    CYBER_CACHE_ALIGNED bool _active;
 
     /// Whether the channel is full or empty.
     bool _full;
@@ -52,8 +57,14 @@ struct Cyber962IOChannel {
     /// Whether the channel has encountered an error.
     bool _error;
 
-    /// The functions used for this channel.
-    struct Cyber962IOChannelFunctions *_functions;
+    /// The number of words read from the channel.
+    ///
+    /// Any Peripheral Processor may transfer on the channel, so the counters are updated atomically; they start on a cache line of their own so those updates don't contend with the channel state above, which PPs poll.
+    CYBER_CACHE_ALIGNED uint64_t _wordsRead;
+
+    /// The number of words written to the channel.
+    uint64_t _wordsWritten;
+
 
     // TODO: Flesh out.
 };
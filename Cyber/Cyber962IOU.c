@@ -19,6 +19,9 @@
 
 #include "Cyber962IOU_Internal.h"
 
+#include "Cyber180CMPort_Internal.h"
+#include "Cyber962PP_Internal.h"
+
 #include <Cyber/Cyber962PP.h>
 #include <Cyber/Cyber962IOChannel.h>
 
@@ -39,14 +42,13 @@ struct Cyber962IOU * _Nullable Cyber962IOUCreate(struct Cyber962 * _Nonnull syst
     iou->_system = system;
     iou->_index = index;
 
-    for (int pp = 0; pp < 20; pp++) {
-        struct Cyber962PP *peripheralProcessor = Cyber962PPCreate(iou, pp);
-        iou->_peripheralProcessors[pp] = peripheralProcessor;
-    }
+    // Peripheral Processors and I/O Channels are created on first use, since most configurations only use a few of them.
 
-    for (int ioc = 0; ioc < 20; ioc++) {
-        struct Cyber962IOChannel *inputOutputChannel = Cyber962IOChannelCreate(iou, ioc);
-        iou->_inputOutputChannels[ioc] = inputOutputChannel;
+    int err = pthread_mutex_init(&iou->_creationLock, NULL);
+    if (err != 0) {
+        assert(err == 0); // halt here in debug builds
+        free(iou);
+        return NULL;
     }
 
     return iou;
@@ -58,6 +60,9 @@ void Cyber962IOUDispose(struct Cyber962IOU * _Nullable iou)
     if (iou == NULL) return;
 
     for (int pp = 0; pp < 20; pp++) {
+        if ((iou->_peripheralProcessors[pp] != NULL) && (iou->_centralMemoryPort != NULL)) {
+            Cyber180CMPortDetachCounters(iou->_centralMemoryPort, pp);
+        }
         Cyber962PPDispose(iou->_peripheralProcessors[pp]);
     }
 
@@ -65,6 +70,11 @@ void Cyber962IOUDispose(struct Cyber962IOU * _Nullable iou)
         Cyber962IOChannelDispose(iou->_inputOutputChannels[ioc]);
     }
 
+    int err = pthread_mutex_destroy(&iou->_creationLock);
+    if (err != 0) {
+        assert(err == 0); // halt here in debug builds
+    }
+
     free(iou);
 }
 
@@ -74,7 +84,24 @@ struct Cyber962PP *Cyber962IOUGetPeripheralProcessor(struct Cyber962IOU *iou, in
     assert(iou != NULL);
     assert((index >= 0) && (index < 20));
 
-    return iou->_peripheralProcessors[index];
+    struct Cyber962PP *peripheralProcessor = __atomic_load_n(&iou->_peripheralProcessors[index], __ATOMIC_ACQUIRE);
+    if (peripheralProcessor != NULL) {
+        return peripheralProcessor;
+    }
+
+    // Create the PP under the lock, rechecking in case another thread created it first. It's published with a release store, so anyone who sees it sees it fully set up.
+    pthread_mutex_lock(&iou->_creationLock); {
+        peripheralProcessor = iou->_peripheralProcessors[index];
+        if (peripheralProcessor == NULL) {
+            peripheralProcessor = Cyber962PPCreate(iou, index);
+            if ((peripheralProcessor != NULL) && (iou->_centralMemoryPort != NULL)) {
+                Cyber180CMPortAttachCounters(iou->_centralMemoryPort, &peripheralProcessor->_centralMemoryCounters, index);
+            }
+            __atomic_store_n(&iou->_peripheralProcessors[index], peripheralProcessor, __ATOMIC_RELEASE);
+        }
+    } pthread_mutex_unlock(&iou->_creationLock);
+
+    return peripheralProcessor;
 }
 
 
@@ -93,15 +120,32 @@ void Cyber962IOUSetCentralMemoryPort(struct Cyber962IOU *iou, struct Cyber180CMP
     assert(iou->_centralMemoryPort == NULL);
 
     iou->_centralMemoryPort = port;
+
+    // All of this IOU's Peripheral Processors access memory through the one port.
+    Cyber180CMPortSetShared(port, true);
 }
 
 
-struct Cyber962IOChannel *Cyber962GetIOChannelAtIndex(struct Cyber962IOU *iou, int index)
+struct Cyber962IOChannel *Cyber962IOUGetIOChannelAtIndex(struct Cyber962IOU *iou, int index)
 {
     assert(iou != NULL);
     assert((index >= 0) && (index < 20));
 
-    return iou->_inputOutputChannels[index];
+    struct Cyber962IOChannel *inputOutputChannel = __atomic_load_n(&iou->_inputOutputChannels[index], __ATOMIC_ACQUIRE);
+    if (inputOutputChannel != NULL) {
+        return inputOutputChannel;
+    }
+
+    // Create the channel under the lock, the same way as a PP.
+    pthread_mutex_lock(&iou->_creationLock); {
+        inputOutputChannel = iou->_inputOutputChannels[index];
+        if (inputOutputChannel == NULL) {
+            inputOutputChannel = Cyber962IOChannelCreate(iou, index);
+            __atomic_store_n(&iou->_inputOutputChannels[index], inputOutputChannel, __ATOMIC_RELEASE);
+        }
+    } pthread_mutex_unlock(&iou->_creationLock);
+
+    return inputOutputChannel;
 }
 
 
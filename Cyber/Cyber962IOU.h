@@ -40,7 +40,7 @@ struct Cyber962PP;
 ///
 /// - Returns: An I/O Unit connected to the system, or `NULL` on failure.
 ///
-/// - Note: An IOU is assumed to be fully-populated, thus no choice is available in how many Peripheral Processors or channels it supports.
+/// - Note: An IOU is assumed to be fully-populated, thus no choice is available in how many Peripheral Processors or channels it supports. However, each Peripheral Processor and channel is only created, along with its thread and memory, when it's first used.
 CYBER_EXPORT struct Cyber962IOU * _Nullable Cyber962IOUCreate(struct Cyber962 * _Nonnull system, int index);
 
 
@@ -50,6 +50,8 @@ CYBER_EXPORT void Cyber962IOUDispose(struct Cyber962IOU * _Nullable iou);
 
 /// Gets the Cyber 962 Peripheral Processor at the given index.
 ///
+/// The Peripheral Processor is created on the first request for it.
+///
 /// - Note: An IOU is assumed to be fully-populated, thus there's no need to figure out how many Peripheral Processors or channels it supports.
 CYBER_EXPORT struct Cyber962PP *Cyber962IOUGetPeripheralProcessor(struct Cyber962IOU *iou, int index);
 
@@ -59,7 +61,9 @@ CYBER_EXPORT struct Cyber180CMPort *Cyber962IOUGetCentralMemoryPort(struct Cyber
 
 
 /// Gets the I/O Channel with the given index.
-CYBER_EXPORT struct Cyber962IOChannel *Cyber962IOUGetIOChannelAtIndex(int index);
+///
+/// The I/O Channel is created on the first request for it.
+CYBER_EXPORT struct Cyber962IOChannel *Cyber962IOUGetIOChannelAtIndex(struct Cyber962IOU *iou, int index);
 
 
 CYBER_HEADER_END
@@ -19,6 +19,8 @@
 
 #include <Cyber/Cyber962IOU.h>
 
+#include <pthread.h>
+
 #ifndef __CYBER_CYBER962IOU_INTERNAL_H__
 #define __CYBER_CYBER962IOU_INTERNAL_H__
 
@@ -39,14 +41,21 @@ struct Cyber962IOU {
     /// Index of this Input/Output Unit in the system.
     int _index;
 
-    /// This Input/Output Unit's Peripheral Processors.
+    /// This Input/Output Unit's Peripheral Processors, each created on first use.
+    ///
+    /// - Warning: Entries may be filled in concurrently, so read them with an acquire load.
     struct Cyber962PP * _Nullable _peripheralProcessors[20];
 
     /// This Input/Output Unit's Central Memory port.
     struct Cyber180CMPort * _Nonnull _centralMemoryPort;
 
-    /// The Input/Output Unit's Input/Output Channels.
-    struct Cyber962IOChannel * _Nonnull _inputOutputChannels[20];
+    /// The Input/Output Unit's Input/Output Channels, each created on first use.
+    ///
+    /// - Warning: Entries may be filled in concurrently, so read them with an acquire load.
+    struct Cyber962IOChannel * _Nullable _inputOutputChannels[20];
+
+    /// Serializes creating Peripheral Processors and Input/Output Channels on first use.
+    pthread_mutex_t _creationLock;
 
     // TODO: Flesh out.
 };
@@ -19,7 +19,11 @@
 
 #include "Cyber962PP_Internal.h"
 
+#include "Cyber962IOU_Internal.h"
+#include "Cyber962_Internal.h"
 #include "Cyber962PPInstructions.h"
+#include "CyberCycleCounter.h"
+#include "CyberOpcodeStatistics_Internal.h"
 #include "CyberState.h"
 #include "CyberThread.h"
 
@@ -33,9 +37,9 @@
 CYBER_SOURCE_BEGIN
 
 
+static void Cyber962PPThreadStart(struct CyberThread *thread, void * _Nullable ppv);
 static void Cyber962PPMainLoop(struct CyberThread *thread, void * _Nullable ppv);
-
-static void Cyber962PPSingleStep(struct Cyber962PP *processor);
+static void Cyber962PPThreadStop(struct CyberThread *thread, void * _Nullable ppv);
 
 
 struct Cyber962PP * _Nullable Cyber962PPCreate(struct Cyber962IOU *inputOutputUnit, int index)
@@ -43,24 +47,55 @@ struct Cyber962PP * _Nullable Cyber962PPCreate(struct Cyber962IOU *inputOutputUn
     assert(inputOutputUnit != NULL);
     assert((index >= 0) && (index <= 20));
 
-    struct Cyber962PP *pp = calloc(1, sizeof(struct Cyber962PP));
+    // Allocate on a cache line boundary so the registers, which are aligned within the structure, really are on cache lines of their own.
+    struct Cyber962PP *pp = NULL;
+    int alloc_err = posix_memalign((void **)&pp, CYBER_PROCESSOR_ALIGNMENT, sizeof(struct Cyber962PP));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(pp, 0, sizeof(struct Cyber962PP));
 
     pp->_inputOutputUnit = inputOutputUnit;
     pp->_index = index;
 
-    pp->_storage = calloc(8192, sizeof(CyberWord16));
+    // PP memory is written by this PP's thread, so keep its ends from sharing cache lines with other allocations.
+    int storage_err = posix_memalign((void **)&pp->_storage, CYBER_PROCESSOR_ALIGNMENT, 8192 * sizeof(CyberWord16));
+    if (storage_err != 0) {
+        assert(storage_err == 0); // halt here in debug builds
+        free(pp);
+        return NULL;
+    }
+    memset(pp->_storage, 0, 8192 * sizeof(CyberWord16));
+
+#if CYBER_STATISTICS
+    // Every instruction updates the counters, so allocate them before there's a thread that could execute one.
+    pp->_opcodeStatistics = calloc(1, sizeof(struct Cyber962PPOpcodeStatistics));
+    if (pp->_opcodeStatistics == NULL) {
+        assert(pp->_opcodeStatistics != NULL); // halt here in debug builds
+        free(pp->_storage);
+        free(pp);
+        return NULL;
+    }
+#endif
 
     static struct CyberThreadFunctions Cyber962PPThreadFunctions = {
-        .start = NULL,
+        .start = Cyber962PPThreadStart,
         .loop = Cyber962PPMainLoop,
-        .stop = NULL,
-        .terminate = NULL,
+        .stop = Cyber962PPThreadStop,
+        .terminate = Cyber962PPThreadStop,
     };
 
-    char name[32];
-    snprintf(name, 32, "Cyber962PP-%d", index);
+    // In lockstep mode the system steps the PP itself, so it doesn't get a thread.
+    if (Cyber962GetRunMode(inputOutputUnit->_system) == Cyber962RunModeThreaded) {
+        char name[32];
+        snprintf(name, 32, "Cyber962PP-%d", index);
 
-    pp->_thread = CyberThreadCreate(name, &Cyber962PPThreadFunctions, pp);
+        struct CyberThreadAttributes attributes;
+        Cyber962GetPeripheralProcessorThreadAttributes(inputOutputUnit->_system, inputOutputUnit->_index, Cyber962PPGetBarrel(pp), &attributes);
+
+        pp->_thread = CyberThreadCreateWithAttributes(name, &Cyber962PPThreadFunctions, pp, &attributes);
+    }
 
     pp->_instructionCache = calloc(65536, sizeof(void *));
 
@@ -77,12 +112,17 @@ void Cyber962PPDispose(struct Cyber962PP * _Nullable pp)
 {
     if (pp == NULL) return;
 
-    free(pp->_storage);
-
+    // Terminate and join the thread before freeing anything it uses.
     CyberThreadDispose(pp->_thread);
 
+    free(pp->_storage);
+
     free(pp->_instructionCache);
 
+#if CYBER_STATISTICS
+    free(pp->_opcodeStatistics);
+#endif
+
     free(pp);
 }
 
@@ -95,25 +135,65 @@ void Cyber962PPReset(struct Cyber962PP *pp)
 }
 
 
+/// Record a change in a Peripheral Processor's state to the system's timeline, if it's being traced.
+static void Cyber962PPRecordTimelineState(struct Cyber962PP *pp, enum CyberTimelineEvent event)
+{
+    struct Cyber962IOU *inputOutputUnit = pp->_inputOutputUnit;
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(inputOutputUnit->_system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_PP_STREAM(inputOutputUnit->_index, pp->_index), event, 0, 0, CyberCycleCounterRead(), 0);
+    }
+}
+
+
 void Cyber962PPStart(struct Cyber962PP *pp)
 {
     assert(pp != NULL);
 
-    CyberThreadStart(pp->_thread);
+    if (pp->_thread != NULL) {
+        CyberThreadStart(pp->_thread);
+    } else {
+        // In lockstep mode the system steps the PP on this thread, so this thread may record to its stream.
+        pp->_running = true;
+        Cyber962PPRecordTimelineState(pp, CyberTimelineEventRunning);
+    }
 }
 
 void Cyber962PPStop(struct Cyber962PP *pp)
 {
     assert(pp != NULL);
 
-    CyberThreadStop(pp->_thread);
+    if (pp->_thread != NULL) {
+        CyberThreadStop(pp->_thread);
+    } else {
+        pp->_running = false;
+        Cyber962PPRecordTimelineState(pp, CyberTimelineEventStopped);
+    }
 }
 
 void Cyber962PPShutdown(struct Cyber962PP *pp)
 {
     assert(pp != NULL);
 
-    CyberThreadTerminate(pp->_thread);
+    if (pp->_thread != NULL) {
+        CyberThreadTerminate(pp->_thread);
+    } else {
+        pp->_running = false;
+    }
+}
+
+/// The thread function called when a Peripheral Processor starts running.
+static void Cyber962PPThreadStart(struct CyberThread *thread, void * _Nullable ppv)
+{
+    struct Cyber962PP *pp = (struct Cyber962PP *)ppv;
+    assert(pp != NULL);
+
+    Cyber962SafepointEnter(pp->_inputOutputUnit->_system);
+    pp->_safepointRegistered = true;
+
+    CyberTraceCurrentStream = CYBER_TRACE_PP_STREAM(pp->_inputOutputUnit->_index, pp->_index);
+    Cyber180CMPortCurrentCounters = &pp->_centralMemoryCounters;
+    Cyber962PPRecordTimelineState(pp, CyberTimelineEventRunning);
 }
 
 /// The thread function for the main loop for a Peripheral Processor.
@@ -122,16 +202,40 @@ static void Cyber962PPMainLoop(struct CyberThread *thread, void * _Nullable ppv)
     struct Cyber962PP *pp = (struct Cyber962PP *)ppv;
     assert(pp != NULL);
 
+    // Park here if the system is being paused, so the pause happens on an instruction boundary.
+    Cyber962SafepointPoll(pp->_inputOutputUnit->_system);
+
     // Run the main loop once.
     Cyber962PPSingleStep(pp);
 }
 
+/// The thread function called when a Peripheral Processor stops running or is shut down.
+static void Cyber962PPThreadStop(struct CyberThread *thread, void * _Nullable ppv)
+{
+    struct Cyber962PP *pp = (struct Cyber962PP *)ppv;
+    assert(pp != NULL);
+
+    // The thread also stops once when it's created, before it has ever started.
+    if (pp->_safepointRegistered) {
+        Cyber962PPRecordTimelineState(pp, CyberTimelineEventStopped);
+        CyberTraceCurrentStream = -1;
+        Cyber180CMPortCurrentCounters = NULL;
+
+        pp->_safepointRegistered = false;
+        Cyber962SafepointLeave(pp->_inputOutputUnit->_system);
+    }
+}
+
 
 /// The main loop for a Peripheral Processor, which runs a single step of its execution.
-static void Cyber962PPSingleStep(struct Cyber962PP *processor)
+void Cyber962PPSingleStep(struct Cyber962PP *processor)
 {
     assert(processor != NULL);
 
+#if CYBER_STATISTICS
+    uint64_t startCycles = CyberCycleCounterRead();
+#endif
+
     CyberWord16 oldP = processor->_regP;
     union Cyber962PPInstructionWord instructionWord;
     instructionWord._raw = Cyber962PPReadSingle(processor, oldP);
@@ -139,6 +243,37 @@ static void Cyber962PPSingleStep(struct Cyber962PP *processor)
     CyberWord16 advance = instruction(processor, instructionWord);
     CyberWord16 newP = oldP + advance;
     processor->_regP = newP;
+
+    // Only this thread writes the count, so it doesn't need an atomic increment, just a store other threads can read whole.
+    __atomic_store_n(&processor->_instructionCount, processor->_instructionCount + 1, __ATOMIC_RELAXED);
+
+#if CYBER_STATISTICS
+    CyberOpcodeCounterRecord(&processor->_opcodeStatistics->opcodes[(instructionWord._d.g << 6) | instructionWord._d.f], CyberCycleCounterRead() - startCycles);
+#endif
+}
+
+
+uint64_t Cyber962PPGetInstructionCount(struct Cyber962PP *pp)
+{
+    assert(pp != NULL);
+
+    return __atomic_load_n(&pp->_instructionCount, __ATOMIC_RELAXED);
+}
+
+
+bool Cyber962PPGetOpcodeStatistics(struct Cyber962PP *pp, struct Cyber962PPOpcodeStatistics *statistics)
+{
+    assert(pp != NULL);
+    assert(statistics != NULL);
+
+    memset(statistics, 0, sizeof(struct Cyber962PPOpcodeStatistics));
+
+#if CYBER_STATISTICS
+    CyberOpcodeCounterAccumulate(statistics->opcodes, pp->_opcodeStatistics->opcodes, CYBER962PP_OPCODE_COUNT);
+    return true;
+#else
+    return false;
+#endif
 }
 
 
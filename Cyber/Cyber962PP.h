@@ -27,6 +27,7 @@ CYBER_HEADER_BEGIN
 
 struct Cyber962IOU;
 struct Cyber962PP;
+struct Cyber962PPOpcodeStatistics;
 
 
 /// Create a Cyber 962 Peripheral Processor connected to an Input/Output Unit.
@@ -56,6 +57,19 @@ CYBER_EXPORT void Cyber962PPStop(struct Cyber962PP *pp);
 CYBER_EXPORT void Cyber962PPShutdown(struct Cyber962PP *pp);
 
 
+/// Get the number of instructions the Peripheral Processor has executed.
+///
+/// - Note: This may be called from any thread; while the Peripheral Processor is running, the result is only a snapshot.
+CYBER_EXPORT uint64_t Cyber962PPGetInstructionCount(struct Cyber962PP *pp);
+
+/// Get the execution statistics for each opcode the Peripheral Processor has executed.
+///
+/// - Returns: `true` if opcode statistics are collected, or `false` with `statistics` left all zero if they're not.
+///
+/// - Note: This may be called from any thread; while the Peripheral Processor is running, the result is only a snapshot.
+CYBER_EXPORT bool Cyber962PPGetOpcodeStatistics(struct Cyber962PP *pp, struct Cyber962PPOpcodeStatistics *statistics);
+
+
 CYBER_HEADER_END
 
 #endif /* __CYBER_CYBER962PP_H__ */
@@ -22,7 +22,11 @@
 #include <Cyber/Cyber180CMPort.h>
 #include <Cyber/Cyber962IOU.h>
 
+#include "Cyber962IOU_Internal.h"
 #include "Cyber962PP_Internal.h"
+#include "Cyber962_Internal.h"
+#include "CyberCycleCounter.h"
+#include "CyberTrace_Internal.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -862,6 +866,7 @@ CyberWord16 Cyber962PPInstruction_RAx(struct Cyber962PP *processor, union Cyber9
             CyberWord18 newA = (processor->_regA + addend) & 0xFFFF;
             processor->_regA = newA;
             Cyber962PPWriteSingle(processor, d16, newA);
+            return 1;
         } break;
 
         case 00055: { // RAM (m+(d))
@@ -1025,6 +1030,8 @@ CyberWord16 Cyber962PPInstruction_SOx(struct Cyber962PP *processor, union Cyber9
 }
 
 /// Implementation of some "Jump" instructions, specifically Long Jump and Return Jump.
+///
+/// Like every instruction, these return how far to advance `P`, here the distance to the jump's destination, rather than setting `P` themselves.
 CyberWord16 Cyber962PPInstruction_xJM(struct Cyber962PP *processor, union Cyber962PPInstructionWord instructionWord)
 {
     uint16_t opcode = instructionWord._d.f | (instructionWord._d.g << 9);
@@ -1032,16 +1039,14 @@ CyberWord16 Cyber962PPInstruction_xJM(struct Cyber962PP *processor, union Cyber9
     switch (opcode) {
         case 00001: { // LJM (m+(d))
             CyberWord16 address = Cyber962PPComputeMemoryAddress(processor, instructionWord._d.d);
-            processor->_regP = address;
-            return 0;
+            return address - processor->_regP;
         } break;
 
         case 00002: { // RJM (m+(d))
             CyberWord16 address = Cyber962PPComputeMemoryAddress(processor, instructionWord._d.d);
             CyberWord16 oldP = processor->_regP;
             Cyber962PPWriteSingle(processor, address, oldP + 2);
-            processor->_regP = address + 1;
-            return 0;
+            return (address + 1) - oldP;
         } break;
 
         default:
@@ -1057,7 +1062,6 @@ CyberWord16 Cyber962PPInstruction_xJN(struct Cyber962PP *processor, union Cyber9
 {
     CyberWord12 opcode = instructionWord._d.f | (instructionWord._d.g << 9);
 
-    int64_t oldP64 = processor->_regP;
     int64_t d64 = instructionWord._d.d;
     int64_t pAdj = (d64 < 040) ? d64 : -(077 - d64);
     bool condition = false;
@@ -1088,12 +1092,8 @@ CyberWord16 Cyber962PPInstruction_xJN(struct Cyber962PP *processor, union Cyber9
             break;
     }
 
-    if (condition) {
-        int64_t newP64 = oldP64 + pAdj;
-        processor->_regP = newP64 & 0x000000000000FFFF;
-    }
-
-    return 0;
+    // The advance wraps around to a backward branch when the displacement is negative.
+    return condition ? (CyberWord16)(pAdj & 0x000000000000FFFF) : 1;
 }
 
 /// Implementation of "Load/Store R" instructions.
@@ -1206,12 +1206,14 @@ CyberWord16 Cyber962PPInstruction_CRx(struct Cyber962PP *processor, union Cyber9
             CyberWord48 cmAddress = Cyber962PPComputeCentralMemoryAddress(processor);
             CyberWord16 m = Cyber962PPReadSingle(processor, processor->_regP + 1);
             CyberWord12 count = Cyber962PPReadSingle(processor, d16) & 0x0FFF;
-            CyberWord64 *buffer = calloc(count, sizeof(CyberWord64));
-            Cyber180CMPortReadWordsPhysical(port, cmAddress, buffer, count);
+            assert((cmAddress % 8) == 0); // must be on a word boundary
+            struct Cyber180CMSpan span;
+            Cyber180CMPortMapRange(port, cmAddress, count * sizeof(CyberWord64), Cyber180CMAccess_Read, &span);
+            const CyberWord64 *words = (const CyberWord64 *)span.bytes;
             for (CyberWord12 i = 0; i < count; i++) {
-                Cyber962PPWriteCMWord60ToPPMWord12(processor, buffer[i] & 0x0FFFFFFFFFFFFFFF, m + (5 * i));
+                Cyber962PPWriteCMWord60ToPPMWord12(processor, words[i] & 0x0FFFFFFFFFFFFFFF, m + (5 * i));
             }
-            free(buffer);
+            Cyber180CMPortUnmapRange(port, &span);
             return 2;
         } break;
 
@@ -1219,12 +1221,14 @@ CyberWord16 Cyber962PPInstruction_CRx(struct Cyber962PP *processor, union Cyber9
             CyberWord48 cmAddress = Cyber962PPComputeCentralMemoryAddress(processor);
             CyberWord16 m = Cyber962PPReadSingle(processor, processor->_regP + 1);
             CyberWord16 count = Cyber962PPReadSingle(processor, d16) & 0xFFFF;
-            CyberWord64 *buffer = calloc(count, sizeof(CyberWord64));
-            Cyber180CMPortReadWordsPhysical(port, cmAddress, buffer, count);
-            for (CyberWord12 i = 0; i < count; i++) {
-                Cyber962PPWriteCMWord64ToPPMWord16(processor, buffer[i] & 0xFFFFFFFFFFFFFFFF, m + (4 * i));
+            assert((cmAddress % 8) == 0); // must be on a word boundary
+            struct Cyber180CMSpan span;
+            Cyber180CMPortMapRange(port, cmAddress, count * sizeof(CyberWord64), Cyber180CMAccess_Read, &span);
+            const CyberWord64 *words = (const CyberWord64 *)span.bytes;
+            for (CyberWord16 i = 0; i < count; i++) {
+                Cyber962PPWriteCMWord64ToPPMWord16(processor, words[i] & 0xFFFFFFFFFFFFFFFF, m + (4 * i));
             }
-            free(buffer);
+            Cyber180CMPortUnmapRange(port, &span);
             return 2;
         } break;
 
@@ -1247,25 +1251,19 @@ CyberWord16 Cyber962PPInstruction_RDxL(struct Cyber962PP *processor, union Cyber
         case 01000: { // RDSL d,(A)
             CyberWord48 cmAddress = Cyber962PPComputeCentralMemoryAddress(processor);
             CyberWord16 ppmAddress = d16;
-            Cyber180CMPortAcquireLock(port);
-            CyberWord64 x = Cyber180CMPortReadWordPhysical_Unlocked(port, cmAddress);
             CyberWord64 y = Cyber962PPReadPPMWord16ToCMWord64(processor, ppmAddress);
+            CyberWord64 x = Cyber180CMPortFetchOr64(port, cmAddress, y);
             Cyber962PPWriteCMWord64ToPPMWord16(processor, x, ppmAddress);
-            CyberWord64 xORy = x | y;
-            Cyber180CMPortWriteWordPhysical_Unlocked(port, cmAddress, xORy);
-            Cyber180CMPortRelinquishLock(port);
+            return 1;
         } break;
 
         case 01001: { // RDCL d,(A)
             CyberWord48 cmAddress = Cyber962PPComputeCentralMemoryAddress(processor);
             CyberWord16 ppmAddress = d16;
-            Cyber180CMPortAcquireLock(port);
-            CyberWord64 x = Cyber180CMPortReadWordPhysical_Unlocked(port, cmAddress);
             CyberWord64 y = Cyber962PPReadPPMWord16ToCMWord64(processor, ppmAddress);
+            CyberWord64 x = Cyber180CMPortFetchAnd64(port, cmAddress, y);
             Cyber962PPWriteCMWord64ToPPMWord16(processor, x, ppmAddress);
-            CyberWord64 xANDy = x & y;
-            Cyber180CMPortWriteWordPhysical_Unlocked(port, cmAddress, xANDy);
-            Cyber180CMPortRelinquishLock(port);
+            return 1;
         } break;
 
         default:
@@ -1305,12 +1303,14 @@ CyberWord16 Cyber962PPInstruction_CWx(struct Cyber962PP *processor, union Cyber9
             CyberWord12 m = Cyber962PPReadSingle(processor, processor->_regP + 1);
             CyberWord16 ppmAddress = m & 0x0FFF;
             CyberWord16 count = Cyber962PPReadSingle(processor, d16);
-            CyberWord60 *buffer = calloc(count, sizeof(CyberWord60));
+            assert((cmAddress % 8) == 0); // must be on a word boundary
+            struct Cyber180CMSpan span;
+            Cyber180CMPortMapRange(port, cmAddress, count * sizeof(CyberWord60), Cyber180CMAccess_Write, &span);
+            CyberWord60 *words = (CyberWord60 *)span.bytes;
             for (CyberWord16 i = 0; i < count; i++) {
-                buffer[i] = Cyber962PPReadPPMWord12ToCMWord60(processor, ppmAddress + (i * 5)) & 0xFFFFFFFFFFFFFFFF;
+                words[i] = Cyber962PPReadPPMWord12ToCMWord60(processor, ppmAddress + (i * 5)) & 0xFFFFFFFFFFFFFFFF;
             }
-            Cyber180CMPortWriteWordsPhysical(port, cmAddress, buffer, count);
-            free(buffer);
+            Cyber180CMPortUnmapRange(port, &span);
             return 2;
         } break;
 
@@ -1319,12 +1319,14 @@ CyberWord16 Cyber962PPInstruction_CWx(struct Cyber962PP *processor, union Cyber9
             CyberWord16 m = Cyber962PPReadSingle(processor, processor->_regP + 1);
             CyberWord16 ppmAddress = m & 0xFFFF;
             CyberWord16 count = Cyber962PPReadSingle(processor, d16);
-            CyberWord64 *buffer = calloc(count, sizeof(CyberWord64));
+            assert((cmAddress % 8) == 0); // must be on a word boundary
+            struct Cyber180CMSpan span;
+            Cyber180CMPortMapRange(port, cmAddress, count * sizeof(CyberWord64), Cyber180CMAccess_Write, &span);
+            CyberWord64 *words = (CyberWord64 *)span.bytes;
             for (CyberWord16 i = 0; i < count; i++) {
-                buffer[i] = Cyber962PPReadPPMWord16ToCMWord64(processor, ppmAddress + (i * 4)) & 0xFFFFFFFFFFFFFFFF;
+                words[i] = Cyber962PPReadPPMWord16ToCMWord64(processor, ppmAddress + (i * 4)) & 0xFFFFFFFFFFFFFFFF;
             }
-            Cyber180CMPortWriteWordsPhysical(port, cmAddress, buffer, count);
-            free(buffer);
+            Cyber180CMPortUnmapRange(port, &span);
             return 2;
         } break;
 
@@ -1370,6 +1372,16 @@ CyberWord16 Cyber962PPInstruction_IOJ(struct Cyber962PP *processor, union Cyber9
     return 0;
 }
 
+/// Record an event to the system's timeline, if it's being traced.
+static void Cyber962PPRecordTimelineEvent(struct Cyber962PP *processor, enum CyberTimelineEvent event, uint16_t unit, uint64_t value)
+{
+    struct Cyber962IOU *inputOutputUnit = processor->_inputOutputUnit;
+    struct CyberTrace *trace = Cyber962GetTimelineTrace(inputOutputUnit->_system);
+    if (trace != NULL) {
+        CyberTraceAppendTimelineEvent(trace, CYBER_TRACE_PP_STREAM(inputOutputUnit->_index, processor->_index), event, unit, value, CyberCycleCounterRead(), 0);
+    }
+}
+
 /// Implementation of "I/O Input" instructions.
 CyberWord16 Cyber962PPInstruction_IN(struct Cyber962PP *processor, union Cyber962PPInstructionWord instructionWord)
 {
@@ -1429,9 +1441,11 @@ CyberWord16 Cyber962PPInstruction_CTRL(struct Cyber962PP *processor, union Cyber
 
     switch (opcode) {
         case 00074: { // ACNW c || ACNU c
+            Cyber962PPRecordTimelineEvent(processor, CyberTimelineEventChannelActivate, instructionWord._sc.c, 0);
         } break;
 
         case 00075: { // DCNW c || DCNU c
+            Cyber962PPRecordTimelineEvent(processor, CyberTimelineEventChannelDeactivate, instructionWord._sc.c, 0);
         } break;
 
         case 00076: { // FANW c || FANI c
@@ -1459,11 +1473,26 @@ CyberWord16 Cyber962PPInstruction_PSN(struct Cyber962PP *processor, union Cyber9
 /// Implementation of "Keypoint" instructions.
 CyberWord16 Cyber962PPInstruction_KPT(struct Cyber962PP *processor, union Cyber962PPInstructionWord instructionWord)
 {
-    // Do nothing but set the indicator at `d` and advance P.
+    // Do nothing but set the indicator at `d`, record the keypoint if keypoints are being traced, and advance P.
 
     CyberWord6 d = instructionWord._d.d;
     processor->_keypoints[d] += 1;
 
+    struct Cyber962IOU *inputOutputUnit = processor->_inputOutputUnit;
+    struct CyberTrace *trace = __atomic_load_n(&inputOutputUnit->_system->_keypointTrace, __ATOMIC_ACQUIRE);
+    if ((trace != NULL) && CyberTraceIsEnabled(trace)) {
+        struct CyberKeypointRecord record = {
+            .ticks = CyberCycleCounterRead(),
+            .address = processor->_regP,
+            .code = processor->_regA,
+            .processorKind = CyberTraceProcessorKindPeripheral,
+            .inputOutputUnit = inputOutputUnit->_index,
+            .processorIndex = processor->_index,
+            .keypointClass = d,
+        };
+        (void) CyberTraceAppend(trace, CYBER_TRACE_PP_STREAM(inputOutputUnit->_index, processor->_index), &record, sizeof(record));
+    }
+
     return 1;
 }
 
@@ -1471,6 +1500,8 @@ CyberWord16 Cyber962PPInstruction_EXN(struct Cyber962PP *processor, union Cyber9
 {
     // TODO: Implement Exchange Jump instruction.
 
+    Cyber962PPRecordTimelineEvent(processor, CyberTimelineEventExchange, 0, processor->_regP);
+
     return 1;
 }
 
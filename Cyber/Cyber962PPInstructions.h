@@ -53,7 +53,7 @@ union Cyber962PPInstructionWord {
 ///   - processor: The state for this Peripheral Processor at the start of instruction execution.
 ///   - word: The instruction word itself, for field recovery.
 ///
-/// - Returns: The amount by which to increment `P` after the instruction completes.
+/// - Returns: The amount by which to increment `P` after the instruction completes, modulo 2^16; branches and jumps return the distance to their destination. Instructions don't set `P` themselves, since it's replaced by the old `P` plus this amount.
 typedef CyberWord16 (*Cyber962PPInstruction)(struct Cyber962PP *processor, union Cyber962PPInstructionWord word);
 
 
@@ -19,6 +19,8 @@
 
 #include <Cyber/Cyber962PP.h>
 
+#include "Cyber180CMPort_Internal.h"
+
 #include <stdbool.h>
 #include <pthread.h>
 
@@ -44,13 +46,21 @@ struct Cyber962PP {
     /// The memory for this Peripheral Processor.
     CyberWord16 *_storage;
 
-    /// The thread this Peripheral Processor runs on.
-    struct CyberThread *_thread;
+    /// The thread this Peripheral Processor runs on, or `NULL` when the system runs in lockstep.
+    struct CyberThread * _Nullable _thread;
+
+    /// Whether this Peripheral Processor is running, when the system runs in lockstep.
+    bool _running;
+
+    /// Whether this Peripheral Processor's thread is registered with the system's safepoints.
+    bool _safepointRegistered;
 
     // Registers
+    //
+    // The registers are written on every instruction by the thread running this Peripheral Processor, so they start on a cache line of their own, away from the configuration above that other threads read.
 
     /// Arithmetic Register, 18 bits
-    CyberWord18 _regA;
+    CYBER_PROCESSOR_ALIGNED CyberWord18 _regA;
 
     /// Program Address Register (program counter), 16 bits
     CyberWord16 _regP;
@@ -64,10 +74,25 @@ struct Cyber962PP {
     /// Keypoints.
     int _keypoints[64];
 
+    /// The number of instructions this Peripheral Processor has executed; written only by the thread running it, but may be read from any thread.
+    uint64_t _instructionCount;
+
+#if CYBER_STATISTICS
+    /// Execution statistics for each opcode; written only by the thread running this Peripheral Processor, but may be read from any thread.
+    struct Cyber962PPOpcodeStatistics *_opcodeStatistics;
+#endif
+
+    /// This Peripheral Processor's counts of its accesses through its I/O Unit's Central Memory port, which it shares with the I/O Unit's other Peripheral Processors; written only by the thread running it.
+    struct Cyber180CMPortCounters _centralMemoryCounters;
+
     // FIXME: Flesh out.
 };
 
 
+/// Execute a single instruction.
+CYBER_EXPORT void Cyber962PPSingleStep(struct Cyber962PP *processor);
+
+
 /// Get the "barrel" that a PP is part of. This determines which I/O channels it's allowed to access.
 CYBER_EXPORT int Cyber962PPGetBarrel(struct Cyber962PP *processor);
 
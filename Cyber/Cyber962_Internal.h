@@ -0,0 +1,154 @@
+//
+//  Cyber962_Internal.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/Cyber962.h>
+
+#include "CyberFutex.h"
+#include "CyberTrace_Internal.h"
+
+#include <stdatomic.h>
+
+#ifndef __CYBER_CYBER962_INTERNAL_H__
+#define __CYBER_CYBER962_INTERNAL_H__
+
+CYBER_HEADER_BEGIN
+
+
+struct CyberProfiler;
+struct CyberThreadAttributes;
+
+
+/// A Cyber 962 system.
+///
+/// A Cyber 962 system always consists of:
+/// - One or two Central Processor (CP)
+/// - One Central Memory (CM) containing:
+///   - 32MB (4MW) RAM
+/// - One I/O Unit (IOU) containing:
+///   - 10 CIO (Concurrent I/O) Peripheral Processors
+///   - 8 DMA channels
+///
+/// One or two adaditional IOU can be added with:
+/// - 10-20 CIO PP
+/// - 10-20 DMA channels
+///
+/// The CM can be expanded to the following sizes:
+/// - 64MB (8MW)
+/// - 128MB (16MW)
+/// - 192MB (24MW)
+/// - 256MB (32MW)
+///
+/// Larger CM sizes, in multiples of 64MB (8MW), are supported for testing large-memory configurations like those of Cyber 990-class systems; these use sparse storage.
+struct Cyber962 {
+    /// The Central Memory in this system.
+    struct Cyber180CM *_centralMemory;
+
+    /// The one or two Central Processors in this system.
+    struct Cyber180CP * _Nullable _centralProcessors[2];
+
+    /// The I/O Units in this system.
+    struct Cyber962IOU * _Nullable _inputOutputUnits[3];
+
+    /// The trace that guest keypoints are recorded to, created the first time tracing starts; processors load it atomically.
+    struct CyberTrace * _Nullable _keypointTrace;
+
+    /// The trace that Central Processor instructions are recorded to, created the first time tracing starts; processors load it atomically.
+    struct CyberTrace * _Nullable _instructionTrace;
+
+    /// The trace that each processor's timeline is recorded to, created the first time tracing starts; processors load it atomically.
+    struct CyberTrace * _Nullable _timelineTrace;
+
+    /// The sampling profiler, while profiling.
+    struct CyberProfiler * _Nullable _profiler;
+
+    /// The human-readable name or identifier of this system.
+    char *_identifier;
+
+    /// The configuration this system was created with.
+    struct Cyber962Configuration _configuration;
+
+    /// The host CPUs each Central Processor's thread may run on, per the placement policy; 0 allows any CPU.
+    uint64_t _centralProcessorCPUMasks[2];
+
+    /// The host CPUs each Peripheral Processor barrel's threads may run on, per the placement policy; 0 allows any CPU.
+    uint64_t _barrelCPUMasks[3][5];
+
+    // Safepoints
+
+    /// The safepoint epoch, which is odd while a pause is requested; processor threads poll it between instructions.
+    ///
+    /// This is on a cache line of its own so that threads parking during a pause don't disturb the threads still polling it.
+    CYBER_PROCESSOR_ALIGNED CyberFutex _safepointEpoch;
+
+    /// The number of processor threads currently running their main loops.
+    CYBER_PROCESSOR_ALIGNED _Atomic uint32_t _safepointRunningThreads;
+
+    /// The number of processor threads currently parked at a safepoint.
+    _Atomic uint32_t _safepointParkedThreads;
+
+    /// A counter bumped whenever a processor thread parks, starts, or stops, which ``Cyber962PauseAll`` waits on.
+    CyberFutex _safepointChanges;
+};
+
+
+/// Get the thread attributes for a Central Processor, according to the system's placement policy.
+CYBER_EXPORT void Cyber962GetCentralProcessorThreadAttributes(struct Cyber962 *system, int index, struct CyberThreadAttributes *attributes);
+
+/// Get the thread attributes for a Peripheral Processor, according to the system's placement policy.
+CYBER_EXPORT void Cyber962GetPeripheralProcessorThreadAttributes(struct Cyber962 *system, int inputOutputUnitIndex, int barrel, struct CyberThreadAttributes *attributes);
+
+
+/// Register the calling processor thread as running, so that ``Cyber962PauseAll`` waits for it to park.
+///
+/// If the system is paused, this waits until it's resumed, so the thread can't record anything to its streams during the pause.
+///
+/// - Warning: Call this from the thread's `start` function, before it executes any instructions or records anything.
+CYBER_EXPORT void Cyber962SafepointEnter(struct Cyber962 *system);
+
+/// Unregister the calling processor thread, so that ``Cyber962PauseAll`` no longer waits for it.
+///
+/// - Warning: Call this from the thread's `stop` or `terminate` function, and only after ``Cyber962SafepointEnter``.
+CYBER_EXPORT void Cyber962SafepointLeave(struct Cyber962 *system);
+
+/// Park the calling processor thread until the system is resumed; the slow path of ``Cyber962SafepointPoll``.
+CYBER_EXPORT void Cyber962SafepointPark(struct Cyber962 *system);
+
+/// Check whether a pause has been requested and, if so, park the calling processor thread until the system is resumed.
+///
+/// This is a single load in the common case, so processor threads call it before every instruction.
+static inline void Cyber962SafepointPoll(struct Cyber962 *system)
+{
+    // This load is sequentially consistent so it pairs with the epoch increment in Cyber962PauseAll; on x86 that's an ordinary load.
+    if (atomic_load_explicit(&system->_safepointEpoch, memory_order_seq_cst) & 1) {
+        Cyber962SafepointPark(system);
+    }
+}
+
+
+/// Get the system's timeline trace if it's collecting records, or `NULL` if it isn't.
+static inline struct CyberTrace * _Nullable Cyber962GetTimelineTrace(struct Cyber962 *system)
+{
+    struct CyberTrace *trace = __atomic_load_n(&system->_timelineTrace, __ATOMIC_ACQUIRE);
+    return ((trace != NULL) && CyberTraceIsEnabled(trace)) ? trace : NULL;
+}
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBER962_INTERNAL_H__ */
@@ -0,0 +1,52 @@
+//
+//  CyberCycleCounter.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberCycleCounter.h"
+
+#include <time.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// Get the monotonic clock in nanoseconds.
+static uint64_t CyberCycleCounterGetNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
+uint64_t CyberCycleCounterGetFrequency(void)
+{
+    const uint64_t startNanoseconds = CyberCycleCounterGetNanoseconds();
+    const uint64_t startCycles = CyberCycleCounterRead();
+
+    const struct timespec interval = { .tv_sec = 0, .tv_nsec = 10000000 };
+    nanosleep(&interval, NULL);
+
+    const uint64_t endCycles = CyberCycleCounterRead();
+    const uint64_t endNanoseconds = CyberCycleCounterGetNanoseconds();
+
+    return (uint64_t)(((double)(endCycles - startCycles) * 1e9) / (double)(endNanoseconds - startNanoseconds));
+}
+
+
+CYBER_SOURCE_END
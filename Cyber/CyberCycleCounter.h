@@ -0,0 +1,59 @@
+//
+//  CyberCycleCounter.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#ifndef __CYBER_CYBERCYCLECOUNTER_H__
+#define __CYBER_CYBERCYCLECOUNTER_H__
+
+CYBER_HEADER_BEGIN
+
+
+/// Read the host's cycle counter: the time stamp counter on x86-64, the virtual counter on ARM64, and otherwise the monotonic clock in nanoseconds.
+static inline uint64_t CyberCycleCounterRead(void)
+{
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cycles;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(cycles));
+    return cycles;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+#endif
+}
+
+
+/// Estimate how many times per second the host's cycle counter ticks, by timing it against the monotonic clock.
+///
+/// - Warning: This takes about 10ms.
+CYBER_EXPORT uint64_t CyberCycleCounterGetFrequency(void);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERCYCLECOUNTER_H__ */
@@ -31,8 +31,45 @@
 #define CYBER_PACKED        __attribute__((packed))
 
 
+/// The size to assume for a host cache line, which is the larger of the common 64-byte x86-64 line and the 128-byte Apple Silicon line.
+#define CYBER_CACHE_LINE_SIZE 128
+
+/// Align a field or type to a host cache line, to keep data written by different threads from sharing one.
+#define CYBER_CACHE_ALIGNED __attribute__((aligned(CYBER_CACHE_LINE_SIZE)))
+
+
+/// Whether to lay out processor state the way it was before each processor got cache lines of its own, with registers packed against the configuration and processors allocated wherever `calloc` would put them. Define this to 1 only to measure what the cache-line layout gains, as `cyberbench-packed` does.
+#ifndef CYBER_PACKED_LAYOUT
+#define CYBER_PACKED_LAYOUT 0
+#endif
+
+/// The alignment of each processor's allocations, and an attribute aligning a field of processor state that one thread writes to a host cache line of its own.
+#if CYBER_PACKED_LAYOUT
+#define CYBER_PROCESSOR_ALIGNMENT   (2 * sizeof(void *))
+#define CYBER_PROCESSOR_ALIGNED
+#else
+#define CYBER_PROCESSOR_ALIGNMENT   CYBER_CACHE_LINE_SIZE
+#define CYBER_PROCESSOR_ALIGNED     CYBER_CACHE_ALIGNED
+#endif
+
+
+/// Whether processors collect per-opcode execution counts and cycle histograms, which costs two reads of the host cycle counter per instruction. Define this to 1 to enable it; otherwise none of the collection is compiled in.
+#ifndef CYBER_STATISTICS
+#define CYBER_STATISTICS 0
+#endif
+
+
+// Nullability annotations are a clang extension, so compile them away elsewhere.
+#if defined(__clang__)
 #define CYBER_NONNULL_BEGIN _Pragma("clang assume_nonnull begin")
 #define CYBER_NONNULL_END   _Pragma("clang assume_nonnull end")
+#else
+#define _Nullable
+#define _Nonnull
+#define _Null_unspecified
+#define CYBER_NONNULL_BEGIN
+#define CYBER_NONNULL_END
+#endif
 
 #define CYBER_HEADER_BEGIN  CYBER_NONNULL_BEGIN
 #define CYBER_HEADER_END    CYBER_NONNULL_END
@@ -0,0 +1,183 @@
+//
+//  CyberFutex.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberFutex.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined(__APPLE__)
+#include <os/os_sync_wait_on_address.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <pthread.h>
+#endif
+
+
+CYBER_SOURCE_BEGIN
+
+
+#if !defined(__APPLE__) && !defined(__linux__)
+
+// MARK: - Fallback
+
+// Hosts without an address-based wait and wake facility get one built from a fixed table of mutexes and condition variables, hashed by futex address. A waiter checks the futex value while holding its bucket's mutex and a waker takes the same mutex before broadcasting, so a wake can't slip in between the check and the wait.
+//
+// Since unrelated futexes can share a bucket, waking always broadcasts; waiters already have to tolerate spurious wakeups.
+
+#define CyberFutexBucketCount 64
+
+struct CyberFutexBucket {
+    pthread_mutex_t _lock;
+    pthread_cond_t _condition;
+};
+
+static struct CyberFutexBucket CyberFutexBuckets[CyberFutexBucketCount];
+static pthread_once_t CyberFutexBucketsOnce = PTHREAD_ONCE_INIT;
+
+
+static void CyberFutexBucketsInitialize(void)
+{
+    for (int i = 0; i < CyberFutexBucketCount; i++) {
+        int lock_err = pthread_mutex_init(&CyberFutexBuckets[i]._lock, NULL);
+        assert(lock_err == 0); // halt here in debug builds
+        (void) lock_err;
+        int condition_err = pthread_cond_init(&CyberFutexBuckets[i]._condition, NULL);
+        assert(condition_err == 0); // halt here in debug builds
+        (void) condition_err;
+    }
+}
+
+
+static struct CyberFutexBucket *CyberFutexGetBucket(CyberFutex *futex)
+{
+    (void) pthread_once(&CyberFutexBucketsOnce, CyberFutexBucketsInitialize);
+
+    uintptr_t address = (uintptr_t)futex;
+    return &CyberFutexBuckets[(address >> 2) % CyberFutexBucketCount];
+}
+
+
+static void CyberFutexWake(CyberFutex *futex)
+{
+    struct CyberFutexBucket *bucket = CyberFutexGetBucket(futex);
+    pthread_mutex_lock(&bucket->_lock);
+    pthread_cond_broadcast(&bucket->_condition);
+    pthread_mutex_unlock(&bucket->_lock);
+}
+
+#endif
+
+
+// MARK: - Waiting and Waking
+
+
+void CyberFutexWait(CyberFutex *futex, uint32_t expectedValue)
+{
+    assert(futex != NULL);
+
+#if defined(__APPLE__)
+    // Errors (EINTR, EFAULT) are treated as spurious wakeups.
+    (void) os_sync_wait_on_address((void *)futex, expectedValue, sizeof(uint32_t), OS_SYNC_WAIT_ON_ADDRESS_NONE);
+#elif defined(__linux__)
+    // Errors (EAGAIN when the value has already changed, EINTR) are treated as spurious wakeups.
+    (void) syscall(SYS_futex, (uint32_t *)futex, FUTEX_WAIT_PRIVATE, expectedValue, NULL, NULL, 0);
+#else
+    struct CyberFutexBucket *bucket = CyberFutexGetBucket(futex);
+    pthread_mutex_lock(&bucket->_lock);
+    if (atomic_load_explicit(futex, memory_order_acquire) == expectedValue) {
+        (void) pthread_cond_wait(&bucket->_condition, &bucket->_lock);
+    }
+    pthread_mutex_unlock(&bucket->_lock);
+#endif
+}
+
+
+bool CyberFutexWaitWithTimeout(CyberFutex *futex, uint32_t expectedValue, uint64_t timeoutNanoseconds)
+{
+    assert(futex != NULL);
+
+#if defined(__APPLE__)
+    int result = os_sync_wait_on_address_with_timeout((void *)futex, expectedValue, sizeof(uint32_t), OS_SYNC_WAIT_ON_ADDRESS_NONE, OS_CLOCK_MACH_ABSOLUTE_TIME, timeoutNanoseconds);
+
+    return !((result == -1) && (errno == ETIMEDOUT));
+#elif defined(__linux__)
+    // FUTEX_WAIT takes a relative timeout.
+    struct timespec timeout = {
+        .tv_sec = (time_t)(timeoutNanoseconds / 1000000000),
+        .tv_nsec = (long)(timeoutNanoseconds % 1000000000),
+    };
+    long result = syscall(SYS_futex, (uint32_t *)futex, FUTEX_WAIT_PRIVATE, expectedValue, &timeout, NULL, 0);
+
+    return !((result == -1) && (errno == ETIMEDOUT));
+#else
+    // pthread_cond_timedwait takes an absolute deadline on the realtime clock.
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    uint64_t nanoseconds = (uint64_t)deadline.tv_nsec + (timeoutNanoseconds % 1000000000);
+    deadline.tv_sec += (time_t)(timeoutNanoseconds / 1000000000) + (time_t)(nanoseconds / 1000000000);
+    deadline.tv_nsec = (long)(nanoseconds % 1000000000);
+
+    struct CyberFutexBucket *bucket = CyberFutexGetBucket(futex);
+    int wait_err = 0;
+    pthread_mutex_lock(&bucket->_lock);
+    if (atomic_load_explicit(futex, memory_order_acquire) == expectedValue) {
+        wait_err = pthread_cond_timedwait(&bucket->_condition, &bucket->_lock, &deadline);
+    }
+    pthread_mutex_unlock(&bucket->_lock);
+
+    return wait_err != ETIMEDOUT;
+#endif
+}
+
+
+void CyberFutexWakeOne(CyberFutex *futex)
+{
+    assert(futex != NULL);
+
+#if defined(__APPLE__)
+    (void) os_sync_wake_by_address_any((void *)futex, sizeof(uint32_t), OS_SYNC_WAKE_BY_ADDRESS_NONE);
+#elif defined(__linux__)
+    (void) syscall(SYS_futex, (uint32_t *)futex, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+    CyberFutexWake(futex);
+#endif
+}
+
+
+void CyberFutexWakeAll(CyberFutex *futex)
+{
+    assert(futex != NULL);
+
+#if defined(__APPLE__)
+    (void) os_sync_wake_by_address_all((void *)futex, sizeof(uint32_t), OS_SYNC_WAKE_BY_ADDRESS_NONE);
+#elif defined(__linux__)
+    (void) syscall(SYS_futex, (uint32_t *)futex, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+    CyberFutexWake(futex);
+#endif
+}
+
+
+CYBER_SOURCE_END
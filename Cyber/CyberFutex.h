@@ -0,0 +1,68 @@
+//
+//  CyberFutex.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#include <stdatomic.h>
+
+#ifndef __CYBER_CYBERFUTEX_H__
+#define __CYBER_CYBERFUTEX_H__
+
+CYBER_HEADER_BEGIN
+
+
+/// A CyberFutex is a 32-bit word that threads can block on until it changes, using the host's address-based wait and wake facility.
+///
+/// Unlike a condition variable, a futex has no lock of its own: A waiter passes the value it last saw and only blocks if the word still holds that value, so a wake that happens between checking a condition and waiting can't be lost.
+typedef _Atomic uint32_t CyberFutex;
+
+
+/// Hint to the host processor that the calling thread is spinning, so it can yield resources to other hardware threads.
+static inline void CyberFutexSpinPause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+
+/// Block while `futex` still contains `expectedValue`.
+///
+/// - Warning: This can return spuriously, so callers must recheck whatever condition they're waiting for.
+CYBER_EXPORT void CyberFutexWait(CyberFutex *futex, uint32_t expectedValue);
+
+/// Block while `futex` still contains `expectedValue`, for at most `timeoutNanoseconds`.
+///
+/// - Returns: `false` if the timeout elapsed, otherwise `true`.
+///
+/// - Warning: This can return spuriously, so callers must recheck whatever condition they're waiting for.
+CYBER_EXPORT bool CyberFutexWaitWithTimeout(CyberFutex *futex, uint32_t expectedValue, uint64_t timeoutNanoseconds);
+
+/// Wake at most one thread blocked on `futex`.
+CYBER_EXPORT void CyberFutexWakeOne(CyberFutex *futex);
+
+/// Wake all threads blocked on `futex`.
+CYBER_EXPORT void CyberFutexWakeAll(CyberFutex *futex);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERFUTEX_H__ */
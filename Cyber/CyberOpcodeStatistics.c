@@ -0,0 +1,76 @@
+//
+//  CyberOpcodeStatistics.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberOpcodeStatistics_Internal.h"
+
+#include <assert.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+bool CyberOpcodeStatisticsAreEnabled(void)
+{
+    return CYBER_STATISTICS;
+}
+
+
+uint64_t CyberOpcodeCounterGetPercentileCycles(const struct CyberOpcodeCounter *counter, double percentile)
+{
+    assert(counter != NULL);
+    assert((percentile >= 0.0) && (percentile <= 100.0));
+
+    uint64_t total = 0;
+    for (int bucket = 0; bucket < CYBER_OPCODE_HISTOGRAM_BUCKETS; bucket++) {
+        total += counter->histogram[bucket];
+    }
+    if (total == 0) return 0;
+
+    // The rank of the percentile among all executions, counting from 1.
+    uint64_t rank = (uint64_t)((percentile / 100.0) * (double)total);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < CYBER_OPCODE_HISTOGRAM_BUCKETS; bucket++) {
+        seen += counter->histogram[bucket];
+        if (seen >= rank) {
+            return (bucket == 0) ? 0 : ((1ULL << bucket) - 1);
+        }
+    }
+
+    return UINT64_MAX;
+}
+
+
+void CyberOpcodeCounterAccumulate(struct CyberOpcodeCounter *sums, const struct CyberOpcodeCounter *counters, int count)
+{
+    assert(sums != NULL);
+    assert(counters != NULL);
+
+    for (int i = 0; i < count; i++) {
+        sums[i].count += __atomic_load_n(&counters[i].count, __ATOMIC_RELAXED);
+        sums[i].cycles += __atomic_load_n(&counters[i].cycles, __ATOMIC_RELAXED);
+        for (int bucket = 0; bucket < CYBER_OPCODE_HISTOGRAM_BUCKETS; bucket++) {
+            sums[i].histogram[bucket] += __atomic_load_n(&counters[i].histogram[bucket], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+
+CYBER_SOURCE_END
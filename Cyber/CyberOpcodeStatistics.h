@@ -0,0 +1,80 @@
+//
+//  CyberOpcodeStatistics.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#ifndef __CYBER_CYBEROPCODESTATISTICS_H__
+#define __CYBER_CYBEROPCODESTATISTICS_H__
+
+CYBER_HEADER_BEGIN
+
+
+/// The number of buckets in an opcode's cycle histogram.
+///
+/// Bucket 0 counts executions that took no measurable host cycles; bucket `b` counts those that took from 2^(b-1) up to 2^b - 1 cycles, and the last bucket also counts anything longer.
+#define CYBER_OPCODE_HISTOGRAM_BUCKETS 32
+
+/// The number of distinct Central Processor opcodes.
+#define CYBER180CP_OPCODE_COUNT 256
+
+/// The number of distinct Peripheral Processor opcodes, indexed by `(g << 6) | f`.
+#define CYBER962PP_OPCODE_COUNT 128
+
+
+/// Execution statistics for a single opcode.
+struct CyberOpcodeCounter {
+
+    /// The number of times the opcode was executed.
+    uint64_t count;
+
+    /// The total number of host cycles spent executing the opcode.
+    uint64_t cycles;
+
+    /// The number of executions in each log-scale range of host cycles.
+    uint64_t histogram[CYBER_OPCODE_HISTOGRAM_BUCKETS];
+};
+
+
+/// Execution statistics for every Central Processor opcode.
+struct Cyber180CPOpcodeStatistics {
+    struct CyberOpcodeCounter opcodes[CYBER180CP_OPCODE_COUNT];
+};
+
+
+/// Execution statistics for every Peripheral Processor opcode.
+struct Cyber962PPOpcodeStatistics {
+    struct CyberOpcodeCounter opcodes[CYBER962PP_OPCODE_COUNT];
+};
+
+
+/// Whether the framework was built to collect opcode statistics, with `CYBER_STATISTICS` defined to 1.
+///
+/// When it wasn't, the functions that get opcode statistics leave them all zero.
+CYBER_EXPORT bool CyberOpcodeStatisticsAreEnabled(void);
+
+
+/// Get the approximate number of host cycles below which `percentile` percent of an opcode's executions completed, from its histogram.
+///
+/// - Returns: The upper bound of the histogram bucket containing the percentile, or 0 if the opcode was never executed.
+CYBER_EXPORT uint64_t CyberOpcodeCounterGetPercentileCycles(const struct CyberOpcodeCounter *counter, double percentile);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBEROPCODESTATISTICS_H__ */
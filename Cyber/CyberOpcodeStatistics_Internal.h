@@ -0,0 +1,59 @@
+//
+//  CyberOpcodeStatistics_Internal.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberOpcodeStatistics.h>
+
+#include "CyberCycleCounter.h"
+
+#ifndef __CYBER_CYBEROPCODESTATISTICS_INTERNAL_H__
+#define __CYBER_CYBEROPCODESTATISTICS_INTERNAL_H__
+
+CYBER_HEADER_BEGIN
+
+
+#if CYBER_STATISTICS
+
+
+/// Record one execution of an opcode that took `cycles` host cycles.
+///
+/// - Warning: Only the thread running a processor may record into its counters; other threads may read them via ``CyberOpcodeCounterAccumulate``.
+static inline void CyberOpcodeCounterRecord(struct CyberOpcodeCounter *counter, uint64_t cycles)
+{
+    int bucket = (cycles == 0) ? 0 : (64 - __builtin_clzll(cycles));
+    if (bucket >= CYBER_OPCODE_HISTOGRAM_BUCKETS) {
+        bucket = CYBER_OPCODE_HISTOGRAM_BUCKETS - 1;
+    }
+
+    // Only this thread writes the counters, so they don't need atomic increments, just stores other threads can read whole.
+    __atomic_store_n(&counter->count, counter->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&counter->cycles, counter->cycles + cycles, __ATOMIC_RELAXED);
+    __atomic_store_n(&counter->histogram[bucket], counter->histogram[bucket] + 1, __ATOMIC_RELAXED);
+}
+
+
+#endif /* CYBER_STATISTICS */
+
+
+/// Add `count` counters being recorded by another thread into `sums`.
+CYBER_EXPORT void CyberOpcodeCounterAccumulate(struct CyberOpcodeCounter *sums, const struct CyberOpcodeCounter *counters, int count);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBEROPCODESTATISTICS_INTERNAL_H__ */
@@ -0,0 +1,562 @@
+//
+//  CyberProfile.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberProfile_Internal.h"
+
+#include <Cyber/CyberThread.h>
+
+#include "Cyber180CP_Internal.h"
+#include "Cyber962IOU_Internal.h"
+#include "Cyber962PP_Internal.h"
+#include "Cyber962_Internal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The number of entries a profile starts out with room for, a power of two.
+#define CYBER_PROFILE_INITIAL_CAPACITY 1024
+
+
+/// A sampling profiler, which runs on a thread of its own.
+struct CyberProfiler {
+
+    /// The system being profiled.
+    struct Cyber962 *_system;
+
+    /// The profile the samples are added to; only the profiler's thread touches it while it runs.
+    struct CyberProfile *_profile;
+
+    /// The thread taking the samples.
+    struct CyberThread * _Nullable _thread;
+
+    /// The time between samples.
+    uint64_t _intervalNanoseconds;
+
+    /// When profiling started, on the monotonic clock.
+    uint64_t _startNanoseconds;
+
+    /// When the next sample is due, on the monotonic clock.
+    uint64_t _nextSampleNanoseconds;
+};
+
+
+/// A name for the guest code starting at an address.
+struct CyberSymbol {
+
+    /// The first address the name covers.
+    uint64_t address;
+
+    /// The offset of the name in the map's names.
+    size_t nameOffset;
+};
+
+
+/// A symbol map, sorted by address.
+struct CyberSymbolMap {
+
+    /// The symbols, sorted by address.
+    struct CyberSymbol *_symbols;
+
+    /// The number of symbols.
+    size_t _count;
+
+    /// The NUL-terminated names of the symbols, one after another.
+    char *_names;
+};
+
+
+static void CyberProfilerLoop(struct CyberThread *thread, void * _Nullable profilerv);
+
+
+// MARK: - Profiles
+
+/// Create an empty profile.
+static struct CyberProfile * _Nullable CyberProfileCreate(void)
+{
+    struct CyberProfile *profile = calloc(1, sizeof(struct CyberProfile));
+    if (profile == NULL) {
+        return NULL;
+    }
+
+    profile->_capacity = CYBER_PROFILE_INITIAL_CAPACITY;
+    profile->_entries = calloc(profile->_capacity, sizeof(struct CyberProfileEntry));
+    if (profile->_entries == NULL) {
+        free(profile);
+        return NULL;
+    }
+
+    return profile;
+}
+
+
+void CyberProfileDispose(struct CyberProfile * _Nullable profile)
+{
+    if (profile == NULL) return;
+
+    free(profile->_entries);
+    free(profile);
+}
+
+
+/// Get the hash table slot an entry's probe starts at.
+static inline size_t CyberProfileGetSlot(const struct CyberProfile *profile, uint64_t processor, uint64_t address)
+{
+    // Instructions are 2 or 4 bytes long, so mix the address before masking or half the slots would go unused.
+    uint64_t hash = (address ^ (processor << 48)) * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(hash >> 32) & (profile->_capacity - 1);
+}
+
+/// Pack an entry's processor into a single value for hashing and comparison.
+static inline uint64_t CyberProfileGetProcessor(const struct CyberProfileEntry *entry)
+{
+    return ((uint64_t)entry->processorKind << 16) | ((uint64_t)entry->inputOutputUnit << 8) | (uint64_t)entry->processorIndex;
+}
+
+
+/// Double the size of a profile's hash table.
+///
+/// - Returns: `true` on success, or `false` if the larger table couldn't be allocated.
+static bool CyberProfileGrow(struct CyberProfile *profile)
+{
+    struct CyberProfileEntry *oldEntries = profile->_entries;
+    const size_t oldCapacity = profile->_capacity;
+
+    struct CyberProfileEntry *entries = calloc(oldCapacity * 2, sizeof(struct CyberProfileEntry));
+    if (entries == NULL) {
+        return false;
+    }
+    profile->_entries = entries;
+    profile->_capacity = oldCapacity * 2;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldEntries[i].samples == 0) continue;
+
+        size_t slot = CyberProfileGetSlot(profile, CyberProfileGetProcessor(&oldEntries[i]), oldEntries[i].address);
+        while (entries[slot].samples != 0) {
+            slot = (slot + 1) & (profile->_capacity - 1);
+        }
+        entries[slot] = oldEntries[i];
+    }
+
+    free(oldEntries);
+    return true;
+}
+
+
+/// Add a sample that found a processor at `address`.
+static void CyberProfileAddSample(struct CyberProfile *profile, enum CyberTraceProcessorKind kind, int inputOutputUnit, int index, uint64_t address)
+{
+    assert(!profile->_sorted);
+
+    // Keep the table no more than half full so probes stay short; if it can't grow, the sample is lost.
+    if (((profile->_count + 1) * 2) > profile->_capacity) {
+        if (!CyberProfileGrow(profile)) return;
+    }
+
+    const struct CyberProfileEntry key = {
+        .address = address,
+        .processorKind = kind,
+        .inputOutputUnit = (uint8_t)inputOutputUnit,
+        .processorIndex = (uint8_t)index,
+    };
+    const uint64_t processor = CyberProfileGetProcessor(&key);
+
+    size_t slot = CyberProfileGetSlot(profile, processor, address);
+    for (;;) {
+        struct CyberProfileEntry *entry = &profile->_entries[slot];
+        if (entry->samples == 0) {
+            *entry = key;
+            entry->samples = 1;
+            profile->_count += 1;
+            break;
+        }
+        if ((entry->address == address) && (CyberProfileGetProcessor(entry) == processor)) {
+            entry->samples += 1;
+            break;
+        }
+        slot = (slot + 1) & (profile->_capacity - 1);
+    }
+
+    profile->_samples += 1;
+}
+
+
+/// Order profile entries by processor and then by address.
+static int CyberProfileCompareEntries(const void *av, const void *bv)
+{
+    const struct CyberProfileEntry *a = av;
+    const struct CyberProfileEntry *b = bv;
+    const uint64_t aProcessor = CyberProfileGetProcessor(a);
+    const uint64_t bProcessor = CyberProfileGetProcessor(b);
+
+    if (aProcessor != bProcessor) return (aProcessor < bProcessor) ? -1 : 1;
+    if (a->address != b->address) return (a->address < b->address) ? -1 : 1;
+    return 0;
+}
+
+/// Turn a profile's hash table into a sorted array of its entries.
+static void CyberProfileSort(struct CyberProfile *profile)
+{
+    size_t used = 0;
+    for (size_t i = 0; i < profile->_capacity; i++) {
+        if (profile->_entries[i].samples != 0) {
+            profile->_entries[used++] = profile->_entries[i];
+        }
+    }
+    assert(used == profile->_count);
+
+    qsort(profile->_entries, used, sizeof(struct CyberProfileEntry), CyberProfileCompareEntries);
+    profile->_sorted = true;
+}
+
+
+uint64_t CyberProfileGetSampleCount(struct CyberProfile *profile)
+{
+    assert(profile != NULL);
+
+    return profile->_samples;
+}
+
+
+double CyberProfileGetSeconds(struct CyberProfile *profile)
+{
+    assert(profile != NULL);
+
+    return profile->_seconds;
+}
+
+
+const struct CyberProfileEntry *CyberProfileGetEntries(struct CyberProfile *profile, size_t *count)
+{
+    assert(profile != NULL);
+    assert(profile->_sorted);
+    assert(count != NULL);
+
+    *count = profile->_count;
+    return profile->_entries;
+}
+
+
+// MARK: - Profilers
+
+/// Get the current value of the monotonic clock in nanoseconds.
+static uint64_t CyberProfilerGetNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
+struct CyberProfiler * _Nullable CyberProfilerStart(struct Cyber962 *system, double samplesPerSecond)
+{
+    assert(system != NULL);
+    assert(samplesPerSecond > 0);
+
+    struct CyberProfiler *profiler = calloc(1, sizeof(struct CyberProfiler));
+    if (profiler == NULL) {
+        return NULL;
+    }
+
+    profiler->_system = system;
+    profiler->_profile = CyberProfileCreate();
+    if (profiler->_profile == NULL) {
+        free(profiler);
+        return NULL;
+    }
+
+    const double interval = 1e9 / samplesPerSecond;
+    profiler->_intervalNanoseconds = (interval >= 1.0) ? (uint64_t)interval : 1;
+
+    struct CyberThreadFunctions functions = { .loop = CyberProfilerLoop };
+    profiler->_thread = CyberThreadCreate("Profiler", &functions, profiler);
+    if (profiler->_thread == NULL) {
+        CyberProfileDispose(profiler->_profile);
+        free(profiler);
+        return NULL;
+    }
+
+    profiler->_startNanoseconds = CyberProfilerGetNanoseconds();
+    profiler->_nextSampleNanoseconds = profiler->_startNanoseconds;
+    CyberThreadStart(profiler->_thread);
+
+    return profiler;
+}
+
+
+struct CyberProfile * _Nullable CyberProfilerStop(struct CyberProfiler *profiler)
+{
+    assert(profiler != NULL);
+
+    // Once the thread has exited, the profile is this thread's alone.
+    CyberThreadDispose(profiler->_thread);
+
+    struct CyberProfile *profile = profiler->_profile;
+    profile->_seconds = (double)(CyberProfilerGetNanoseconds() - profiler->_startNanoseconds) / 1e9;
+    CyberProfileSort(profile);
+
+    free(profiler);
+    return profile;
+}
+
+
+/// Whether a processor is executing instructions: its thread is running its main loop or, in lockstep mode, the system is stepping it.
+static inline bool CyberProfilerIsRunning(struct CyberThread * _Nullable thread, bool *safepointRegistered, bool *running)
+{
+    return (thread != NULL) ? __atomic_load_n(safepointRegistered, __ATOMIC_RELAXED) : __atomic_load_n(running, __ATOMIC_RELAXED);
+}
+
+
+/// Take one sample of every running processor.
+static void CyberProfilerSample(struct CyberProfiler *profiler)
+{
+    struct Cyber962 *system = profiler->_system;
+    struct CyberProfile *profile = profiler->_profile;
+
+    // Processors parked at a safepoint aren't executing guest code.
+    if (Cyber962IsPaused(system)) return;
+
+    // Each processor writes its P with plain stores, but a load of an aligned word is never torn, so every sample is an address the processor really was at.
+    for (int cp = 0; cp < 2; cp++) {
+        struct Cyber180CP *centralProcessor = system->_centralProcessors[cp];
+        if ((centralProcessor == NULL) || !CyberProfilerIsRunning(centralProcessor->_thread, &centralProcessor->_safepointRegistered, &centralProcessor->_running)) continue;
+
+        CyberWord64 address = __atomic_load_n(&centralProcessor->_regP, __ATOMIC_RELAXED);
+        CyberProfileAddSample(profile, CyberTraceProcessorKindCentral, 0, cp, address);
+    }
+
+    for (int iou = 0; iou < 3; iou++) {
+        struct Cyber962IOU *inputOutputUnit = system->_inputOutputUnits[iou];
+        if (inputOutputUnit == NULL) continue;
+
+        for (int pp = 0; pp < 20; pp++) {
+            struct Cyber962PP *peripheralProcessor = __atomic_load_n(&inputOutputUnit->_peripheralProcessors[pp], __ATOMIC_ACQUIRE);
+            if ((peripheralProcessor == NULL) || !CyberProfilerIsRunning(peripheralProcessor->_thread, &peripheralProcessor->_safepointRegistered, &peripheralProcessor->_running)) continue;
+
+            CyberWord16 address = __atomic_load_n(&peripheralProcessor->_regP, __ATOMIC_RELAXED);
+            CyberProfileAddSample(profile, CyberTraceProcessorKindPeripheral, iou, pp, address);
+        }
+    }
+}
+
+
+static void CyberProfilerLoop(struct CyberThread *thread, void * _Nullable profilerv)
+{
+    struct CyberProfiler *profiler = (struct CyberProfiler *)profilerv;
+    assert(profiler != NULL);
+
+    CyberProfilerSample(profiler);
+
+    // Schedule each sample from when the last was due rather than when it was taken, so the rate doesn't drift; if sampling has fallen behind, skip ahead rather than catching up in a burst.
+    profiler->_nextSampleNanoseconds += profiler->_intervalNanoseconds;
+    const uint64_t now = CyberProfilerGetNanoseconds();
+    if (profiler->_nextSampleNanoseconds > now) {
+        const uint64_t delay = profiler->_nextSampleNanoseconds - now;
+        const struct timespec interval = { .tv_sec = (time_t)(delay / 1000000000ULL), .tv_nsec = (long)(delay % 1000000000ULL) };
+        nanosleep(&interval, NULL);
+    } else {
+        profiler->_nextSampleNanoseconds = now;
+    }
+}
+
+
+// MARK: - Symbol Maps
+
+/// Order symbols by address, keeping symbols at the same address in the order they were read.
+static int CyberSymbolMapCompareSymbols(const void *av, const void *bv)
+{
+    const struct CyberSymbol *a = av;
+    const struct CyberSymbol *b = bv;
+
+    if (a->address != b->address) return (a->address < b->address) ? -1 : 1;
+    if (a->nameOffset != b->nameOffset) return (a->nameOffset < b->nameOffset) ? -1 : 1;
+    return 0;
+}
+
+
+/// Parse one line of a symbol map into an address and the bounds of a name within the line.
+///
+/// - Returns: `true` if the line holds a symbol, or `false` if it's blank, a comment, or malformed, with `*malformed` set for the last.
+static bool CyberSymbolMapParseLine(char *line, uint64_t *address, char * _Nonnull * _Nonnull name, size_t *nameLength, bool *malformed)
+{
+    *malformed = false;
+
+    char *c = line;
+    while ((*c == ' ') || (*c == '\t')) c++;
+    if ((*c == '\0') || (*c == '\n') || (*c == '\r') || (*c == '#')) return false;
+
+    int base = 16;
+    if ((c[0] == '0') && (c[1] == 'o')) {
+        base = 8;
+        c += 2;
+    }
+
+    char *end = NULL;
+    *address = strtoull(c, &end, base);
+    if ((end == c) || ((*end != ' ') && (*end != '\t'))) {
+        *malformed = true;
+        return false;
+    }
+
+    c = end;
+    while ((*c == ' ') || (*c == '\t')) c++;
+
+    // The name is the rest of the line, so it may have spaces in it.
+    size_t length = strlen(c);
+    while ((length > 0) && ((c[length - 1] == '\n') || (c[length - 1] == '\r') || (c[length - 1] == ' ') || (c[length - 1] == '\t'))) {
+        length--;
+    }
+    if (length == 0) {
+        *malformed = true;
+        return false;
+    }
+
+    *name = c;
+    *nameLength = length;
+    return true;
+}
+
+
+struct CyberSymbolMap * _Nullable CyberSymbolMapCreateWithFile(const char *path)
+{
+    assert(path != NULL);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    struct CyberSymbolMap *map = calloc(1, sizeof(struct CyberSymbolMap));
+    size_t symbolCapacity = 0;
+    size_t namesLength = 0;
+    size_t namesCapacity = 0;
+    bool failed = (map == NULL);
+
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    while (!failed && (getline(&line, &lineCapacity, file) != -1)) {
+        uint64_t address;
+        char *name;
+        size_t nameLength;
+        bool malformed;
+        if (!CyberSymbolMapParseLine(line, &address, &name, &nameLength, &malformed)) {
+            failed = malformed;
+            continue;
+        }
+
+        if (map->_count == symbolCapacity) {
+            symbolCapacity = (symbolCapacity == 0) ? 256 : (symbolCapacity * 2);
+            struct CyberSymbol *symbols = realloc(map->_symbols, symbolCapacity * sizeof(struct CyberSymbol));
+            if (symbols == NULL) {
+                failed = true;
+                break;
+            }
+            map->_symbols = symbols;
+        }
+
+        if ((namesLength + nameLength + 1) > namesCapacity) {
+            while ((namesLength + nameLength + 1) > namesCapacity) {
+                namesCapacity = (namesCapacity == 0) ? 4096 : (namesCapacity * 2);
+            }
+            char *names = realloc(map->_names, namesCapacity);
+            if (names == NULL) {
+                failed = true;
+                break;
+            }
+            map->_names = names;
+        }
+
+        memcpy(&map->_names[namesLength], name, nameLength);
+        map->_names[namesLength + nameLength] = '\0';
+
+        map->_symbols[map->_count] = (struct CyberSymbol){ .address = address, .nameOffset = namesLength };
+        map->_count += 1;
+        namesLength += nameLength + 1;
+    }
+
+    failed = failed || (ferror(file) != 0);
+    free(line);
+    fclose(file);
+
+    if (failed) {
+        CyberSymbolMapDispose(map);
+        return NULL;
+    }
+
+    if (map->_count > 0) {
+        qsort(map->_symbols, map->_count, sizeof(struct CyberSymbol), CyberSymbolMapCompareSymbols);
+    }
+
+    return map;
+}
+
+
+void CyberSymbolMapDispose(struct CyberSymbolMap * _Nullable map)
+{
+    if (map == NULL) return;
+
+    free(map->_symbols);
+    free(map->_names);
+    free(map);
+}
+
+
+size_t CyberSymbolMapGetCount(struct CyberSymbolMap *map)
+{
+    assert(map != NULL);
+
+    return map->_count;
+}
+
+
+const char * _Nullable CyberSymbolMapLookup(struct CyberSymbolMap *map, uint64_t address, uint64_t * _Nullable offset)
+{
+    assert(map != NULL);
+
+    // Find the last symbol at or before the address; of several at the same address, the last one read wins.
+    size_t low = 0;
+    size_t high = map->_count;
+    while (low < high) {
+        size_t middle = low + ((high - low) / 2);
+        if (map->_symbols[middle].address <= address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == 0) {
+        return NULL;
+    }
+
+    const struct CyberSymbol *symbol = &map->_symbols[low - 1];
+    if (offset != NULL) {
+        *offset = address - symbol->address;
+    }
+    return &map->_names[symbol->nameOffset];
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,89 @@
+//
+//  CyberProfile.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+#include <Cyber/CyberTrace.h>
+
+#ifndef __CYBER_CYBERPROFILE_H__
+#define __CYBER_CYBERPROFILE_H__
+
+CYBER_HEADER_BEGIN
+
+
+struct CyberProfile;
+struct CyberSymbolMap;
+
+
+/// The number of samples that found one processor at one address.
+struct CyberProfileEntry {
+
+    /// The address of the instruction the processor was executing, `P`.
+    uint64_t address;
+
+    /// The number of samples that found the processor there.
+    uint64_t samples;
+
+    /// The kind of processor, a ``CyberTraceProcessorKind``.
+    uint8_t processorKind;
+
+    /// The I/O Unit of a Peripheral Processor; 0 for a Central Processor.
+    uint8_t inputOutputUnit;
+
+    /// The index of the processor, within its I/O Unit for a Peripheral Processor.
+    uint8_t processorIndex;
+};
+
+
+/// Dispose of a profile.
+CYBER_EXPORT void CyberProfileDispose(struct CyberProfile * _Nullable profile);
+
+/// Get the number of samples in a profile, across all processors.
+CYBER_EXPORT uint64_t CyberProfileGetSampleCount(struct CyberProfile *profile);
+
+/// Get how long a profile was collected for, in seconds.
+CYBER_EXPORT double CyberProfileGetSeconds(struct CyberProfile *profile);
+
+/// Get the entries of a profile, ordered by processor (Central Processors first, then each I/O Unit's Peripheral Processors) and then by address.
+///
+/// - Returns: The entries, which belong to the profile, with their number in `count`.
+CYBER_EXPORT const struct CyberProfileEntry *CyberProfileGetEntries(struct CyberProfile *profile, size_t *count);
+
+
+/// Load a symbol map, which names the guest code at each address, from the file at `path`.
+///
+/// Each line of the file is an address followed by whitespace and a name; the address is hexadecimal, with or without a `0x` prefix, or octal with a `0o` prefix. Blank lines and lines starting with `#` are ignored. Each name covers the addresses from its own up to the next one's, so code that's loaded in overlays needs a map for each overlay.
+///
+/// - Returns: The map, or `NULL` if the file can't be read or has a line that isn't an address and a name.
+CYBER_EXPORT struct CyberSymbolMap * _Nullable CyberSymbolMapCreateWithFile(const char *path);
+
+/// Dispose of a symbol map.
+CYBER_EXPORT void CyberSymbolMapDispose(struct CyberSymbolMap * _Nullable map);
+
+/// Get the number of symbols in a map.
+CYBER_EXPORT size_t CyberSymbolMapGetCount(struct CyberSymbolMap *map);
+
+/// Look up the name covering `address`.
+///
+/// - Returns: The name, which belongs to the map, with the distance from its address in `offset` if that's non-`NULL`; or `NULL` if `address` is before the first symbol.
+CYBER_EXPORT const char * _Nullable CyberSymbolMapLookup(struct CyberSymbolMap *map, uint64_t address, uint64_t * _Nullable offset);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERPROFILE_H__ */
@@ -0,0 +1,68 @@
+//
+//  CyberProfile_Internal.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberProfile.h>
+
+#ifndef __CYBER_CYBERPROFILE_INTERNAL_H__
+#define __CYBER_CYBERPROFILE_INTERNAL_H__
+
+CYBER_HEADER_BEGIN
+
+
+struct Cyber962;
+struct CyberProfiler;
+
+
+/// A profile: the number of samples that found each processor at each address.
+struct CyberProfile {
+
+    /// The entries: an open-addressed hash table while samples are being added, with unused entries having no samples, and then the used entries, sorted.
+    struct CyberProfileEntry *_entries;
+
+    /// The number of entries allocated.
+    size_t _capacity;
+
+    /// The number of entries used.
+    size_t _count;
+
+    /// Whether the entries have been sorted, after which no more samples can be added.
+    bool _sorted;
+
+    /// The number of samples added.
+    uint64_t _samples;
+
+    /// How long the profile was collected for, in seconds.
+    double _seconds;
+};
+
+
+/// Start a thread that samples where each of a system's running processors is executing `samplesPerSecond` times a second, without stopping them.
+///
+/// - Returns: The profiler, or `NULL` if it couldn't be started.
+CYBER_EXPORT struct CyberProfiler * _Nullable CyberProfilerStart(struct Cyber962 *system, double samplesPerSecond);
+
+/// Stop a profiler, disposing of it.
+///
+/// - Returns: The profile of the samples it took, which the caller must dispose of, or `NULL` if it couldn't be allocated.
+CYBER_EXPORT struct CyberProfile * _Nullable CyberProfilerStop(struct CyberProfiler *profiler);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERPROFILE_INTERNAL_H__ */
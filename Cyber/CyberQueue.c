@@ -17,33 +17,67 @@
 //  limitations under the License.
 //
 
+
 #include "CyberQueue_Internal.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 
 CYBER_SOURCE_BEGIN
 
 
+/// Wait for an event if `q` still satisfies `predicate`, which is how a thread sleeps until a queue is no longer empty or full.
+///
+/// - Returns: `false` if `timeoutNanoseconds` elapsed, otherwise `true`; pass `UINT64_MAX` to wait indefinitely.
+static bool CyberQueueEventAwait(struct CyberQueueEvent *event, struct CyberQueue *q, bool (*predicate)(struct CyberQueue *q), uint64_t timeoutNanoseconds);
+
+/// Signal an event on behalf of `count` changes, waking a waiter if there are any.
+static void CyberQueueEventSignal(struct CyberQueueEvent *event, size_t count);
+
+/// Whether a queue looks empty.
+static bool CyberQueueIsEmpty(struct CyberQueue *q);
+
+/// Whether a queue looks full.
+static bool CyberQueueIsFull(struct CyberQueue *q);
+
+/// Get the current value of the monotonic clock in nanoseconds.
+static uint64_t CyberQueueGetTimeNanoseconds(void);
+
+
 struct CyberQueue * _Nullable CyberQueueCreate(void)
 {
-    struct CyberQueue *q = calloc(1, sizeof(struct CyberQueue));
+    return CyberQueueCreateWithCapacity(CYBER_QUEUE_DEFAULT_CAPACITY);
+}
 
-    int mutex_err = pthread_mutex_init(&q->_lock, NULL);
-    if (mutex_err != 0) {
-        assert(mutex_err != 0); // halt here in debug builds
-        CyberQueueDispose(q);
+struct CyberQueue * _Nullable CyberQueueCreateWithCapacity(size_t capacity)
+{
+    assert(capacity >= 2);
+    assert((capacity & (capacity - 1)) == 0); // must be a power of two
+
+    struct CyberQueue *q = NULL;
+    int alloc_err = posix_memalign((void **)&q, CYBER_CACHE_LINE_SIZE, sizeof(struct CyberQueue));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
         return NULL;
     }
+    memset(q, 0, sizeof(struct CyberQueue));
 
-    int cond_err = pthread_cond_init(&q->_condition, NULL);
-    if (cond_err != 0) {
-        assert(cond_err != 0); // halt here in debug builds
+    q->_cells = calloc(capacity, sizeof(struct CyberQueueCell));
+    if (q->_cells == NULL) {
+        assert(q->_cells != NULL); // halt here in debug builds
         CyberQueueDispose(q);
         return NULL;
     }
 
+    q->_mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&q->_cells[i]._sequence, i);
+    }
+
     return q;
 }
 
@@ -51,87 +85,264 @@ void CyberQueueDispose(struct CyberQueue * _Nullable q)
 {
     if (q == NULL) return;
 
-    (void) pthread_mutex_destroy(&q->_lock);
-    (void) pthread_cond_destroy(&q->_condition);
-
+    free(q->_cells);
     free(q);
 }
 
 
-void CyberQueueEnqueue(struct CyberQueue *q, void *element)
+size_t CyberQueueTryEnqueueMany(struct CyberQueue *q, void * _Nonnull const * _Nonnull elements, size_t count)
 {
     assert(q != NULL);
-    assert(element != NULL);
+    assert(elements != NULL);
+
+    size_t available = 0;
+    size_t position = atomic_load_explicit(&q->_enqueuePosition, memory_order_relaxed);
+
+    for (;;) {
+        // Count the run of empty cells starting at the position, stopping at the first one that's still full.
+        available = 0;
+        while (available < count) {
+            struct CyberQueueCell *cell = &q->_cells[(position + available) & q->_mask];
+            size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + available);
+
+            if (difference != 0) {
+                if ((difference > 0) && (available == 0)) {
+                    // Another producer claimed the first cell, so the position is stale.
+                    available = SIZE_MAX;
+                }
+                break;
+            }
+
+            available += 1;
+        }
 
-    // Items are enqueued at the head, dequeued at the tail.
+        if (available == SIZE_MAX) {
+            position = atomic_load_explicit(&q->_enqueuePosition, memory_order_relaxed);
+        } else if (available == 0) {
+            // The first cell still holds the element from a lap ago, so the queue is full.
+            return 0;
+        } else if (atomic_compare_exchange_weak_explicit(&q->_enqueuePosition, &position, position + available, memory_order_relaxed, memory_order_relaxed)) {
+            // The whole run is now ours.
+            break;
+        }
+    }
 
-    struct CyberQueueElement *qe = calloc(1, sizeof(struct CyberQueueElement));
-    assert(qe != NULL);
+    for (size_t i = 0; i < available; i++) {
+        assert(elements[i] != NULL);
 
-    qe->_payload = element;
+        struct CyberQueueCell *cell = &q->_cells[(position + i) & q->_mask];
+        cell->_payload = elements[i];
+        atomic_store_explicit(&cell->_sequence, position + i + 1, memory_order_release);
+    }
 
-    pthread_mutex_lock(&q->_lock); {
-        qe->_next = q->_head;
-        qe->_previous = NULL;
+    CyberQueueEventSignal(&q->_notEmpty, available);
 
-        q->_head = qe;
-        if (q->_tail == NULL) q->_tail = qe;
-        if (qe->_next != NULL) qe->_next->_previous = qe;
+    return available;
+}
 
-        (void) pthread_cond_signal(&q->_condition);
-    } pthread_mutex_unlock(&q->_lock);
+bool CyberQueueTryEnqueue(struct CyberQueue *q, void *element)
+{
+    return CyberQueueTryEnqueueMany(q, &element, 1) == 1;
 }
 
-void *CyberQueueDequeue(struct CyberQueue *q)
+void CyberQueueEnqueueMany(struct CyberQueue *q, void * _Nonnull const * _Nonnull elements, size_t count)
 {
     assert(q != NULL);
+    assert(elements != NULL);
 
-    struct CyberQueueElement *qe = NULL;
+    size_t enqueued = 0;
 
-    pthread_mutex_lock(&q->_lock); {
-        while (qe == NULL) {
-            pthread_cond_wait(&q->_condition, &q->_lock);
-            qe = q->_tail;
+    while (enqueued < count) {
+        size_t added = CyberQueueTryEnqueueMany(q, &elements[enqueued], count - enqueued);
+        if (added == 0) {
+            (void) CyberQueueEventAwait(&q->_notFull, q, CyberQueueIsFull, UINT64_MAX);
         }
+        enqueued += added;
+    }
+}
 
-        q->_tail = qe->_previous;
-        if (qe->_previous != NULL) qe->_previous->_next = NULL;
-    } pthread_mutex_unlock(&q->_lock);
+void CyberQueueEnqueue(struct CyberQueue *q, void *element)
+{
+    CyberQueueEnqueueMany(q, &element, 1);
+}
 
-    void *result = qe->_payload;
-    free(qe);
+size_t CyberQueueTryDequeueMany(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount)
+{
+    assert(q != NULL);
+    assert(elements != NULL);
+
+    size_t available = 0;
+    size_t position = atomic_load_explicit(&q->_dequeuePosition, memory_order_relaxed);
+
+    for (;;) {
+        // Count the run of full cells starting at the position, stopping at the first one that's not filled yet.
+        available = 0;
+        while (available < maxCount) {
+            struct CyberQueueCell *cell = &q->_cells[(position + available) & q->_mask];
+            size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + available + 1);
+
+            if (difference != 0) {
+                if ((difference > 0) && (available == 0)) {
+                    // Another consumer claimed the first cell, so the position is stale.
+                    available = SIZE_MAX;
+                }
+                break;
+            }
+
+            available += 1;
+        }
 
-    return result;
+        if (available == SIZE_MAX) {
+            position = atomic_load_explicit(&q->_dequeuePosition, memory_order_relaxed);
+        } else if (available == 0) {
+            // The first cell hasn't been filled yet, so the queue is empty.
+            return 0;
+        } else if (atomic_compare_exchange_weak_explicit(&q->_dequeuePosition, &position, position + available, memory_order_relaxed, memory_order_relaxed)) {
+            // The whole run is now ours.
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < available; i++) {
+        struct CyberQueueCell *cell = &q->_cells[(position + i) & q->_mask];
+        elements[i] = cell->_payload;
+        cell->_payload = NULL;
+        atomic_store_explicit(&cell->_sequence, position + i + q->_mask + 1, memory_order_release);
+    }
+
+    CyberQueueEventSignal(&q->_notFull, available);
+
+    return available;
 }
 
 void * _Nullable CyberQueueTryDequeue(struct CyberQueue *q)
+{
+    void *result = NULL;
+
+    return (CyberQueueTryDequeueMany(q, &result, 1) == 1) ? result : NULL;
+}
+
+size_t CyberQueueDequeueMany(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount)
+{
+    return CyberQueueDequeueManyWithTimeout(q, elements, maxCount, UINT64_MAX);
+}
+
+size_t CyberQueueDequeueManyWithTimeout(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount, uint64_t timeoutNanoseconds)
 {
     assert(q != NULL);
+    assert(elements != NULL);
+    assert(maxCount > 0);
 
-    struct CyberQueueElement *qe = NULL;
+    uint64_t deadline = UINT64_MAX;
+    if (timeoutNanoseconds != UINT64_MAX) {
+        deadline = CyberQueueGetTimeNanoseconds() + timeoutNanoseconds;
+    }
 
-    if (pthread_mutex_trylock(&q->_lock) == 0) {
-        qe = q->_tail;
+    size_t dequeued;
 
-        if (qe) {
-            q->_tail = qe->_previous;
-            if (qe->_previous != NULL) qe->_previous->_next = NULL;
+    while ((dequeued = CyberQueueTryDequeueMany(q, elements, maxCount)) == 0) {
+        uint64_t remaining = UINT64_MAX;
+        if (deadline != UINT64_MAX) {
+            uint64_t now = CyberQueueGetTimeNanoseconds();
+            if (now >= deadline) break;
+            remaining = deadline - now;
         }
 
-        pthread_mutex_unlock(&q->_lock);
+        (void) CyberQueueEventAwait(&q->_notEmpty, q, CyberQueueIsEmpty, remaining);
     }
 
-    void *result;
+    return dequeued;
+}
 
-    if (qe != NULL) {
-        result = qe->_payload;
-        free(qe);
-    } else {
-        result = NULL;
-    }
+void *CyberQueueDequeue(struct CyberQueue *q)
+{
+    void *result = NULL;
+
+    (void) CyberQueueDequeueMany(q, &result, 1);
 
     return result;
 }
 
+size_t CyberQueueGetCount(struct CyberQueue *q)
+{
+    assert(q != NULL);
+
+    // Load the dequeue position first so that it can't pass the enqueue position.
+    size_t dequeuePosition = atomic_load_explicit(&q->_dequeuePosition, memory_order_acquire);
+    size_t enqueuePosition = atomic_load_explicit(&q->_enqueuePosition, memory_order_acquire);
+
+    size_t count = enqueuePosition - dequeuePosition;
+    return (count > (q->_mask + 1)) ? (q->_mask + 1) : count;
+}
+
+
+// MARK: - Events
+
+bool CyberQueueEventAwait(struct CyberQueueEvent *event, struct CyberQueue *q, bool (*predicate)(struct CyberQueue *q), uint64_t timeoutNanoseconds)
+{
+    bool signaled = true;
+
+    // Register as a waiter and sample the signal count, then recheck before sleeping so a signal sent in between can't be lost.
+    atomic_fetch_add_explicit(&event->_waiters, 1, memory_order_seq_cst);
+    uint32_t signals = atomic_load_explicit(&event->_signals, memory_order_seq_cst);
+
+    if (predicate(q)) {
+        if (timeoutNanoseconds == UINT64_MAX) {
+            CyberFutexWait(&event->_signals, signals);
+        } else {
+            signaled = CyberFutexWaitWithTimeout(&event->_signals, signals, timeoutNanoseconds);
+        }
+    }
+
+    atomic_fetch_sub_explicit(&event->_waiters, 1, memory_order_relaxed);
+
+    return signaled;
+}
+
+void CyberQueueEventSignal(struct CyberQueueEvent *event, size_t count)
+{
+    // Order the change being signaled before the check for waiters, pairing with the registration in CyberQueueEventAwait.
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(&event->_waiters, memory_order_relaxed) != 0) {
+        atomic_fetch_add_explicit(&event->_signals, 1, memory_order_release);
+
+        // A burst can satisfy more than one waiter.
+        if (count == 1) {
+            CyberFutexWakeOne(&event->_signals);
+        } else {
+            CyberFutexWakeAll(&event->_signals);
+        }
+    }
+}
+
+bool CyberQueueIsEmpty(struct CyberQueue *q)
+{
+    size_t position = atomic_load_explicit(&q->_dequeuePosition, memory_order_seq_cst);
+    struct CyberQueueCell *cell = &q->_cells[position & q->_mask];
+    size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_seq_cst);
+
+    return ((intptr_t)sequence - (intptr_t)(position + 1)) < 0;
+}
+
+bool CyberQueueIsFull(struct CyberQueue *q)
+{
+    size_t position = atomic_load_explicit(&q->_enqueuePosition, memory_order_seq_cst);
+    struct CyberQueueCell *cell = &q->_cells[position & q->_mask];
+    size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_seq_cst);
+
+    return ((intptr_t)sequence - (intptr_t)position) < 0;
+}
+
+uint64_t CyberQueueGetTimeNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000) + (uint64_t)now.tv_nsec;
+}
+
 
 CYBER_SOURCE_END
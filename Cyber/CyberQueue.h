@@ -19,34 +19,83 @@
 
 #include <Cyber/CyberTypes.h>
 
+#include <stddef.h>
+
 #ifndef __CYBER_CYBERQUEUE_H__
 #define __CYBER_CYBERQUEUE_H__ 1
 
 CYBER_HEADER_BEGIN
 
 
-/// A CyberQueue is a first-in first-out queue of elements (repersented as a `void *` that is safe to use from multiple threads.
+/// A CyberQueue is a bounded first-in first-out queue of elements (represented as a `void *`) that is safe to use from multiple threads.
+///
+/// It's implemented as a lock-free multi-producer, multi-consumer ring buffer, so enqueuing and dequeuing never allocate and only block when the queue is full or empty, respectively.
 ///
 /// - Warning: The only disallowed value as a queue element payload is `NULL`.
 struct CyberQueue;
 
 
-/// Creates a first-in, first-out queue protected by a lock.
+/// The capacity of a queue created by ``CyberQueueCreate``.
+#define CYBER_QUEUE_DEFAULT_CAPACITY 1024
+
+
+/// Creates a first-in, first-out queue with the default capacity.
 CYBER_EXPORT struct CyberQueue * _Nullable CyberQueueCreate(void);
 
+/// Creates a first-in, first-out queue that can hold `capacity` elements.
+///
+/// - Warning: The capacity must be a power of two.
+CYBER_EXPORT struct CyberQueue * _Nullable CyberQueueCreateWithCapacity(size_t capacity);
+
 /// Disposes of a CyberQueue.
+///
+/// - Warning: No thread may be using the queue, and any elements still in it are not freed.
 CYBER_EXPORT void CyberQueueDispose(struct CyberQueue * _Nullable q);
 
 
-/// Add a new item to a CyberQueue.
+/// Add a new item to a CyberQueue, blocking if it's full.
 CYBER_EXPORT void CyberQueueEnqueue(struct CyberQueue *q, void *element);
 
+/// Attempt to add a new item to a CyberQueue, returning `false` if it's full.
+CYBER_EXPORT bool CyberQueueTryEnqueue(struct CyberQueue *q, void *element);
+
+/// Add `count` items to a CyberQueue, blocking whenever it's full until they've all been added.
+///
+/// As many items as will fit are added with a single synchronization operation.
+CYBER_EXPORT void CyberQueueEnqueueMany(struct CyberQueue *q, void * _Nonnull const * _Nonnull elements, size_t count);
+
+/// Attempt to add up to `count` items to a CyberQueue with a single synchronization operation.
+///
+/// - Returns: The number of items added from the start of `elements`, which is less than `count` if the queue filled up.
+CYBER_EXPORT size_t CyberQueueTryEnqueueMany(struct CyberQueue *q, void * _Nonnull const * _Nonnull elements, size_t count);
+
 /// Get an element from a CyberQueue, blocking if there isn't one.
 CYBER_EXPORT void *CyberQueueDequeue(struct CyberQueue *q);
 
 /// Attempt to get an element from a CyberQueue, returning `NULL` if there isn't one.
 CYBER_EXPORT void * _Nullable CyberQueueTryDequeue(struct CyberQueue *q);
 
+/// Get up to `maxCount` elements from a CyberQueue with a single synchronization operation, blocking if there aren't any.
+///
+/// - Returns: The number of elements stored into `elements`, which is at least 1.
+CYBER_EXPORT size_t CyberQueueDequeueMany(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount);
+
+/// Get up to `maxCount` elements from a CyberQueue with a single synchronization operation, blocking for at most `timeoutNanoseconds` if there aren't any.
+///
+/// - Returns: The number of elements stored into `elements`, which is 0 if the timeout elapsed.
+CYBER_EXPORT size_t CyberQueueDequeueManyWithTimeout(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount, uint64_t timeoutNanoseconds);
+
+/// Attempt to get up to `maxCount` elements from a CyberQueue with a single synchronization operation.
+///
+/// - Returns: The number of elements stored into `elements`, which is 0 if the queue is empty.
+CYBER_EXPORT size_t CyberQueueTryDequeueMany(struct CyberQueue *q, void * _Nonnull * _Nonnull elements, size_t maxCount);
+
+
+/// Get the number of elements in a CyberQueue.
+///
+/// - Note: This may be called from any thread; while elements are being enqueued or dequeued, the result is only a snapshot, and may count elements whose enqueues haven't finished.
+CYBER_EXPORT size_t CyberQueueGetCount(struct CyberQueue *q);
+
 
 CYBER_HEADER_END
 
@@ -20,7 +20,9 @@
 
 #include "CyberQueue.h"
 
-#include <pthread.h>
+#include "CyberFutex.h"
+
+#include <stdatomic.h>
 
 
 #ifndef __CYBER_CYBERQUEUE_INTERNAL_H__
@@ -29,36 +31,49 @@
 CYBER_HEADER_BEGIN
 
 
-struct CyberQueueElement;
+/// A cell in a CyberQueue's ring buffer.
+struct CyberQueueCell {
 
+    /// The position in the queue this cell is ready for: The position an enqueue can fill when equal to it, or the position a dequeue can empty when one past it.
+    _Atomic size_t _sequence;
 
-struct CyberQueue {
+    /// The payload for this cell, only valid while the cell is full.
+    void * _Nullable _payload;
+};
 
-    /// The element at the head of the queue.
-    struct CyberQueueElement * _Nullable _head;
 
-    /// The element at the tail of the queue.
-    struct CyberQueueElement * _Nullable _tail;
+/// An event that threads can wait on until another thread signals it, without ever taking a lock.
+///
+/// A waiter registers itself and samples the signal count *before* rechecking what it's waiting for, and only sleeps if the count hasn't changed since; a signaler makes its change visible *before* checking for waiters, so either the waiter sees the change or the signaler sees the waiter.
+struct CyberQueueEvent {
 
-    /// The queue lock.
-    pthread_mutex_t _lock;
+    /// The number of threads that may be waiting for the event.
+    _Atomic uint32_t _waiters;
 
-    /// The queue condition.
-    pthread_cond_t _condition;
+    /// Incremented each time the event is signaled while there are waiters.
+    CyberFutex _signals;
 };
 
 
-/// An element within a CyberQueue, which is a doubly-linked list for ease of manipulation.
-struct CyberQueueElement {
+struct CyberQueue {
 
-    /// The next element in the list. Will be `NULL` at the tail of the queue.
-    struct CyberQueueElement * _Nullable _next;
+    /// The ring buffer of cells.
+    struct CyberQueueCell *_cells;
 
-    /// The previous element in the list. Will be `NULL` at the head of the queue.
-    struct CyberQueueElement * _Nullable _previous;
+    /// The mask to turn a position into an index in the ring buffer, one less than its capacity.
+    size_t _mask;
 
-    /// The payload for this element.
-    void * _Nullable _payload;
+    /// The position of the next element to enqueue, on its own cache line since it's written by producers.
+    CYBER_CACHE_ALIGNED _Atomic size_t _enqueuePosition;
+
+    /// The position of the next element to dequeue, on its own cache line since it's written by consumers.
+    CYBER_CACHE_ALIGNED _Atomic size_t _dequeuePosition;
+
+    /// Signaled when an element is enqueued, for consumers waiting on an empty queue.
+    CYBER_CACHE_ALIGNED struct CyberQueueEvent _notEmpty;
+
+    /// Signaled when an element is dequeued, for producers waiting on a full queue.
+    CYBER_CACHE_ALIGNED struct CyberQueueEvent _notFull;
 };
 
 
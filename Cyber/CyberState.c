@@ -17,33 +17,35 @@
 //  limitations under the License.
 //
 
+
 #include "CyberState_Internal.h"
 
 #include <assert.h>
+#include <sched.h>
 #include <stdlib.h>
-
-#include <pthread.h>
+#include <unistd.h>
 
 
 CYBER_SOURCE_BEGIN
 
 
+/// Move a state's spin count a fraction of the way towards `target`, within the allowed range.
+static void CyberStateAdaptSpinCount(struct CyberState *cs, uint32_t spinCount, uint32_t target);
+
+/// Whether the host has only a single CPU online, in which case spinning is pointless.
+static bool CyberStateHostIsUniprocessor(void);
+
+
 struct CyberState * _Nullable CyberStateCreate(int initialValue)
 {
     struct CyberState *cs = calloc(1, sizeof(struct CyberState));
-
-    cs->_value = initialValue;
-
-    if (pthread_mutex_init(&cs->_mutex, NULL) != 0) {
-        free(cs);
+    if (cs == NULL) {
         return NULL;
     }
 
-    if (pthread_cond_init(&cs->_condition, NULL) != 0) {
-        (void) pthread_mutex_destroy(&cs->_mutex);
-        free(cs);
-        return NULL;
-    }
+    atomic_init(&cs->_value, (uint32_t)initialValue);
+    atomic_init(&cs->_waiters, 0);
+    atomic_init(&cs->_spinCount, CYBER_STATE_SPIN_COUNT);
 
     return cs;
 }
@@ -52,8 +54,7 @@ void CyberStateDispose(struct CyberState * _Nullable cs)
 {
     if (cs == NULL) return;
 
-    (void) pthread_mutex_destroy(&cs->_mutex);
-    (void) pthread_cond_destroy(&cs->_condition);
+    free(cs);
 }
 
 
@@ -61,41 +62,118 @@ int CyberStateGetValue(struct CyberState *cs)
 {
     assert(cs != NULL);
 
-    int currentValue;
+    return (int)atomic_load_explicit(&cs->_value, memory_order_acquire);
+}
+
+void CyberStateSetValue(struct CyberState *cs, int newValue)
+{
+    assert(cs != NULL);
+
+    atomic_store_explicit(&cs->_value, (uint32_t)newValue, memory_order_release);
 
-    pthread_mutex_lock(&cs->_mutex); {
-        currentValue = cs->_value;
-    } pthread_mutex_unlock(&cs->_mutex);
+    // Order the store before the check for waiters, pairing with the registration in CyberStateAwaitValueChange.
+    atomic_thread_fence(memory_order_seq_cst);
 
-    return currentValue;
+    if (atomic_load_explicit(&cs->_waiters, memory_order_relaxed) != 0) {
+        CyberFutexWakeAll(&cs->_value);
+    }
 }
 
-void CyberStateSetValue(struct CyberState *cs, int newValue)
+bool CyberStateCompareAndSetValue(struct CyberState *cs, int expectedValue, int newValue)
 {
     assert(cs != NULL);
 
-    pthread_mutex_lock(&cs->_mutex); {
-        cs->_value = newValue;
-        pthread_cond_signal(&cs->_condition);
-    } pthread_mutex_unlock(&cs->_mutex);
+    uint32_t expected = (uint32_t)expectedValue;
+    if (!atomic_compare_exchange_strong_explicit(&cs->_value, &expected, (uint32_t)newValue, memory_order_acq_rel, memory_order_acquire)) {
+        return false;
+    }
+
+    // Order the exchange before the check for waiters, as in CyberStateSetValue.
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(&cs->_waiters, memory_order_relaxed) != 0) {
+        CyberFutexWakeAll(&cs->_value);
+    }
+
+    return true;
 }
 
 int CyberStateAwaitValueChange(int currentValue, struct CyberState *cs)
 {
     assert(cs != NULL);
 
-    int newValue = currentValue;
+    int newValue = CyberStateGetValue(cs);
+    if (newValue != currentValue) {
+        return newValue;
+    }
+
+    // Spin briefly, since state changes are often handoffs that complete quickly. How long to spin is adapted to how long recent waits took: A wait that ends while spinning pulls the spin count towards twice its length, so the next one has headroom; a wait that outlasts spinning and yielding pushes it down, since that spinning was wasted. On a host with a single CPU, the change can't happen while this thread spins, so don't.
+    const uint32_t spinCount = CyberStateHostIsUniprocessor() ? 0 : atomic_load_explicit(&cs->_spinCount, memory_order_relaxed);
+    for (uint32_t spin = 0; spin < spinCount; spin++) {
+        CyberFutexSpinPause();
+        newValue = CyberStateGetValue(cs);
+        if (newValue != currentValue) {
+            CyberStateAdaptSpinCount(cs, spinCount, (spin + 1) * 2);
+            return newValue;
+        }
+    }
 
-    pthread_mutex_lock(&cs->_mutex); {
-        // Loop until the value actually changes because pthread_cond_wait can encounter spurious wakeups due to fundamental UNIX design flaws (e.g. EINTR).
-        do {
-            pthread_cond_wait(&cs->_condition, &cs->_mutex);
-            newValue = cs->_value;
-        } while (newValue == currentValue);
-    } pthread_mutex_unlock(&cs->_mutex);
+    // Then yield the host CPU a few times, in case the thread that will make the change is waiting to run on it. A wait that ends here doesn't adjust the spin count, since it may only have ended because this thread gave up the CPU.
+    for (int yield = 0; yield < CYBER_STATE_YIELD_COUNT; yield++) {
+        sched_yield();
+        newValue = CyberStateGetValue(cs);
+        if (newValue != currentValue) {
+            return newValue;
+        }
+    }
+
+    if (spinCount != 0) {
+        CyberStateAdaptSpinCount(cs, spinCount, CYBER_STATE_SPIN_COUNT_MIN);
+    }
+
+    // Register as a waiter before the final check, so a change made after it is guaranteed to wake us.
+    atomic_fetch_add_explicit(&cs->_waiters, 1, memory_order_seq_cst);
+
+    while ((newValue = (int)atomic_load_explicit(&cs->_value, memory_order_seq_cst)) == currentValue) {
+        CyberFutexWait(&cs->_value, (uint32_t)currentValue);
+    }
+
+    atomic_fetch_sub_explicit(&cs->_waiters, 1, memory_order_relaxed);
 
     return newValue;
 }
 
 
+static void CyberStateAdaptSpinCount(struct CyberState *cs, uint32_t spinCount, uint32_t target)
+{
+    // Move an eighth of the way each time, so a single unusual wait doesn't swing the count. Racing updates from other waiters can be lost, which only slows adaptation.
+    int64_t difference = (int64_t)target - (int64_t)spinCount;
+    int64_t step = difference / 8;
+    if (step == 0) step = (difference > 0) - (difference < 0); // always make progress, to settle exactly on the target
+    int64_t adjusted = (int64_t)spinCount + step;
+    if (adjusted < CYBER_STATE_SPIN_COUNT_MIN) adjusted = CYBER_STATE_SPIN_COUNT_MIN;
+    if (adjusted > CYBER_STATE_SPIN_COUNT_MAX) adjusted = CYBER_STATE_SPIN_COUNT_MAX;
+
+    if (adjusted != spinCount) {
+        atomic_store_explicit(&cs->_spinCount, (uint32_t)adjusted, memory_order_relaxed);
+    }
+}
+
+
+static bool CyberStateHostIsUniprocessor(void)
+{
+    // Only look once, since the answer doesn't change in practice; racing first calls just look more than once.
+    static _Atomic int hostCPUs = 0;
+
+    int cpus = atomic_load_explicit(&hostCPUs, memory_order_relaxed);
+    if (cpus == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        cpus = (online > 0) ? (int)online : 1;
+        atomic_store_explicit(&hostCPUs, cpus, memory_order_relaxed);
+    }
+
+    return cpus == 1;
+}
+
+
 CYBER_SOURCE_END
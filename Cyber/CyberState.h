@@ -25,7 +25,9 @@
 CYBER_HEADER_BEGIN
 
 
-/// A CyberState is a state plus a lock plus a condition variable that can be used to implement a state that can be get, set, or blocked on.
+/// A CyberState is an atomic state that can be get, set, or blocked on.
+///
+/// Getting and setting the state are single atomic operations; only awaiting a change ever blocks, and then only after spinning and yielding briefly, for as long as recent changes to the state have tended to take.
 struct CyberState;
 
 
@@ -42,7 +44,14 @@ CYBER_EXPORT int CyberStateGetValue(struct CyberState *cs);
 /// Change the current state, unblocknig any threads awaiting a change.
 CYBER_EXPORT void CyberStateSetValue(struct CyberState *cs, int newValue);
 
-/// Block until the state changes from the given current value.
+/// Change the current state only if it's still `expectedValue`, unblocking any threads awaiting a change.
+///
+/// - Returns: `true` if the state was changed, or `false` if it held some other value.
+CYBER_EXPORT bool CyberStateCompareAndSetValue(struct CyberState *cs, int expectedValue, int newValue);
+
+/// Block until the state changes from the given current value, returning immediately if it already has.
+///
+/// This spins for a while before yielding the host CPU and finally sleeping, so quick handoffs between threads don't pay for a trip through the kernel. How long it spins adapts to how long waits on this state have recently taken.
 CYBER_EXPORT int CyberStateAwaitValueChange(int currentValue, struct CyberState *cs);
 
 
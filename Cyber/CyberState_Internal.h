@@ -19,7 +19,7 @@
 
 #include "CyberState.h"
 
-#include <pthread.h>
+#include "CyberFutex.h"
 
 #ifndef __CYBER_CYBERSTATE_INTERNAL_H__
 #define __CYBER_CYBERSTATE_INTERNAL_H__
@@ -27,10 +27,29 @@
 CYBER_HEADER_BEGIN
 
 
+/// The number of times ``CyberStateAwaitValueChange`` initially polls for a change before yielding.
+#define CYBER_STATE_SPIN_COUNT 100
+
+/// The fewest times ``CyberStateAwaitValueChange`` polls for a change before yielding, however rarely spinning pays off.
+#define CYBER_STATE_SPIN_COUNT_MIN 16
+
+/// The most times ``CyberStateAwaitValueChange`` polls for a change before yielding, however often spinning pays off.
+#define CYBER_STATE_SPIN_COUNT_MAX 8192
+
+/// The number of times ``CyberStateAwaitValueChange`` yields the host CPU after spinning and before blocking.
+#define CYBER_STATE_YIELD_COUNT 4
+
+
 struct CyberState {
-    int _value;
-    pthread_mutex_t _mutex;
-    pthread_cond_t _condition;
+
+    /// The current value, stored as the bits of an `int`.
+    CyberFutex _value;
+
+    /// The number of threads that may be blocked awaiting a change, so setting the value only wakes them when needed.
+    _Atomic uint32_t _waiters;
+
+    /// The number of times to poll for a change before yielding, adapted to how long recent waits for this state took.
+    _Atomic uint32_t _spinCount;
 };
 
 
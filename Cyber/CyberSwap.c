@@ -0,0 +1,122 @@
+//
+//  CyberSwap.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberSwap.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The type of a bulk word swap implementation.
+typedef void (*CyberWord64SwapMultipleFunction)(CyberWord64 *destination, const CyberWord64 *source, size_t count);
+
+
+/// Swap words one at a time, for hosts without a vector implementation and for the tails of vector runs.
+static void CyberWord64SwapMultiple_Scalar(CyberWord64 *destination, const CyberWord64 *source, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = __builtin_bswap64(source[i]);
+    }
+}
+
+
+#if defined(__x86_64__)
+
+/// Swap words two at a time using an SSSE3 byte shuffle.
+__attribute__((target("ssse3")))
+static void CyberWord64SwapMultiple_SSSE3(CyberWord64 *destination, const CyberWord64 *source, size_t count)
+{
+    const __m128i reverseEachWord = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                                 0, 1,  2,  3,  4,  5,  6,  7);
+
+    size_t i = 0;
+    for (; (i + 2) <= count; i += 2) {
+        __m128i words = _mm_loadu_si128((const __m128i *)&source[i]);
+        _mm_storeu_si128((__m128i *)&destination[i], _mm_shuffle_epi8(words, reverseEachWord));
+    }
+
+    CyberWord64SwapMultiple_Scalar(&destination[i], &source[i], count - i);
+}
+
+/// Swap words four at a time using an AVX2 byte shuffle.
+__attribute__((target("avx2")))
+static void CyberWord64SwapMultiple_AVX2(CyberWord64 *destination, const CyberWord64 *source, size_t count)
+{
+    // The AVX2 shuffle operates within each 128-bit lane, so the same pattern is used for both lanes.
+    const __m256i reverseEachWord = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+                                                    0, 1,  2,  3,  4,  5,  6,  7,
+                                                    8, 9, 10, 11, 12, 13, 14, 15,
+                                                    0, 1,  2,  3,  4,  5,  6,  7);
+
+    size_t i = 0;
+    for (; (i + 4) <= count; i += 4) {
+        __m256i words = _mm256_loadu_si256((const __m256i *)&source[i]);
+        _mm256_storeu_si256((__m256i *)&destination[i], _mm256_shuffle_epi8(words, reverseEachWord));
+    }
+
+    CyberWord64SwapMultiple_Scalar(&destination[i], &source[i], count - i);
+}
+
+#endif
+
+
+/// The implementation chosen for this host.
+static CyberWord64SwapMultipleFunction CyberWord64SwapMultipleImplementation = CyberWord64SwapMultiple_Scalar;
+
+/// Ensures the implementation is only chosen once.
+static pthread_once_t CyberWord64SwapMultipleOnce = PTHREAD_ONCE_INIT;
+
+
+/// Choose the best implementation the host processor supports.
+static void CyberWord64SwapMultipleChooseImplementation(void)
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        CyberWord64SwapMultipleImplementation = CyberWord64SwapMultiple_AVX2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        CyberWord64SwapMultipleImplementation = CyberWord64SwapMultiple_SSSE3;
+    }
+#endif
+}
+
+
+void CyberWord64SwapMultiple(CyberWord64 *destination, const CyberWord64 *source, size_t count)
+{
+#if CYBER_BIG_ENDIAN
+    if (destination != source) {
+        memcpy(destination, source, count * sizeof(CyberWord64));
+    }
+#else
+    (void) pthread_once(&CyberWord64SwapMultipleOnce, CyberWord64SwapMultipleChooseImplementation);
+
+    CyberWord64SwapMultipleImplementation(destination, source, count);
+#endif
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,43 @@
+//
+//  CyberSwap.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#include <stddef.h>
+
+#ifndef __CYBER_CYBERSWAP_H__
+#define __CYBER_CYBERSWAP_H__
+
+CYBER_HEADER_BEGIN
+
+
+/// Swap a run of 64-bit Cyber words if necessary; the Cyber is big-endian.
+///
+/// This is the bulk equivalent of ``CyberWord64Swap``. On x86-64 hosts it uses AVX2 or SSSE3 byte shuffles when the processor supports them, which is determined once at runtime, and falls back to swapping one word at a time otherwise.
+///
+/// - Parameters:
+///   - destination: The location in which to store the swapped words.
+///   - source: The words to swap, which may be the same as `destination` but must not otherwise overlap it.
+///   - count: The number of words to swap.
+CYBER_EXPORT void CyberWord64SwapMultiple(CyberWord64 *destination, const CyberWord64 *source, size_t count);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERSWAP_H__ */
@@ -17,11 +17,23 @@
 //  limitations under the License.
 //
 
+#if defined(__linux__)
+#define _GNU_SOURCE // for CPU affinity
+#endif
+
 #include "CyberThread_Internal.h"
 
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#endif
 
 #include "CyberState.h"
 
@@ -31,9 +43,16 @@ CYBER_SOURCE_BEGIN
 
 static void * _Nullable CyberThreadPthreadFunction(void * _Nullable t);
 static void CyberThreadFunctionPlaceholder(struct CyberThread *thread, void * _Nullable context);
+static void CyberThreadApplyAttributes(struct CyberThread *thread);
 
 
 struct CyberThread * _Nullable CyberThreadCreate(const char *name, struct CyberThreadFunctions *threadFunctions, void * _Nullable context)
+{
+    return CyberThreadCreateWithAttributes(name, threadFunctions, context, NULL);
+}
+
+
+struct CyberThread * _Nullable CyberThreadCreateWithAttributes(const char *name, struct CyberThreadFunctions *threadFunctions, void * _Nullable context, const struct CyberThreadAttributes * _Nullable attributes)
 {
     assert(name != NULL);
     assert(threadFunctions != NULL);
@@ -49,9 +68,14 @@ struct CyberThread * _Nullable CyberThreadCreate(const char *name, struct CyberT
     thread->_functions.stop = threadFunctions->stop ?: CyberThreadFunctionPlaceholder;
     thread->_functions.terminate = threadFunctions->terminate ?: CyberThreadFunctionPlaceholder;
 
+    if (attributes != NULL) {
+        thread->_attributes = *attributes;
+    }
+
     thread->_state = CyberStateCreate(CyberThreadState_New);
     if (thread->_state == NULL) {
         assert(thread->_state != NULL); // halt here in debug build
+        thread->_joined = true; // there's no thread to join
         CyberThreadDispose(thread);
         return NULL;
     }
@@ -60,15 +84,23 @@ struct CyberThread * _Nullable CyberThreadCreate(const char *name, struct CyberT
     int pthread_attrs_err = pthread_attr_init(&pthread_attrs);
     if (pthread_attrs_err != 0) {
         assert(pthread_attrs_err == 0); // halt here in debug build
+        thread->_joined = true; // there's no thread to join
         CyberThreadDispose(thread);
         return NULL;
     }
 
-    (void) pthread_attr_setdetachstate(&pthread_attrs, PTHREAD_CREATE_DETACHED);
+    (void) pthread_attr_setdetachstate(&pthread_attrs, PTHREAD_CREATE_JOINABLE);
+
+    if (thread->_attributes.stackSize != 0) {
+        int stack_err = pthread_attr_setstacksize(&pthread_attrs, thread->_attributes.stackSize);
+        assert(stack_err == 0); // halt here in debug build
+        (void) stack_err;
+    }
 
     int pthread_err = pthread_create(&thread->_pthread, &pthread_attrs, CyberThreadPthreadFunction, thread);
     if (pthread_err != 0) {
         assert(pthread_err == 0); // halt here in debug build
+        thread->_joined = true; // there's no thread to join
         CyberThreadDispose(thread);
         return NULL;
     }
@@ -79,6 +111,7 @@ struct CyberThread * _Nullable CyberThreadCreate(const char *name, struct CyberT
 
     enum CyberThreadState awaitedState = CyberStateAwaitValueChange(CyberThreadState_New, thread->_state);
     assert(awaitedState != CyberThreadState_New);
+    (void) awaitedState;
 
     return thread;
 }
@@ -88,26 +121,45 @@ void CyberThreadDispose(struct CyberThread * _Nullable thread)
 {
     if (thread == NULL) return;
 
-    // thread->_pthread will be cleaned up by the system
+    if (!thread->_joined) {
+        CyberThreadTerminate(thread);
+
+        // The thread and whatever its owner is about to free may still be in use until it exits, so wait for it however long that takes.
+        int join_err = pthread_join(thread->_pthread, NULL);
+        assert(join_err == 0); // halt here in debug build
+        (void) join_err;
+        thread->_joined = true;
+    }
 
     CyberStateDispose(thread->_state);
 
-    free (thread);
+    free((void *)thread->_name);
+    free(thread);
 }
 
 
+/// Move a thread to a new state, unless it has been terminated, which is final.
+static void CyberThreadRequestState(struct CyberThread *thread, enum CyberThreadState newState)
+{
+    enum CyberThreadState state = CyberStateGetValue(thread->_state);
+    while (state != CyberThreadState_Terminated) {
+        if (CyberStateCompareAndSetValue(thread->_state, state, newState)) break;
+        state = CyberStateGetValue(thread->_state);
+    }
+}
+
 void CyberThreadStart(struct CyberThread *thread)
 {
     assert(thread != NULL);
 
-    CyberStateSetValue(thread->_state, CyberThreadState_Started);
+    CyberThreadRequestState(thread, CyberThreadState_Started);
 }
 
 void CyberThreadStop(struct CyberThread *thread)
 {
     assert(thread != NULL);
 
-    CyberStateSetValue(thread->_state, CyberThreadState_Stopped);
+    CyberThreadRequestState(thread, CyberThreadState_Stopped);
 }
 
 void CyberThreadTerminate(struct CyberThread *thread)
@@ -117,6 +169,36 @@ void CyberThreadTerminate(struct CyberThread *thread)
     CyberStateSetValue(thread->_state, CyberThreadState_Terminated);
 }
 
+bool CyberThreadJoin(struct CyberThread *thread, uint64_t timeoutNanoseconds)
+{
+    assert(thread != NULL);
+    assert(CyberStateGetValue(thread->_state) == CyberThreadState_Terminated);
+
+    if (thread->_joined) return true;
+
+    // Wait for the thread to say it's exiting, since POSIX has no portable timed join; once it has, the join itself can't block for long.
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t start = ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+
+    while (atomic_load_explicit(&thread->_exited, memory_order_acquire) == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const uint64_t elapsed = (((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec) - start;
+        if (elapsed >= timeoutNanoseconds) {
+            return false;
+        }
+
+        (void) CyberFutexWaitWithTimeout(&thread->_exited, 0, timeoutNanoseconds - elapsed);
+    }
+
+    int join_err = pthread_join(thread->_pthread, NULL);
+    assert(join_err == 0);
+    (void) join_err;
+    thread->_joined = true;
+
+    return true;
+}
+
 
 static void * _Nullable CyberThreadPthreadFunction(void * _Nullable t)
 {
@@ -127,9 +209,19 @@ static void * _Nullable CyberThreadPthreadFunction(void * _Nullable t)
 
     pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
 
-    // Set this thread's name.
+    // Set this thread's name. Linux limits names to 15 characters and only names threads via a handle, while macOS only names the calling thread.
 
+#if defined(__APPLE__)
     pthread_setname_np(thread->_name);
+#elif defined(__linux__)
+    char name[16];
+    snprintf(name, sizeof(name), "%s", thread->_name);
+    (void) pthread_setname_np(pthread_self(), name);
+#endif
+
+    // Place and schedule this thread, before CyberThreadCreate() returns.
+
+    CyberThreadApplyAttributes(thread);
 
     // Loop indefinitely until shut down.
 
@@ -156,8 +248,8 @@ static void * _Nullable CyberThreadPthreadFunction(void * _Nullable t)
                 // Call the start function if there is one. (Calls placeholder if not.)
                 thread->_functions.start(thread, thread->_context);
 
-                // Transition to running state.
-                CyberStateSetValue(thread->_state, CyberThreadState_Running);
+                // Transition to running state, unless the thread was stopped or terminated while its start function ran.
+                (void) CyberStateCompareAndSetValue(thread->_state, CyberThreadState_Started, CyberThreadState_Running);
                 break;
 
             case CyberThreadState_Running:
@@ -175,6 +267,10 @@ static void * _Nullable CyberThreadPthreadFunction(void * _Nullable t)
         }
     }
 
+    // Let CyberThreadJoin() know this thread is exiting. This must be the last access to the CyberThread, since it may be freed as soon as the thread is joined.
+    atomic_store_explicit(&thread->_exited, 1, memory_order_release);
+    CyberFutexWakeAll(&thread->_exited);
+
     return NULL;
 }
 
@@ -185,4 +281,78 @@ static void CyberThreadFunctionPlaceholder(struct CyberThread *thread, void * _N
 }
 
 
+/// Apply a thread's placement and scheduling attributes to the calling thread, which must be that thread.
+static void CyberThreadApplyAttributes(struct CyberThread *thread)
+{
+    const struct CyberThreadAttributes *attributes = &thread->_attributes;
+
+    // Failures are ignored since the attributes are only requests; the thread can still run without them.
+
+    if (attributes->cpuMask != 0) {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if (attributes->cpuMask & (1ULL << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        (void) pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#elif defined(__APPLE__)
+        // Affinity tags are only a hint that threads sharing a tag should share a cache, so use the lowest CPU in the mask as the tag.
+        thread_affinity_policy_data_t policy = { .affinity_tag = __builtin_ctzll(attributes->cpuMask) + 1 };
+        (void) thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_AFFINITY_POLICY, (thread_policy_t)&policy, THREAD_AFFINITY_POLICY_COUNT);
+#endif
+    }
+
+    if (attributes->schedulingPolicy != CyberThreadSchedulingPolicyDefault) {
+        int policy = (attributes->schedulingPolicy == CyberThreadSchedulingPolicyFIFO) ? SCHED_FIFO : SCHED_RR;
+        struct sched_param parameters = { .sched_priority = attributes->priority };
+        (void) pthread_setschedparam(pthread_self(), policy, &parameters);
+    }
+}
+
+
+int CyberThreadGetHostCPUCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) return 1;
+    if (count > 64) return 64;
+    return (int)count;
+}
+
+
+uint64_t CyberThreadGetSiblingCPUMask(int cpu)
+{
+    assert((cpu >= 0) && (cpu < 64));
+
+    uint64_t mask = 1ULL << cpu;
+
+#if defined(__linux__)
+    // Linux reports the hardware threads sharing a core as a list of ranges, like "0,32" or "0-1".
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+    FILE *siblings = fopen(path, "r");
+    if (siblings != NULL) {
+        int first, last;
+        char separator;
+        while (fscanf(siblings, "%d", &first) == 1) {
+            last = first;
+            if ((fscanf(siblings, "%c", &separator) == 1) && (separator == '-')) {
+                if (fscanf(siblings, "%d", &last) != 1) break;
+                (void) fscanf(siblings, "%c", &separator);
+            }
+            for (int sibling = first; (sibling <= last) && (sibling < 64); sibling++) {
+                mask |= 1ULL << sibling;
+            }
+        }
+        fclose(siblings);
+    }
+#endif
+
+    return mask;
+}
+
+
 CYBER_SOURCE_END
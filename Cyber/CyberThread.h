@@ -19,6 +19,8 @@
 
 #include <Cyber/CyberTypes.h>
 
+#include <stddef.h>
+
 #ifndef __CYBER_CYBERTHREAD_H__
 #define __CYBER_CYBERTHREAD_H__
 
@@ -46,27 +48,75 @@ struct CyberThreadFunctions {
 };
 
 
-/// Creates a detached thread.
+/// The host scheduling policy for a thread.
+enum CyberThreadSchedulingPolicy {
+
+    /// The host's default time-sharing policy.
+    CyberThreadSchedulingPolicyDefault = 0,
+
+    /// Real-time first-in, first-out scheduling.
+    CyberThreadSchedulingPolicyFIFO = 1,
+
+    /// Real-time round-robin scheduling.
+    CyberThreadSchedulingPolicyRoundRobin = 2,
+};
+
+
+/// Attributes controlling how a thread is placed and scheduled on the host.
+///
+/// A zeroed structure requests the host's defaults for everything.
+struct CyberThreadAttributes {
+
+    /// The host CPUs the thread may run on, where bit N represents CPU N; 0 allows any CPU.
+    ///
+    /// - Note: On Linux this is a hard affinity. On macOS, which has no hard affinity, threads with the same mask are given the same affinity tag as a hint to share a cache.
+    uint64_t cpuMask;
+
+    /// The scheduling policy for the thread.
+    enum CyberThreadSchedulingPolicy schedulingPolicy;
+
+    /// The priority for the thread within its scheduling policy; ignored for the default policy.
+    int priority;
+
+    /// The size of the thread's stack in bytes; 0 uses the host default.
+    size_t stackSize;
+};
+
+
+/// A reasonable bound, in nanoseconds, for ``CyberThreadJoin`` to wait for a terminated thread to exit.
+#define CYBER_THREAD_JOIN_TIMEOUT (1000ULL * 1000ULL * 1000ULL)
+
+
+/// Creates a thread.
 ///
 /// - Warning: The thread is not started automatically.
 CYBER_EXPORT struct CyberThread * _Nullable CyberThreadCreate(const char *name, struct CyberThreadFunctions *threadFunctions, void * _Nullable context);
 
+/// Creates a thread with the given attributes.
+///
+/// Placement and scheduling are requests: If the host refuses them, for example because real-time scheduling requires privileges, the thread still runs with the host's defaults.
+///
+/// - Warning: The thread is not started automatically.
+CYBER_EXPORT struct CyberThread * _Nullable CyberThreadCreateWithAttributes(const char *name, struct CyberThreadFunctions *threadFunctions, void * _Nullable context, const struct CyberThreadAttributes * _Nullable attributes);
+
 /// Disposes of a thread.
 ///
-/// - Warning: The thread must be halted or shut down before disposal.
+/// Terminates the thread if it hasn't been already, joins it, and then releases its memory.
+///
+/// - Warning: This waits for as long as the thread takes to exit, since callers free what the thread shares with them as soon as this returns. To shut down within a bound, terminate the thread and call ``CyberThreadJoin`` first.
 CYBER_EXPORT void CyberThreadDispose(struct CyberThread * _Nullable thread);
 
 
 /// Start a stopped thread.
 ///
-/// Transitions the thread to a running state, causes its `start` function to be called, and then causes its `loop` function to be called repeatedly.
+/// Transitions the thread to a running state, causes its `start` function to be called, and then causes its `loop` function to be called repeatedly. A terminated thread stays terminated.
 ///
 /// - Warning: A thread is considered running as soon as its `start` function exits.
 CYBER_EXPORT void CyberThreadStart(struct CyberThread *thread);
 
 /// Stop a running thread.
 ///
-/// Transitions the thread to a stopped state and causes its `stop` function to be called.
+/// Transitions the thread to a stopped state and causes its `stop` function to be called. A terminated thread stays terminated.
 ///
 /// - Warning: A thread is not stopped until after its `stop` function has exited.
 CYBER_EXPORT void CyberThreadStop(struct CyberThread *thread);
@@ -78,6 +128,22 @@ CYBER_EXPORT void CyberThreadStop(struct CyberThread *thread);
 /// - Warning: A thread is not terminated until after its `terminate` function exits.
 CYBER_EXPORT void CyberThreadTerminate(struct CyberThread *thread);
 
+/// Wait for a terminated thread to exit, for at most `timeoutNanoseconds`.
+///
+/// - Returns: `true` if the thread exited and was joined, or `false` if the timeout elapsed first.
+///
+/// - Warning: The thread must have been terminated via ``CyberThreadTerminate``.
+CYBER_EXPORT bool CyberThreadJoin(struct CyberThread *thread, uint64_t timeoutNanoseconds);
+
+
+/// Get the number of CPUs the host has online, limited to the 64 that a ``CyberThreadAttributes`` mask can represent.
+CYBER_EXPORT int CyberThreadGetHostCPUCount(void);
+
+/// Get the mask of host CPUs that share a core with the given CPU, including the CPU itself.
+///
+/// - Note: Where the host doesn't report its topology, each CPU is assumed to be its own core.
+CYBER_EXPORT uint64_t CyberThreadGetSiblingCPUMask(int cpu);
+
 
 CYBER_HEADER_END
 
@@ -19,6 +19,8 @@
 
 #include "CyberThread.h"
 
+#include "CyberFutex.h"
+
 #include <pthread.h>
 
 #ifndef __CYBER_CYBERTHREAD_INTERNAL_H__
@@ -53,6 +55,15 @@ struct CyberThread {
 
     /// The functions called by this thread, copied into place at creation.
     struct CyberThreadFunctions _functions;
+
+    /// The placement and scheduling attributes for this thread, copied into place at creation.
+    struct CyberThreadAttributes _attributes;
+
+    /// Set to 1 by the thread as the last thing it does before exiting, so it can be joined with a timeout.
+    CyberFutex _exited;
+
+    /// Whether the POSIX thread has been joined.
+    bool _joined;
 };
 
 
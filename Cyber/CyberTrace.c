@@ -0,0 +1,447 @@
+//
+//  CyberTrace.c
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberTrace_Internal.h"
+
+#include <Cyber/CyberThread.h>
+
+#include "CyberCycleCounter.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+_Thread_local int CyberTraceCurrentStream = -1;
+
+
+/// A trace file being read.
+struct CyberTraceReader {
+
+    /// The file being read.
+    FILE *_file;
+
+    /// The file's header.
+    struct CyberTraceFileHeader _header;
+
+    /// The records of the most recently read chunk.
+    void * _Nullable _buffer;
+
+    /// The capacity of `_buffer` in bytes.
+    size_t _bufferCapacity;
+};
+
+
+/// Write whatever is in a stream's ring to the trace file as a chunk.
+///
+/// - Returns: The number of bytes written, not counting the chunk header.
+static uint64_t CyberTraceDrainRing(struct CyberTrace *trace, int stream);
+
+/// Drain every stream's ring to the trace file.
+///
+/// - Returns: Whether any ring was more than a quarter full.
+static bool CyberTraceDrainRings(struct CyberTrace *trace);
+
+/// The drain thread's loop: drain the rings, then sleep briefly unless they're filling quickly.
+static void CyberTraceDrainLoop(struct CyberThread *thread, void * _Nullable tracev);
+
+
+struct CyberTrace * _Nullable CyberTraceCreate(enum CyberTraceKind kind, int streamCount, size_t ringBytes)
+{
+    assert(streamCount > 0);
+    assert(ringBytes >= 64);
+    assert((ringBytes & (ringBytes - 1)) == 0); // must be a power of two
+
+    struct CyberTrace *trace = NULL;
+    int alloc_err = posix_memalign((void **)&trace, CYBER_CACHE_LINE_SIZE, sizeof(struct CyberTrace));
+    if (alloc_err != 0) {
+        assert(alloc_err == 0); // halt here in debug builds
+        return NULL;
+    }
+    memset(trace, 0, sizeof(struct CyberTrace));
+
+    trace->_kind = kind;
+    trace->_streamCount = streamCount;
+
+    int rings_err = posix_memalign((void **)&trace->_rings, CYBER_CACHE_LINE_SIZE, sizeof(struct CyberTraceRing) * streamCount);
+    if (rings_err != 0) {
+        assert(rings_err == 0); // halt here in debug builds
+        trace->_rings = NULL;
+        CyberTraceDispose(trace);
+        return NULL;
+    }
+    memset(trace->_rings, 0, sizeof(struct CyberTraceRing) * streamCount);
+
+    trace->_droppedAtStart = calloc(streamCount, sizeof(uint64_t));
+    if (trace->_droppedAtStart == NULL) {
+        assert(trace->_droppedAtStart != NULL); // halt here in debug builds
+        CyberTraceDispose(trace);
+        return NULL;
+    }
+
+    for (int s = 0; s < streamCount; s++) {
+        struct CyberTraceRing *ring = &trace->_rings[s];
+        ring->_bytes = malloc(ringBytes);
+        if (ring->_bytes == NULL) {
+            assert(ring->_bytes != NULL); // halt here in debug builds
+            CyberTraceDispose(trace);
+            return NULL;
+        }
+        ring->_mask = ringBytes - 1;
+    }
+
+    return trace;
+}
+
+void CyberTraceDispose(struct CyberTrace * _Nullable trace)
+{
+    if (trace == NULL) return;
+
+    if (trace->_file != NULL) {
+        (void) CyberTraceStop(trace, NULL);
+    }
+
+    if (trace->_rings != NULL) {
+        for (int s = 0; s < trace->_streamCount; s++) {
+            free(trace->_rings[s]._bytes);
+        }
+    }
+    free(trace->_rings);
+    free(trace->_droppedAtStart);
+    free(trace);
+}
+
+
+bool CyberTraceStart(struct CyberTrace *trace, const char *path)
+{
+    assert(trace != NULL);
+    assert(path != NULL);
+    assert(trace->_file == NULL); // tracing must be stopped
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // Discard anything left from a previous trace. This only moves each ring's tail, which the consumer owns, so it's safe even if a producer is still finishing an append.
+    for (int s = 0; s < trace->_streamCount; s++) {
+        struct CyberTraceRing *ring = &trace->_rings[s];
+        atomic_store_explicit(&ring->_tail, atomic_load_explicit(&ring->_head, memory_order_acquire), memory_order_release);
+        trace->_droppedAtStart[s] = __atomic_load_n(&ring->_dropped, __ATOMIC_RELAXED);
+    }
+
+    struct CyberTraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CYBER_TRACE_MAGIC, sizeof(header.magic));
+    header.version = CYBER_TRACE_VERSION;
+    header.kind = trace->_kind;
+    header.ticksPerSecond = CyberCycleCounterGetFrequency();
+    header.startTicks = CyberCycleCounterRead();
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        return false;
+    }
+    trace->_file = file;
+    trace->_writeFailed = false;
+
+    struct CyberThreadFunctions functions = { .loop = CyberTraceDrainLoop };
+    trace->_thread = CyberThreadCreate("Trace", &functions, trace);
+    if (trace->_thread == NULL) {
+        fclose(trace->_file);
+        trace->_file = NULL;
+        return false;
+    }
+    CyberThreadStart(trace->_thread);
+
+    atomic_fetch_add_explicit(&trace->_generation, 1, memory_order_relaxed);
+    atomic_store_explicit(&trace->_enabled, true, memory_order_release);
+
+    return true;
+}
+
+bool CyberTraceStop(struct CyberTrace *trace, uint64_t * _Nullable dropped)
+{
+    assert(trace != NULL);
+    assert(trace->_file != NULL); // tracing must be started
+
+    atomic_store_explicit(&trace->_enabled, false, memory_order_release);
+
+    // Once the drain thread has exited, this thread is the only consumer and can drain what's left.
+    CyberThreadDispose(trace->_thread);
+    trace->_thread = NULL;
+
+    for (int s = 0; s < trace->_streamCount; s++) {
+        while (CyberTraceDrainRing(trace, s) > 0) {
+            // keep draining until the ring is empty
+        }
+    }
+
+    // A failure may only show up when buffered data is flushed on closing.
+    bool succeeded = !trace->_writeFailed;
+    succeeded = (fclose(trace->_file) == 0) && succeeded;
+    trace->_file = NULL;
+
+    if (dropped != NULL) {
+        *dropped = 0;
+        for (int s = 0; s < trace->_streamCount; s++) {
+            *dropped += __atomic_load_n(&trace->_rings[s]._dropped, __ATOMIC_RELAXED) - trace->_droppedAtStart[s];
+        }
+    }
+
+    return succeeded;
+}
+
+
+static uint64_t CyberTraceDrainRing(struct CyberTrace *trace, int stream)
+{
+    struct CyberTraceRing *ring = &trace->_rings[stream];
+    const uint64_t capacity = ring->_mask + 1;
+    const uint64_t tail = atomic_load_explicit(&ring->_tail, memory_order_relaxed);
+    const uint64_t head = atomic_load_explicit(&ring->_head, memory_order_acquire);
+    if (head == tail) {
+        return 0;
+    }
+
+    // Producers only publish whole records, so everything between the tail and the head can go in one chunk.
+    const uint64_t length = head - tail;
+    const uint64_t offset = tail & ring->_mask;
+    const uint64_t first = ((capacity - offset) < length) ? (capacity - offset) : length;
+
+    // Once a write has failed the file is truncated anyway, so just keep the rings moving until tracing stops and reports it.
+    if (!trace->_writeFailed) {
+        struct CyberTraceChunkHeader header = { .stream = (uint32_t)stream, .length = (uint32_t)length };
+        bool written = (fwrite(&header, sizeof(header), 1, trace->_file) == 1);
+        written = written && (fwrite(&ring->_bytes[offset], 1, first, trace->_file) == first);
+        written = written && (fwrite(&ring->_bytes[0], 1, length - first, trace->_file) == (length - first));
+        trace->_writeFailed = !written;
+    }
+
+    // Only release the space once it's been copied out.
+    atomic_store_explicit(&ring->_tail, head, memory_order_release);
+
+    return length;
+}
+
+static bool CyberTraceDrainRings(struct CyberTrace *trace)
+{
+    bool filling = false;
+    for (int s = 0; s < trace->_streamCount; s++) {
+        uint64_t length = CyberTraceDrainRing(trace, s);
+        filling |= (length > ((trace->_rings[s]._mask + 1) / 4));
+    }
+    return filling;
+}
+
+static void CyberTraceDrainLoop(struct CyberThread *thread, void * _Nullable tracev)
+{
+    struct CyberTrace *trace = (struct CyberTrace *)tracev;
+
+    // Draining a few bytes at a time would keep pulling the cache lines a processor is appending to away from it, so let the rings fill for a while between passes.
+    if (!CyberTraceDrainRings(trace)) {
+        const struct timespec interval = { .tv_sec = 0, .tv_nsec = 1000000 };
+        nanosleep(&interval, NULL);
+    }
+}
+
+
+struct CyberTraceReader * _Nullable CyberTraceReaderOpen(const char *path)
+{
+    assert(path != NULL);
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    struct CyberTraceFileHeader header;
+    if (   (fread(&header, sizeof(header), 1, file) != 1)
+        || (memcmp(header.magic, CYBER_TRACE_MAGIC, sizeof(header.magic)) != 0)
+        || (header.version != CYBER_TRACE_VERSION))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    struct CyberTraceReader *reader = calloc(1, sizeof(struct CyberTraceReader));
+    if (reader == NULL) {
+        assert(reader != NULL); // halt here in debug builds
+        fclose(file);
+        return NULL;
+    }
+
+    reader->_file = file;
+    reader->_header = header;
+
+    return reader;
+}
+
+void CyberTraceReaderClose(struct CyberTraceReader * _Nullable reader)
+{
+    if (reader == NULL) return;
+
+    fclose(reader->_file);
+    free(reader->_buffer);
+    free(reader);
+}
+
+const struct CyberTraceFileHeader *CyberTraceReaderGetHeader(struct CyberTraceReader *reader)
+{
+    assert(reader != NULL);
+
+    return &reader->_header;
+}
+
+const void * _Nullable CyberTraceReaderNextChunk(struct CyberTraceReader *reader, struct CyberTraceChunkHeader *header)
+{
+    assert(reader != NULL);
+    assert(header != NULL);
+
+    if (fread(header, sizeof(struct CyberTraceChunkHeader), 1, reader->_file) != 1) {
+        return NULL;
+    }
+
+    if (header->length > reader->_bufferCapacity) {
+        void *buffer = realloc(reader->_buffer, header->length);
+        if (buffer == NULL) {
+            assert(buffer != NULL); // halt here in debug builds
+            return NULL;
+        }
+        reader->_buffer = buffer;
+        reader->_bufferCapacity = header->length;
+    }
+
+    if ((header->length > 0) && (fread(reader->_buffer, header->length, 1, reader->_file) != 1)) {
+        // The file was truncated mid-chunk.
+        return NULL;
+    }
+
+    return reader->_buffer;
+}
+
+
+/// Decode an unsigned LEB128 varint from the bytes up to `end`.
+///
+/// - Returns: The number of bytes decoded, or 0 if it's truncated or too long.
+static size_t CyberTraceDecodeVarint(const CyberWord8 *bytes, const CyberWord8 *end, uint64_t *value)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; (i < 10) && ((bytes + i) < end); i++) {
+        result |= (uint64_t)(bytes[i] & 0x7F) << (7 * i);
+        if ((bytes[i] & 0x80) == 0) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/// Decode a zigzag varint from the bytes up to `end`, as a difference to add.
+///
+/// - Returns: The number of bytes decoded, or 0 if it's truncated or too long.
+static size_t CyberTraceDecodeZigzag(const CyberWord8 *bytes, const CyberWord8 *end, uint64_t *value)
+{
+    uint64_t encoded = 0;
+    size_t length = CyberTraceDecodeVarint(bytes, end, &encoded);
+    *value = (encoded >> 1) ^ (0 - (encoded & 1));
+    return length;
+}
+
+size_t CyberInstructionTraceDecode(struct CyberInstructionTraceState *state, const void *bytes, size_t length, struct CyberInstructionRecord *record)
+{
+    assert(state != NULL);
+    assert(bytes != NULL);
+    assert(record != NULL);
+
+    const CyberWord8 *start = bytes;
+    const CyberWord8 *end = start + length;
+    const CyberWord8 *cursor = start;
+    size_t used;
+
+    if (cursor >= end) return 0;
+    const CyberWord8 flags = *cursor++;
+    const bool keyframe = (flags & CyberInstructionTraceFlagKeyframe) != 0;
+    if (!keyframe && !state->synchronized) return 0;
+
+    uint64_t address = state->address;
+    if (keyframe) {
+        if ((used = CyberTraceDecodeVarint(cursor, end, &address)) == 0) return 0;
+        cursor += used;
+    }
+
+    const uint8_t instructionLength = (flags & CyberInstructionTraceFlagLong) ? 4 : 2;
+    if ((size_t)(end - cursor) < instructionLength) return 0;
+    uint32_t instruction = ((uint32_t)cursor[0] << 24) | ((uint32_t)cursor[1] << 16);
+    if (instructionLength == 4) {
+        instruction |= ((uint32_t)cursor[2] << 8) | (uint32_t)cursor[3];
+    }
+    cursor += instructionLength;
+
+    uint64_t nextAddress = address + instructionLength;
+    if (flags & CyberInstructionTraceFlagJump) {
+        uint64_t difference = 0;
+        if ((used = CyberTraceDecodeZigzag(cursor, end, &difference)) == 0) return 0;
+        cursor += used;
+        nextAddress += difference;
+    }
+
+    // Decode the registers into a copy, so a malformed record leaves the state alone.
+    uint64_t registers[32];
+    memcpy(&registers[0], state->x, sizeof(state->x));
+    memcpy(&registers[16], state->a, sizeof(state->a));
+    uint32_t changedRegisters = 0;
+
+    if (keyframe) {
+        for (int r = 0; r < 32; r++) {
+            if ((used = CyberTraceDecodeVarint(cursor, end, &registers[r])) == 0) return 0;
+            cursor += used;
+        }
+        changedRegisters = UINT32_MAX;
+    } else if (flags & CyberInstructionTraceFlagRegisters) {
+        uint64_t mask = 0;
+        if ((used = CyberTraceDecodeVarint(cursor, end, &mask)) == 0) return 0;
+        cursor += used;
+        changedRegisters = (uint32_t)mask;
+        for (int r = 0; r < 32; r++) {
+            if ((changedRegisters & (1U << r)) == 0) continue;
+            uint64_t difference = 0;
+            if ((used = CyberTraceDecodeZigzag(cursor, end, &difference)) == 0) return 0;
+            cursor += used;
+            registers[r] += difference;
+        }
+    }
+
+    state->synchronized = true;
+    state->address = nextAddress;
+    memcpy(state->x, &registers[0], sizeof(state->x));
+    memcpy(state->a, &registers[16], sizeof(state->a));
+
+    record->address = address;
+    record->instruction = instruction;
+    record->length = instructionLength;
+    record->keyframe = keyframe;
+    record->changedRegisters = changedRegisters;
+
+    return (size_t)(cursor - start);
+}
+
+
+CYBER_SOURCE_END
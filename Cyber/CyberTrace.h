@@ -0,0 +1,284 @@
+//
+//  CyberTrace.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#ifndef __CYBER_CYBERTRACE_H__
+#define __CYBER_CYBERTRACE_H__
+
+CYBER_HEADER_BEGIN
+
+
+struct CyberTraceReader;
+
+
+/// The identifying bytes at the start of every trace file.
+#define CYBER_TRACE_MAGIC "CYBTRACE"
+
+/// The version of the trace file format.
+#define CYBER_TRACE_VERSION 1
+
+
+/// The number of trace streams, one for each processor a system can have: 2 Central Processors and 3 I/O Units of 20 Peripheral Processors.
+#define CYBER_TRACE_STREAM_COUNT 62
+
+/// The trace stream for a Central Processor.
+#define CYBER_TRACE_CP_STREAM(cp) (cp)
+
+/// The trace stream for a Peripheral Processor of an I/O Unit.
+#define CYBER_TRACE_PP_STREAM(iou, pp) (2 + ((iou) * 20) + (pp))
+
+
+/// What a trace file records.
+enum CyberTraceKind {
+
+    /// Guest `KEYPOINT` and `KPT` instructions, as ``CyberKeypointRecord``s.
+    CyberTraceKindKeypoint = 1,
+
+    /// Every instruction executed by a Central Processor, as delta-encoded instruction records.
+    CyberTraceKindInstruction = 2,
+
+    /// What each processor spent its time doing, as ``CyberTimelineRecord``s.
+    CyberTraceKindTimeline = 3,
+};
+
+
+/// The header at the start of a trace file.
+///
+/// A trace file is this header followed by chunks, each a ``CyberTraceChunkHeader`` followed by that many bytes of records from a single stream. Chunks from different streams are interleaved, but each stream's chunks are in order and never split a record. Every field is in host byte order.
+struct CyberTraceFileHeader {
+
+    /// The bytes of ``CYBER_TRACE_MAGIC``, without a terminating NUL.
+    char magic[8];
+
+    /// The version of the format, ``CYBER_TRACE_VERSION``.
+    uint32_t version;
+
+    /// What the file records, a ``CyberTraceKind``.
+    uint32_t kind;
+
+    /// The approximate number of host cycle counter ticks per second, for converting timestamps to time.
+    uint64_t ticksPerSecond;
+
+    /// The host cycle counter when tracing started.
+    uint64_t startTicks;
+};
+
+
+/// The header of a chunk of records from one stream.
+struct CyberTraceChunkHeader {
+
+    /// The stream the records came from.
+    uint32_t stream;
+
+    /// The number of bytes of records that follow.
+    uint32_t length;
+};
+
+
+/// The kind of processor that produced a trace record.
+enum CyberTraceProcessorKind {
+    CyberTraceProcessorKindCentral = 0,
+    CyberTraceProcessorKindPeripheral = 1,
+};
+
+
+/// A record of a guest keypoint.
+struct CyberKeypointRecord {
+
+    /// The host cycle counter when the keypoint was executed.
+    uint64_t ticks;
+
+    /// The address of the keypoint instruction, `P`.
+    uint64_t address;
+
+    /// The keypoint code: `Q` plus the right half of `Xk` for a Central Processor, `A` for a Peripheral Processor.
+    uint32_t code;
+
+    /// The kind of processor that executed the keypoint, a ``CyberTraceProcessorKind``.
+    uint8_t processorKind;
+
+    /// The I/O Unit of a Peripheral Processor; 0 for a Central Processor.
+    uint8_t inputOutputUnit;
+
+    /// The index of the processor, within its I/O Unit for a Peripheral Processor.
+    uint8_t processorIndex;
+
+    /// The keypoint class: `j` for a Central Processor, `d` for a Peripheral Processor.
+    uint8_t keypointClass;
+};
+
+
+/// The events recorded in a timeline trace.
+///
+/// A timeline trace has one stream for each processor, ``CYBER_TRACE_CP_STREAM`` and ``CYBER_TRACE_PP_STREAM``. Every stream a processor exists for begins with the state it was in when tracing started and ends with ``CyberTimelineEventEnd``, so each state lasts from its record to the next state or end record in the same stream.
+enum CyberTimelineEvent {
+
+    /// The processor started or resumed executing instructions.
+    CyberTimelineEventRunning = 1,
+
+    /// The processor's thread parked at a safepoint because the system was paused.
+    CyberTimelineEventParked = 2,
+
+    /// The processor stopped.
+    CyberTimelineEventStopped = 3,
+
+    /// Tracing stopped.
+    CyberTimelineEventEnd = 4,
+
+    /// The processor executed an exchange jump; `value` is the address of the instruction, `P`.
+    CyberTimelineEventExchange = 5,
+
+    /// A Central Processor monitor condition was raised; `value` is the condition's bit in the Monitor Condition Register.
+    CyberTimelineEventInterrupt = 6,
+
+    /// A Peripheral Processor activated channel `unit`.
+    CyberTimelineEventChannelActivate = 7,
+
+    /// A Peripheral Processor deactivated channel `unit`.
+    CyberTimelineEventChannelDeactivate = 8,
+
+    /// A Peripheral Processor read `value` words from channel `unit`, taking `duration`.
+    CyberTimelineEventChannelInput = 9,
+
+    /// A Peripheral Processor wrote `value` words to channel `unit`, taking `duration`.
+    CyberTimelineEventChannelOutput = 10,
+
+    /// The processor waited `duration` for the Central Memory access lock through port `unit`.
+    CyberTimelineEventLockWait = 11,
+};
+
+
+/// A record of a timeline event; which processor it concerns is given by its stream.
+struct CyberTimelineRecord {
+
+    /// The host cycle counter when the event happened or began.
+    uint64_t ticks;
+
+    /// How long the event lasted in host cycle counter ticks, or 0 for an instant.
+    uint64_t duration;
+
+    /// A value that depends on the event, a ``CyberTimelineEvent``.
+    uint64_t value;
+
+    /// The event, a ``CyberTimelineEvent``.
+    uint16_t event;
+
+    /// The channel or port the event concerns, if any.
+    uint16_t unit;
+
+    /// Reserved; always 0.
+    uint32_t reserved;
+};
+
+
+/// The flags that start each record of an instruction trace.
+///
+/// An instruction trace has one stream for each Central Processor, ``CYBER_TRACE_CP_STREAM``. Each record is a flags byte followed by:
+/// - For a keyframe, `P` as a varint.
+/// - The instruction, 2 or 4 bytes in Cyber (big-endian) byte order.
+/// - For a jump, the difference between the next `P` and the address following the instruction, as a zigzag varint.
+/// - For a keyframe, `X0` through `X15` and then `A0` through `A15` as varints; otherwise if registers changed, a varint mask of them (bit `i` for `Xi`, bit `16 + i` for `Ai`) followed by the difference in each as a zigzag varint.
+///
+/// Varints are unsigned LEB128, and a zigzag varint is a signed value mapped to an unsigned one as `(v << 1) ^ (v >> 63)`. Register values are those after the instruction executed.
+///
+/// Every stream begins with a keyframe, and a keyframe also follows any records dropped because a processor outran the trace writer, so decoding can always resume from one.
+enum CyberInstructionTraceFlags {
+
+    /// The record holds `P` and every register in full, rather than differences from the previous record.
+    CyberInstructionTraceFlagKeyframe = 0x01,
+
+    /// The next `P` isn't the address following the instruction.
+    CyberInstructionTraceFlagJump = 0x02,
+
+    /// The instruction is 4 bytes long rather than 2.
+    CyberInstructionTraceFlagLong = 0x04,
+
+    /// Registers changed; ignored in a keyframe.
+    CyberInstructionTraceFlagRegisters = 0x08,
+};
+
+
+/// The state of a Central Processor reconstructed by decoding an instruction trace stream.
+///
+/// Zero one of these for each stream before decoding its first record.
+struct CyberInstructionTraceState {
+
+    /// Whether a keyframe has been decoded, so the rest of the state is known.
+    bool synchronized;
+
+    /// The address of the next instruction, `P`.
+    uint64_t address;
+
+    /// The Operand Registers, after the most recently decoded instruction.
+    uint64_t x[16];
+
+    /// The Address Registers, after the most recently decoded instruction.
+    uint64_t a[16];
+};
+
+
+/// An instruction decoded from an instruction trace.
+struct CyberInstructionRecord {
+
+    /// The address of the instruction, `P`.
+    uint64_t address;
+
+    /// The instruction, with a 2-byte instruction in the upper 16 bits.
+    uint32_t instruction;
+
+    /// The length of the instruction in bytes, 2 or 4.
+    uint8_t length;
+
+    /// Whether the record was a keyframe, which may follow dropped records.
+    bool keyframe;
+
+    /// The registers the instruction changed, bit `i` for `Xi` and bit `16 + i` for `Ai`; every bit is set for a keyframe.
+    uint32_t changedRegisters;
+};
+
+
+/// Open a trace file for reading.
+///
+/// - Returns: A reader, or `NULL` if the file can't be opened or isn't a trace file of a version this can read.
+CYBER_EXPORT struct CyberTraceReader * _Nullable CyberTraceReaderOpen(const char *path);
+
+/// Close a trace file.
+CYBER_EXPORT void CyberTraceReaderClose(struct CyberTraceReader * _Nullable reader);
+
+/// Get the header of a trace file.
+CYBER_EXPORT const struct CyberTraceFileHeader *CyberTraceReaderGetHeader(struct CyberTraceReader *reader);
+
+/// Read the next chunk of records from a trace file.
+///
+/// - Returns: The chunk's records, which remain valid until the next call, or `NULL` at the end of the file.
+CYBER_EXPORT const void * _Nullable CyberTraceReaderNextChunk(struct CyberTraceReader *reader, struct CyberTraceChunkHeader *header);
+
+
+/// Decode the next record of an instruction trace stream, updating the stream's `state`.
+///
+/// Records never span chunks, so decode a chunk by calling this until it's consumed.
+///
+/// - Returns: The number of bytes decoded, or 0 if the record is malformed or truncated, or isn't a keyframe and `state` isn't yet synchronized.
+CYBER_EXPORT size_t CyberInstructionTraceDecode(struct CyberInstructionTraceState *state, const void *bytes, size_t length, struct CyberInstructionRecord *record);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERTRACE_H__ */
@@ -0,0 +1,218 @@
+//
+//  CyberTrace_Internal.h
+//  Cyber
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTrace.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef __CYBER_CYBERTRACE_INTERNAL_H__
+#define __CYBER_CYBERTRACE_INTERNAL_H__
+
+CYBER_HEADER_BEGIN
+
+
+struct CyberThread;
+
+
+/// A single-producer, single-consumer ring buffer of trace records.
+///
+/// The producer is the thread running a processor and the consumer is the trace's drain thread, so appending a record never takes a lock or waits; if the ring is full, the record is dropped.
+struct CyberTraceRing {
+
+    /// The ring's storage.
+    CyberWord8 *_bytes;
+
+    /// The mask to turn a position into an index in the ring, one less than its capacity.
+    uint64_t _mask;
+
+    /// The position after the last byte appended, on its own cache line since it's written by the producer.
+    CYBER_CACHE_ALIGNED _Atomic uint64_t _head;
+
+    /// The producer's most recent view of `_tail`, so it only has to read the consumer's cache line when the ring looks full.
+    uint64_t _cachedTail;
+
+    /// The number of records dropped because the ring was full; written only by the producer.
+    uint64_t _dropped;
+
+    /// The position of the next byte to drain, on its own cache line since it's written by the consumer.
+    CYBER_CACHE_ALIGNED _Atomic uint64_t _tail;
+};
+
+
+/// A trace: a ring for each stream, drained to a file by a thread of its own while tracing.
+struct CyberTrace {
+
+    /// What the trace records.
+    enum CyberTraceKind _kind;
+
+    /// The number of streams.
+    int _streamCount;
+
+    /// The ring for each stream.
+    struct CyberTraceRing *_rings;
+
+    /// The file being written, while tracing.
+    FILE * _Nullable _file;
+
+    /// The thread draining the rings to the file, while tracing.
+    struct CyberThread * _Nullable _thread;
+
+    /// The number of records each stream had dropped when tracing started.
+    uint64_t *_droppedAtStart;
+
+    /// Whether writing to the file has failed since tracing started; once it has, nothing more is written.
+    bool _writeFailed;
+
+    /// Whether records are being collected; read by every producer, so it's on a cache line of its own.
+    CYBER_CACHE_ALIGNED _Atomic bool _enabled;
+
+    /// A count of the times tracing has started, so producers that encode records as differences know to start over.
+    _Atomic uint32_t _generation;
+};
+
+
+/// The trace stream of the processor the calling thread is running, or -1 if it isn't running one.
+///
+/// Code any processor can reach, like Central Memory ports and I/O Channels, uses this to find the stream to append timeline records to.
+CYBER_EXPORT _Thread_local int CyberTraceCurrentStream;
+
+
+/// The most bytes an instruction trace record can take: flags, `P`, a 4-byte instruction, a jump, and 32 registers.
+#define CYBER_INSTRUCTION_TRACE_MAX_RECORD_BYTES (1 + 10 + 4 + 10 + (32 * 10))
+
+
+/// Create a trace with `streamCount` streams, each with a ring of `ringBytes` bytes, a power of two.
+CYBER_EXPORT struct CyberTrace * _Nullable CyberTraceCreate(enum CyberTraceKind kind, int streamCount, size_t ringBytes);
+
+/// Dispose of a trace, stopping it first if need be.
+///
+/// - Warning: No producer may be appending to the trace.
+CYBER_EXPORT void CyberTraceDispose(struct CyberTrace * _Nullable trace);
+
+/// Start tracing to a new file at `path`, discarding anything left in the rings.
+///
+/// - Returns: `true` on success, or `false` if the file couldn't be created.
+CYBER_EXPORT bool CyberTraceStart(struct CyberTrace *trace, const char *path);
+
+/// Stop tracing, draining what's left in the rings and closing the file.
+///
+/// - Parameters:
+///   - dropped: Set to the number of records dropped because a ring was full, if not `NULL`.
+///
+/// - Returns: `true` on success, or `false` if writing the file failed, for example because the disk filled up, leaving it truncated.
+CYBER_EXPORT bool CyberTraceStop(struct CyberTrace *trace, uint64_t * _Nullable dropped);
+
+
+/// Whether a trace is collecting records.
+static inline bool CyberTraceIsEnabled(struct CyberTrace *trace)
+{
+    return atomic_load_explicit(&trace->_enabled, memory_order_relaxed);
+}
+
+
+/// Get a count of the times a trace has started, which changes whenever it starts again.
+static inline uint32_t CyberTraceGetGeneration(struct CyberTrace *trace)
+{
+    return atomic_load_explicit(&trace->_generation, memory_order_relaxed);
+}
+
+
+/// Encode `value` as an unsigned LEB128 varint.
+///
+/// - Returns: The number of bytes written, at most 10.
+static inline size_t CyberTraceEncodeVarint(CyberWord8 *bytes, uint64_t value)
+{
+    size_t length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = (CyberWord8)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (CyberWord8)value;
+    return length;
+}
+
+
+/// Encode the signed difference `value` as a zigzag varint, so small negative differences stay small.
+///
+/// - Returns: The number of bytes written, at most 10.
+static inline size_t CyberTraceEncodeZigzag(CyberWord8 *bytes, uint64_t value)
+{
+    return CyberTraceEncodeVarint(bytes, (value << 1) ^ (uint64_t)((int64_t)value >> 63));
+}
+
+
+/// Append a record to a stream.
+///
+/// - Warning: Only one thread may append to a given stream.
+///
+/// - Returns: `true` if the record was appended, or `false` if it was dropped because the stream's ring is full.
+static inline bool CyberTraceAppend(struct CyberTrace *trace, int stream, const void *record, size_t length)
+{
+    struct CyberTraceRing *ring = &trace->_rings[stream];
+    const uint64_t capacity = ring->_mask + 1;
+    const uint64_t head = atomic_load_explicit(&ring->_head, memory_order_relaxed);
+
+    if ((head + length - ring->_cachedTail) > capacity) {
+        ring->_cachedTail = atomic_load_explicit(&ring->_tail, memory_order_acquire);
+        if ((head + length - ring->_cachedTail) > capacity) {
+            __atomic_store_n(&ring->_dropped, ring->_dropped + 1, __ATOMIC_RELAXED);
+            return false;
+        }
+    }
+
+    const uint64_t offset = head & ring->_mask;
+    if ((capacity - offset) >= length) {
+        memcpy(&ring->_bytes[offset], record, length);
+    } else {
+        const uint64_t first = capacity - offset;
+        memcpy(&ring->_bytes[offset], record, first);
+        memcpy(&ring->_bytes[0], (const CyberWord8 *)record + first, length - first);
+    }
+
+    // Publish the record only once it's entirely written.
+    atomic_store_explicit(&ring->_head, head + length, memory_order_release);
+
+    return true;
+}
+
+
+/// Append a ``CyberTimelineRecord`` to a stream, unless `stream` is -1.
+///
+/// - Warning: Only one thread may append to a given stream.
+static inline void CyberTraceAppendTimelineEvent(struct CyberTrace *trace, int stream, enum CyberTimelineEvent event, uint16_t unit, uint64_t value, uint64_t ticks, uint64_t duration)
+{
+    if (stream < 0) return;
+
+    struct CyberTimelineRecord record = {
+        .ticks = ticks,
+        .duration = duration,
+        .value = value,
+        .event = event,
+        .unit = unit,
+        .reserved = 0,
+    };
+    (void) CyberTraceAppend(trace, stream, &record, sizeof(record));
+}
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBER_CYBERTRACE_INTERNAL_H__ */
@@ -22,6 +22,7 @@
 #ifndef __CYBER_CYBERTYPES_H__
 #define __CYBER_CYBERTYPES_H__
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -70,7 +71,8 @@ typedef uint64_t CyberWord64;
 
 // MARK: - Endianness
 
-#if BIG_ENDIAN
+// Use the compiler's byte order rather than the host headers' BIG_ENDIAN, which is defined on every host once <sys/types.h> has been included.
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
 #define CYBER_BIG_ENDIAN 1
 #else
 #define CYBER_LITTLE_ENDIAN 1
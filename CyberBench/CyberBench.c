@@ -0,0 +1,1125 @@
+//
+//  CyberBench.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include "Cyber962PP_Internal.h"
+#include "NOSVEBootCode.h"
+
+#include <assert.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+
+/// The options for a benchmark run.
+struct CyberBenchOptions {
+
+    /// The configuration of the system to run.
+    struct Cyber962Configuration configuration;
+
+    /// A file to load into Central Memory at address 0, or `NULL`.
+    const char * _Nullable imagePath;
+
+    /// Whether to load the built-in NOS/VE boot code into Central Memory at address 0.
+    bool loadNOSVEBootCode;
+
+    /// A file of big-endian 16-bit words to load into each running Peripheral Processor's memory at address 1, or `NULL` for a built-in idle loop.
+    const char * _Nullable peripheralProcessorCodePath;
+
+    /// The number of Peripheral Processors to run in each I/O Unit.
+    int peripheralProcessors;
+
+    /// The number of Central Processor instructions to run for in total, or 0 to run for a time instead.
+    uint64_t instructions;
+
+    /// The number of seconds to run for, when not running for a number of instructions.
+    double seconds;
+
+    /// The microbenchmark suite to run instead of a system, or `NULL`.
+    const char * _Nullable suite;
+
+    /// The options for the microbenchmark suite.
+    struct CyberBenchSuiteOptions suiteOptions;
+
+    /// The file to write microbenchmark results to, or `NULL` for standard output.
+    const char * _Nullable jsonPath;
+
+    /// The access mix given for the Central Memory contention suite, if any.
+    struct CyberBenchMix mix;
+
+    /// A file to trace every Central Processor instruction of the run to, or `NULL`.
+    const char * _Nullable instructionTracePath;
+
+    /// An instruction trace to decode instead of running a system, or `NULL`.
+    const char * _Nullable replayPath;
+
+    /// The number of instructions to print when decoding an instruction trace.
+    uint64_t replayLimit;
+
+    /// A file to trace a timeline of every processor during the run to, or `NULL`.
+    const char * _Nullable timelineTracePath;
+
+    /// A timeline trace to convert to Chrome trace event JSON instead of running a system, or `NULL`.
+    const char * _Nullable exportTimelinePath;
+
+    /// A file to write a profile of where the guest spent its time during the run to, as folded stacks, or `NULL`.
+    const char * _Nullable profilePath;
+
+    /// The number of times a second to sample each processor while profiling.
+    double profileRate;
+
+    /// A symbol map for Central Processor addresses, or `NULL`.
+    const char * _Nullable centralProcessorSymbolsPath;
+
+    /// A symbol map for the addresses of each Peripheral Processor, or `NULL`.
+    const char * _Nullable peripheralProcessorSymbolsPaths[20];
+};
+
+
+/// The result of a benchmark run.
+struct CyberBenchResult {
+
+    /// The wall time of the run in seconds.
+    double seconds;
+
+    /// The number of instructions executed by each Central Processor.
+    uint64_t centralProcessorInstructions[2];
+
+    /// The number of instructions executed by all Peripheral Processors together.
+    uint64_t peripheralProcessorInstructions;
+
+    /// The host CPU time used by every thread of the process during the run, in seconds.
+    double hostSeconds;
+
+    /// The host cycles spent in user space by every thread of the process during the run, or 0 if they couldn't be counted.
+    uint64_t hostCycles;
+};
+
+
+/// Print usage information.
+static void CyberBenchUsage(FILE *file)
+{
+    fprintf(file,
+            "usage: cyberbench [options]\n"
+            "\n"
+            "System:\n"
+            "  --memory MB            Central Memory size in MB, a multiple of 64 (default 64)\n"
+            "  --cps N                Central Processors, 1 or 2 (default 1)\n"
+            "  --ious N               I/O Units, 1 or 2 (default 1)\n"
+            "  --pps N                Peripheral Processors to run per I/O Unit, 0 to 20 (default 0)\n"
+            "  --mode MODE            threaded or lockstep (default threaded)\n"
+            "  --cp-per-round N       CP instructions per lockstep round (default 1)\n"
+            "  --placement POLICY     none or isolated (default none)\n"
+            "\n"
+            "Code:\n"
+            "  --image PATH           load a Central Memory image at address 0\n"
+            "  --nosve                load the built-in NOS/VE boot code at address 0\n"
+            "  --pp-code PATH         load big-endian 16-bit PP words at PP address 1\n"
+            "                         (default: a loop of PSN instructions)\n"
+            "\n"
+            "Run:\n"
+            "  --instructions N       run until the CPs have executed N instructions in total\n"
+            "  --seconds S            run for S seconds (default 5)\n"
+            "\n"
+            "Microbenchmarks:\n"
+            "  --suite NAME           run a microbenchmark suite instead of a system:\n"
+            "                         cp (each Central Processor instruction)\n"
+            "                         pp (each Peripheral Processor instruction and CM transfer)\n"
+            "                         cm (Central Memory port contention)\n"
+            "                         state (thread handoffs through CyberState)\n"
+            "  --case-seconds S       time spent measuring each case (default 0.1)\n"
+            "  --trials N             trials per case, reporting the fastest (default 5)\n"
+            "  --ports N              cm: CM ports to drive at once, 1 to 5 (default: each)\n"
+            "  --mix SPEC             cm: access weights, e.g. read=70,write=20,block=5,rmw=5\n"
+            "                         (default: all reads, writes, blocks, rmws, then mixed)\n"
+            "  --ranges RANGES        cm: shared or disjoint address ranges (default: both)\n"
+            "  --block-words N        cm: words per block move, 1 to 4096 (default 8)\n"
+            "  --json PATH            write results as JSON to PATH (default stdout)\n"
+            "\n"
+            "Tracing:\n"
+            "  --trace-instructions PATH\n"
+            "                         trace every CP instruction of the run to PATH\n"
+            "  --replay PATH          decode an instruction trace instead of running a system\n"
+            "  --replay-limit N       print at most N decoded instructions (default: all)\n"
+            "  --trace-timeline PATH  trace a timeline of every processor during the run to PATH\n"
+            "  --export-timeline PATH convert a timeline trace to Chrome trace event JSON\n"
+            "                         instead of running a system, written to the --json PATH\n"
+            "\n"
+            "Profiling:\n"
+            "  --profile PATH         sample where each processor spends its time during the\n"
+            "                         run and write folded stacks for a flame graph to PATH\n"
+            "  --profile-rate HZ      samples per second of each processor (default 997)\n"
+            "  --cp-symbols PATH      name CP addresses with the symbol map at PATH\n"
+            "  --pp-symbols [N=]PATH  name PP addresses with the symbol map at PATH, for every\n"
+            "                         PP or just PP N (octal); may be repeated\n"
+            "\n"
+            "  --help                 show this help\n");
+}
+
+
+/// Parse the command line into `options`.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+static bool CyberBenchParseOptions(int argc, char * _Nonnull argv[_Nonnull], struct CyberBenchOptions *options)
+{
+    enum {
+        OptionMemory = 1000, OptionCPs, OptionIOUs, OptionPPs, OptionMode, OptionCPPerRound, OptionPlacement,
+        OptionImage, OptionNOSVE, OptionPPCode, OptionInstructions, OptionSeconds,
+        OptionSuite, OptionCaseSeconds, OptionTrials, OptionPorts, OptionMix, OptionRanges, OptionBlockWords,
+        OptionJSON, OptionTraceInstructions, OptionReplay, OptionReplayLimit,
+        OptionTraceTimeline, OptionExportTimeline,
+        OptionProfile, OptionProfileRate, OptionCPSymbols, OptionPPSymbols, OptionHelp,
+    };
+
+    static const struct option longOptions[] = {
+        { "memory",         required_argument, NULL, OptionMemory },
+        { "cps",            required_argument, NULL, OptionCPs },
+        { "ious",           required_argument, NULL, OptionIOUs },
+        { "pps",            required_argument, NULL, OptionPPs },
+        { "mode",           required_argument, NULL, OptionMode },
+        { "cp-per-round",   required_argument, NULL, OptionCPPerRound },
+        { "placement",      required_argument, NULL, OptionPlacement },
+        { "image",          required_argument, NULL, OptionImage },
+        { "nosve",          no_argument,       NULL, OptionNOSVE },
+        { "pp-code",        required_argument, NULL, OptionPPCode },
+        { "instructions",   required_argument, NULL, OptionInstructions },
+        { "seconds",        required_argument, NULL, OptionSeconds },
+        { "suite",          required_argument, NULL, OptionSuite },
+        { "case-seconds",   required_argument, NULL, OptionCaseSeconds },
+        { "trials",         required_argument, NULL, OptionTrials },
+        { "ports",          required_argument, NULL, OptionPorts },
+        { "mix",            required_argument, NULL, OptionMix },
+        { "ranges",         required_argument, NULL, OptionRanges },
+        { "block-words",    required_argument, NULL, OptionBlockWords },
+        { "json",           required_argument, NULL, OptionJSON },
+        { "trace-instructions", required_argument, NULL, OptionTraceInstructions },
+        { "replay",         required_argument, NULL, OptionReplay },
+        { "replay-limit",   required_argument, NULL, OptionReplayLimit },
+        { "trace-timeline", required_argument, NULL, OptionTraceTimeline },
+        { "export-timeline", required_argument, NULL, OptionExportTimeline },
+        { "profile",        required_argument, NULL, OptionProfile },
+        { "profile-rate",   required_argument, NULL, OptionProfileRate },
+        { "cp-symbols",     required_argument, NULL, OptionCPSymbols },
+        { "pp-symbols",     required_argument, NULL, OptionPPSymbols },
+        { "help",           no_argument,       NULL, OptionHelp },
+        { NULL, 0, NULL, 0 },
+    };
+
+    *options = (struct CyberBenchOptions){
+        .configuration = {
+            .memorySize = (64 * 1024 * 1024),
+            .centralProcessors = 1,
+            .inputOutputUnits = 1,
+            .runMode = Cyber962RunModeThreaded,
+            .centralProcessorInstructionsPerRound = 1,
+            .placementPolicy = Cyber962PlacementPolicyNone,
+        },
+        .seconds = 5.0,
+        .suiteOptions = {
+            .caseSeconds = 0.1,
+            .trials = 5,
+            .ports = 0,
+            .ranges = CyberBenchRangesAll,
+            .mix = NULL,
+            .blockWords = 8,
+        },
+        .replayLimit = UINT64_MAX,
+        .profileRate = 997.0,
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "", longOptions, NULL)) != -1) {
+        switch (option) {
+            case OptionMemory: {
+                long megabytes = strtol(optarg, NULL, 10);
+                if ((megabytes <= 0) || ((megabytes % 64) != 0)) {
+                    fprintf(stderr, "cyberbench: memory size must be a positive multiple of 64MB\n");
+                    return false;
+                }
+                options->configuration.memorySize = (size_t)megabytes * 1024 * 1024;
+            } break;
+
+            case OptionCPs:
+                options->configuration.centralProcessors = atoi(optarg);
+                if ((options->configuration.centralProcessors < 1) || (options->configuration.centralProcessors > 2)) {
+                    fprintf(stderr, "cyberbench: there must be 1 or 2 CPs\n");
+                    return false;
+                }
+                break;
+
+            case OptionIOUs:
+                options->configuration.inputOutputUnits = atoi(optarg);
+                if ((options->configuration.inputOutputUnits < 1) || (options->configuration.inputOutputUnits > 2)) {
+                    fprintf(stderr, "cyberbench: there must be 1 or 2 IOUs\n");
+                    return false;
+                }
+                break;
+
+            case OptionPPs:
+                options->peripheralProcessors = atoi(optarg);
+                if ((options->peripheralProcessors < 0) || (options->peripheralProcessors > 20)) {
+                    fprintf(stderr, "cyberbench: there must be 0 to 20 PPs per IOU\n");
+                    return false;
+                }
+                break;
+
+            case OptionMode:
+                if (strcmp(optarg, "threaded") == 0) {
+                    options->configuration.runMode = Cyber962RunModeThreaded;
+                } else if (strcmp(optarg, "lockstep") == 0) {
+                    options->configuration.runMode = Cyber962RunModeLockstep;
+                } else {
+                    fprintf(stderr, "cyberbench: unknown mode '%s'\n", optarg);
+                    return false;
+                }
+                break;
+
+            case OptionCPPerRound:
+                options->configuration.centralProcessorInstructionsPerRound = atoi(optarg);
+                if (options->configuration.centralProcessorInstructionsPerRound < 1) {
+                    fprintf(stderr, "cyberbench: CP instructions per round must be positive\n");
+                    return false;
+                }
+                break;
+
+            case OptionPlacement:
+                if (strcmp(optarg, "none") == 0) {
+                    options->configuration.placementPolicy = Cyber962PlacementPolicyNone;
+                } else if (strcmp(optarg, "isolated") == 0) {
+                    options->configuration.placementPolicy = Cyber962PlacementPolicyIsolated;
+                } else {
+                    fprintf(stderr, "cyberbench: unknown placement policy '%s'\n", optarg);
+                    return false;
+                }
+                break;
+
+            case OptionImage:
+                options->imagePath = optarg;
+                break;
+
+            case OptionNOSVE:
+                options->loadNOSVEBootCode = true;
+                break;
+
+            case OptionPPCode:
+                options->peripheralProcessorCodePath = optarg;
+                break;
+
+            case OptionInstructions:
+                options->instructions = strtoull(optarg, NULL, 10);
+                if (options->instructions == 0) {
+                    fprintf(stderr, "cyberbench: instruction count must be positive\n");
+                    return false;
+                }
+                break;
+
+            case OptionSeconds:
+                options->seconds = strtod(optarg, NULL);
+                if (options->seconds <= 0) {
+                    fprintf(stderr, "cyberbench: run time must be positive\n");
+                    return false;
+                }
+                break;
+
+            case OptionSuite:
+                if ((strcmp(optarg, "cp") == 0) || (strcmp(optarg, "pp") == 0) || (strcmp(optarg, "cm") == 0) || (strcmp(optarg, "state") == 0)) {
+                    options->suite = optarg;
+                } else {
+                    fprintf(stderr, "cyberbench: unknown suite '%s'\n", optarg);
+                    return false;
+                }
+                break;
+
+            case OptionCaseSeconds:
+                options->suiteOptions.caseSeconds = strtod(optarg, NULL);
+                if (options->suiteOptions.caseSeconds <= 0) {
+                    fprintf(stderr, "cyberbench: case time must be positive\n");
+                    return false;
+                }
+                break;
+
+            case OptionTrials:
+                options->suiteOptions.trials = atoi(optarg);
+                if (options->suiteOptions.trials < 1) {
+                    fprintf(stderr, "cyberbench: there must be at least 1 trial\n");
+                    return false;
+                }
+                break;
+
+            case OptionPorts:
+                options->suiteOptions.ports = atoi(optarg);
+                if ((options->suiteOptions.ports < 1) || (options->suiteOptions.ports > 5)) {
+                    fprintf(stderr, "cyberbench: there must be 1 to 5 ports\n");
+                    return false;
+                }
+                break;
+
+            case OptionMix:
+                if (!CyberBenchParseMix(optarg, &options->mix)) {
+                    fprintf(stderr, "cyberbench: malformed mix '%s'\n", optarg);
+                    return false;
+                }
+                options->suiteOptions.mix = &options->mix;
+                break;
+
+            case OptionRanges:
+                if (strcmp(optarg, "shared") == 0) {
+                    options->suiteOptions.ranges = CyberBenchRangesShared;
+                } else if (strcmp(optarg, "disjoint") == 0) {
+                    options->suiteOptions.ranges = CyberBenchRangesDisjoint;
+                } else {
+                    fprintf(stderr, "cyberbench: unknown ranges '%s'\n", optarg);
+                    return false;
+                }
+                break;
+
+            case OptionBlockWords:
+                options->suiteOptions.blockWords = atoi(optarg);
+                if ((options->suiteOptions.blockWords < 1) || (options->suiteOptions.blockWords > 4096)) {
+                    fprintf(stderr, "cyberbench: there must be 1 to 4096 words per block move\n");
+                    return false;
+                }
+                break;
+
+            case OptionJSON:
+                options->jsonPath = optarg;
+                break;
+
+            case OptionTraceInstructions:
+                options->instructionTracePath = optarg;
+                break;
+
+            case OptionReplay:
+                options->replayPath = optarg;
+                break;
+
+            case OptionReplayLimit:
+                options->replayLimit = strtoull(optarg, NULL, 10);
+                break;
+
+            case OptionTraceTimeline:
+                options->timelineTracePath = optarg;
+                break;
+
+            case OptionExportTimeline:
+                options->exportTimelinePath = optarg;
+                break;
+
+            case OptionProfile:
+                options->profilePath = optarg;
+                break;
+
+            case OptionProfileRate:
+                options->profileRate = strtod(optarg, NULL);
+                if ((options->profileRate <= 0.0) || (options->profileRate > 100000.0)) {
+                    fprintf(stderr, "cyberbench: the profile rate must be above 0 and at most 100000\n");
+                    return false;
+                }
+                break;
+
+            case OptionCPSymbols:
+                options->centralProcessorSymbolsPath = optarg;
+                break;
+
+            case OptionPPSymbols: {
+                // A map for one PP is given as N=PATH; anything else is a map for every PP that doesn't have its own.
+                char *end = NULL;
+                long pp = strtol(optarg, &end, 8);
+                if ((end != optarg) && (*end == '=')) {
+                    if ((pp < 0) || (pp >= 20)) {
+                        fprintf(stderr, "cyberbench: there are only PPs 0 to 23 (octal)\n");
+                        return false;
+                    }
+                    options->peripheralProcessorSymbolsPaths[pp] = end + 1;
+                } else {
+                    for (int i = 0; i < 20; i++) {
+                        if (options->peripheralProcessorSymbolsPaths[i] == NULL) {
+                            options->peripheralProcessorSymbolsPaths[i] = optarg;
+                        }
+                    }
+                }
+            } break;
+
+            case OptionHelp:
+                CyberBenchUsage(stdout);
+                exit(EXIT_SUCCESS);
+
+            default:
+                CyberBenchUsage(stderr);
+                return false;
+        }
+    }
+
+    if (optind < argc) {
+        fprintf(stderr, "cyberbench: unexpected argument '%s'\n", argv[optind]);
+        return false;
+    }
+
+    if ((options->imagePath != NULL) && options->loadNOSVEBootCode) {
+        fprintf(stderr, "cyberbench: --image and --nosve are mutually exclusive\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+/// Read a whole file into a newly-allocated buffer, which the caller must free.
+///
+/// - Returns: The buffer, or `NULL` after reporting an error.
+static CyberWord8 * _Nullable CyberBenchReadFile(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
+
+    CyberWord8 *buffer = NULL;
+    size_t capacity = 0;
+    size_t used = 0;
+
+    for (;;) {
+        if (used == capacity) {
+            capacity = (capacity == 0) ? 65536 : (capacity * 2);
+            CyberWord8 *newBuffer = realloc(buffer, capacity);
+            if (newBuffer == NULL) {
+                fprintf(stderr, "cyberbench: out of memory reading %s\n", path);
+                free(buffer);
+                fclose(file);
+                return NULL;
+            }
+            buffer = newBuffer;
+        }
+
+        size_t count = fread(buffer + used, 1, capacity - used, file);
+        used += count;
+        if (count == 0) break;
+    }
+
+    bool failed = ferror(file);
+    fclose(file);
+
+    if (failed) {
+        perror(path);
+        free(buffer);
+        return NULL;
+    }
+
+    *length = used;
+    return buffer;
+}
+
+
+/// Load the Central Memory and Peripheral Processor code given in the options.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+static bool CyberBenchLoadCode(struct Cyber962 *system, const struct CyberBenchOptions *options)
+{
+    struct Cyber180CMPort *port = Cyber180CPGetCentralMemoryPort(Cyber962GetCentralProcessor(system, 0));
+
+    if (options->loadNOSVEBootCode) {
+        Cyber180CMPortWriteBytesPhysical(port, 0, NOSVEBootCode, NOSVEBootCodeLength);
+    } else if (options->imagePath != NULL) {
+        size_t length = 0;
+        CyberWord8 *image = CyberBenchReadFile(options->imagePath, &length);
+        if (image == NULL) return false;
+
+        if (length > options->configuration.memorySize) {
+            fprintf(stderr, "cyberbench: %s is larger than Central Memory\n", options->imagePath);
+            free(image);
+            return false;
+        }
+
+        Cyber180CMPortWriteBytesPhysical(port, 0, image, (CyberWord32)length);
+        free(image);
+    }
+
+    if (options->peripheralProcessors == 0) return true;
+
+    // PP code is a sequence of 12-bit words, stored as big-endian 16-bit words. The default is seven PSN instructions followed by a UJN back to the first.
+    CyberWord16 code[8190];
+    CyberWord16 codeLength = 0;
+
+    if (options->peripheralProcessorCodePath != NULL) {
+        size_t length = 0;
+        CyberWord8 *bytes = CyberBenchReadFile(options->peripheralProcessorCodePath, &length);
+        if (bytes == NULL) return false;
+
+        if ((length / 2) > (sizeof(code) / sizeof(code[0]))) {
+            fprintf(stderr, "cyberbench: %s is larger than PP memory\n", options->peripheralProcessorCodePath);
+            free(bytes);
+            return false;
+        }
+
+        for (size_t i = 0; (i + 1) < length; i += 2) {
+            code[codeLength++] = (CyberWord16)((bytes[i] << 8) | bytes[i + 1]);
+        }
+        free(bytes);
+    } else {
+        for (int i = 0; i < 7; i++) {
+            code[codeLength++] = 00000; // PSN
+        }
+        code[codeLength++] = (070 << 10) | (003 << 4); // UJN -7
+    }
+
+    for (int iou = 0; iou < options->configuration.inputOutputUnits; iou++) {
+        struct Cyber962IOU *inputOutputUnit = Cyber962GetInputOutputUnit(system, iou);
+        for (int pp = 0; pp < options->peripheralProcessors; pp++) {
+            struct Cyber962PP *peripheralProcessor = Cyber962IOUGetPeripheralProcessor(inputOutputUnit, pp);
+            Cyber962PPWriteMultiple(peripheralProcessor, 1, code, codeLength);
+        }
+    }
+
+    return true;
+}
+
+
+double CyberBenchGetTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+
+struct CyberBenchMeasurement CyberBenchMeasure(const struct CyberBenchSuiteOptions *options, CyberBenchBatch batch, void *context, uint64_t instructionsPerBatch)
+{
+    struct CyberBenchMeasurement measurement = { .instructions = 0, .nanosecondsPerInstruction = INFINITY };
+
+    batch(context);
+
+    const double trialSeconds = options->caseSeconds / options->trials;
+
+    for (int trial = 0; trial < options->trials; trial++) {
+        uint64_t instructions = 0;
+        double start = CyberBenchGetTime();
+        double elapsed = 0;
+
+        do {
+            batch(context);
+            instructions += instructionsPerBatch;
+            elapsed = CyberBenchGetTime() - start;
+        } while (elapsed < trialSeconds);
+
+        double nanoseconds = (elapsed * 1e9) / (double)instructions;
+        if (nanoseconds < measurement.nanosecondsPerInstruction) {
+            measurement.nanosecondsPerInstruction = nanoseconds;
+        }
+        measurement.instructions += instructions;
+    }
+
+    return measurement;
+}
+
+
+void CyberBenchWriteMeasurement(struct CyberBenchJSON *json, const char *key, const struct CyberBenchMeasurement *measurement)
+{
+    CyberBenchJSONBeginObject(json, key);
+    CyberBenchJSONWriteInteger(json, "instructions", measurement->instructions);
+    CyberBenchJSONWriteNumber(json, "nsPerInstruction", measurement->nanosecondsPerInstruction);
+    CyberBenchJSONWriteNumber(json, "instructionsPerSecond", 1e9 / measurement->nanosecondsPerInstruction);
+    CyberBenchJSONEndObject(json);
+}
+
+
+/// Get the host CPU time used by every thread of the process so far, in seconds.
+static double CyberBenchGetHostSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+
+/// Open a counter of the host cycles spent in user space by the calling thread and every thread it creates afterward, so it must be opened before the system is created.
+///
+/// - Returns: The counter's file descriptor, or -1 if the host doesn't offer one to unprivileged processes; `perf stat -e cycles` can count them instead.
+static int CyberBenchOpenHostCycleCounter(void)
+{
+#if defined(__linux__)
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+
+/// Read a host cycle counter, or get 0 if there isn't one.
+static uint64_t CyberBenchReadHostCycles(int counter)
+{
+    uint64_t cycles = 0;
+    if ((counter < 0) || (read(counter, &cycles, sizeof(cycles)) != sizeof(cycles))) {
+        return 0;
+    }
+    return cycles;
+}
+
+
+/// Get the total number of instructions executed by all of a system's Central Processors.
+static uint64_t CyberBenchGetCentralProcessorInstructions(struct Cyber962 *system, const struct CyberBenchOptions *options)
+{
+    uint64_t total = 0;
+    for (int cp = 0; cp < options->configuration.centralProcessors; cp++) {
+        total += Cyber180CPGetInstructionCount(Cyber962GetCentralProcessor(system, cp));
+    }
+    return total;
+}
+
+
+/// Get whether a run is finished.
+static bool CyberBenchIsFinished(struct Cyber962 *system, const struct CyberBenchOptions *options, double start)
+{
+    if (options->instructions != 0) {
+        return CyberBenchGetCentralProcessorInstructions(system, options) >= options->instructions;
+    } else {
+        return (CyberBenchGetTime() - start) >= options->seconds;
+    }
+}
+
+
+/// Run the system until the run is finished, filling in `result`, with the host cycles counted by `hostCycleCounter` if it's not -1.
+static void CyberBenchRun(struct Cyber962 *system, const struct CyberBenchOptions *options, int hostCycleCounter, struct CyberBenchResult *result)
+{
+    const struct Cyber962Configuration *configuration = &options->configuration;
+
+    // Start the processors; in threaded mode they're held at a safepoint until everything is ready.
+    if (configuration->runMode == Cyber962RunModeThreaded) {
+        Cyber962PauseAll(system);
+    }
+
+    for (int cp = 0; cp < configuration->centralProcessors; cp++) {
+        Cyber180CPStart(Cyber962GetCentralProcessor(system, cp));
+    }
+
+    for (int iou = 0; iou < configuration->inputOutputUnits; iou++) {
+        struct Cyber962IOU *inputOutputUnit = Cyber962GetInputOutputUnit(system, iou);
+        for (int pp = 0; pp < options->peripheralProcessors; pp++) {
+            Cyber962PPStart(Cyber962IOUGetPeripheralProcessor(inputOutputUnit, pp));
+        }
+    }
+
+    const double start = CyberBenchGetTime();
+    const double hostStart = CyberBenchGetHostSeconds();
+    const uint64_t hostCyclesStart = CyberBenchReadHostCycles(hostCycleCounter);
+
+    if (configuration->runMode == Cyber962RunModeThreaded) {
+        Cyber962ResumeAll(system);
+
+        // Poll every millisecond, which is fine-grained enough for runs of a second or more.
+        const struct timespec interval = { .tv_sec = 0, .tv_nsec = 1000000 };
+        while (!CyberBenchIsFinished(system, options, start)) {
+            nanosleep(&interval, NULL);
+        }
+
+        Cyber962PauseAll(system);
+    } else {
+        // Run in batches of rounds between checks, sizing the last batch to hit an instruction count exactly.
+        const uint64_t instructionsPerRound = (uint64_t)configuration->centralProcessors * (uint64_t)configuration->centralProcessorInstructionsPerRound;
+        while (!CyberBenchIsFinished(system, options, start)) {
+            uint64_t rounds = 1024;
+            if (options->instructions != 0) {
+                uint64_t remaining = options->instructions - CyberBenchGetCentralProcessorInstructions(system, options);
+                uint64_t remainingRounds = (remaining + instructionsPerRound - 1) / instructionsPerRound;
+                if (remainingRounds < rounds) rounds = remainingRounds;
+            }
+            Cyber962RunLockstepRounds(system, rounds);
+        }
+    }
+
+    result->seconds = CyberBenchGetTime() - start;
+    result->hostSeconds = CyberBenchGetHostSeconds() - hostStart;
+    result->hostCycles = CyberBenchReadHostCycles(hostCycleCounter) - hostCyclesStart;
+
+    for (int cp = 0; cp < configuration->centralProcessors; cp++) {
+        result->centralProcessorInstructions[cp] = Cyber180CPGetInstructionCount(Cyber962GetCentralProcessor(system, cp));
+    }
+
+    for (int iou = 0; iou < configuration->inputOutputUnits; iou++) {
+        struct Cyber962IOU *inputOutputUnit = Cyber962GetInputOutputUnit(system, iou);
+        for (int pp = 0; pp < options->peripheralProcessors; pp++) {
+            result->peripheralProcessorInstructions += Cyber962PPGetInstructionCount(Cyber962IOUGetPeripheralProcessor(inputOutputUnit, pp));
+        }
+    }
+}
+
+
+/// Print the result of a run.
+static void CyberBenchReport(const struct CyberBenchOptions *options, const struct CyberBenchResult *result)
+{
+    const struct Cyber962Configuration *configuration = &options->configuration;
+
+    printf("system:     %d CP, %d IOU, %d PP running per IOU, %zuMB, %s, placement %s, %s layout\n",
+           configuration->centralProcessors,
+           configuration->inputOutputUnits,
+           options->peripheralProcessors,
+           configuration->memorySize / (1024 * 1024),
+           (configuration->runMode == Cyber962RunModeThreaded) ? "threaded" : "lockstep",
+           (configuration->placementPolicy == Cyber962PlacementPolicyIsolated) ? "isolated" : "none",
+           CYBER_PACKED_LAYOUT ? "packed" : "cache-line");
+    printf("wall time:  %.3f s\n", result->seconds);
+
+    uint64_t centralProcessorInstructions = 0;
+    for (int cp = 0; cp < configuration->centralProcessors; cp++) {
+        printf("CP %d:       %llu instructions, %.2f MIPS\n",
+               cp,
+               (unsigned long long)result->centralProcessorInstructions[cp],
+               (double)result->centralProcessorInstructions[cp] / result->seconds / 1e6);
+        centralProcessorInstructions += result->centralProcessorInstructions[cp];
+    }
+
+    printf("CP total:   %llu instructions, %.2f MIPS\n",
+           (unsigned long long)centralProcessorInstructions,
+           (double)centralProcessorInstructions / result->seconds / 1e6);
+    printf("PP total:   %llu instructions, %.2f MIPS\n",
+           (unsigned long long)result->peripheralProcessorInstructions,
+           (double)result->peripheralProcessorInstructions / result->seconds / 1e6);
+
+    // Normalize by the host work done rather than the wall time, so that processors contending for cache lines show up as fewer instructions for the same host effort.
+    const uint64_t instructions = centralProcessorInstructions + result->peripheralProcessorInstructions;
+    printf("host CPU:   %.3f s, %.2f emulated MIPS per host CPU\n",
+           result->hostSeconds,
+           (double)instructions / result->hostSeconds / 1e6);
+    if (result->hostCycles != 0) {
+        printf("cycles:     %llu host cycles in user space, %.4f emulated instructions per host cycle\n",
+               (unsigned long long)result->hostCycles,
+               (double)instructions / (double)result->hostCycles);
+    } else {
+        printf("cycles:     host cycles not counted; run under `perf stat -e cycles` to count them\n");
+    }
+}
+
+
+/// Print how each Central Memory port was used during a run.
+static void CyberBenchReportCentralMemoryPorts(struct Cyber962 *system, const struct CyberBenchResult *result)
+{
+    struct Cyber962Statistics statistics;
+    Cyber962GetStatistics(system, &statistics);
+
+    for (int port = 0; port < statistics.centralMemoryPortCount; port++) {
+        const struct Cyber180CMPortStatistics *portStatistics = &statistics.centralMemoryPorts[port];
+        printf("CM port %d:  %.2fM reads/s, %.2fM writes/s, %.2fM lock acquisitions/s (%.1f%% contended, %.3f s waiting)\n",
+               port,
+               (double)portStatistics->reads / result->seconds / 1e6,
+               (double)portStatistics->writes / result->seconds / 1e6,
+               (double)portStatistics->lockAcquisitions / result->seconds / 1e6,
+               (portStatistics->lockAcquisitions > 0) ? ((100.0 * (double)portStatistics->contendedLockAcquisitions) / (double)portStatistics->lockAcquisitions) : 0.0,
+               (double)portStatistics->lockWaitNanoseconds / 1e9);
+    }
+}
+
+
+/// The number of opcodes to list in opcode statistics, busiest first.
+#define CYBER_BENCH_TOP_OPCODES 16
+
+
+/// Print the opcodes that took the most host cycles, with how often they ran and their approximate cycle distributions.
+static void CyberBenchReportOpcodes(bool peripheral, const struct CyberOpcodeCounter *counters, int count)
+{
+    uint64_t totalCycles = 0;
+    int order[CYBER180CP_OPCODE_COUNT];
+    assert(count <= CYBER180CP_OPCODE_COUNT);
+
+    for (int opcode = 0; opcode < count; opcode++) {
+        totalCycles += counters[opcode].cycles;
+        order[opcode] = opcode;
+    }
+    if (totalCycles == 0) return;
+
+    // Selection sort is plenty for a few hundred opcodes.
+    for (int i = 0; (i < CYBER_BENCH_TOP_OPCODES) && (i < count); i++) {
+        int busiest = i;
+        for (int j = i + 1; j < count; j++) {
+            if (counters[order[j]].cycles > counters[order[busiest]].cycles) busiest = j;
+        }
+        int swap = order[i];
+        order[i] = order[busiest];
+        order[busiest] = swap;
+
+        const struct CyberOpcodeCounter *counter = &counters[order[i]];
+        if (counter->count == 0) break;
+
+        // PP opcodes are indexed by (g << 6) | f, so print them in the octal the documentation uses for f | (g << 9).
+        char opcodeName[16];
+        if (peripheral) {
+            snprintf(opcodeName, sizeof(opcodeName), "0%04o", (order[i] & 077) | ((order[i] >> 6) << 9));
+        } else {
+            snprintf(opcodeName, sizeof(opcodeName), "0x%02x", order[i]);
+        }
+        printf("%s %-6s %12llu executed, %5.1f%% of cycles, mean %6.0f, p50 <= %6llu, p99 <= %6llu cycles\n",
+               peripheral ? "PP" : "CP",
+               opcodeName,
+               (unsigned long long)counter->count,
+               (100.0 * (double)counter->cycles) / (double)totalCycles,
+               (double)counter->cycles / (double)counter->count,
+               (unsigned long long)CyberOpcodeCounterGetPercentileCycles(counter, 50.0),
+               (unsigned long long)CyberOpcodeCounterGetPercentileCycles(counter, 99.0));
+    }
+}
+
+
+/// Print the busiest opcodes of a run, if the framework collects opcode statistics.
+static void CyberBenchReportOpcodeStatistics(struct Cyber962 *system)
+{
+    if (!CyberOpcodeStatisticsAreEnabled()) return;
+
+    struct Cyber180CPOpcodeStatistics *centralProcessorStatistics = malloc(sizeof(struct Cyber180CPOpcodeStatistics));
+    struct Cyber962PPOpcodeStatistics *peripheralProcessorStatistics = malloc(sizeof(struct Cyber962PPOpcodeStatistics));
+    assert((centralProcessorStatistics != NULL) && (peripheralProcessorStatistics != NULL));
+
+    Cyber962GetCentralProcessorOpcodeStatistics(system, centralProcessorStatistics);
+    Cyber962GetPeripheralProcessorOpcodeStatistics(system, peripheralProcessorStatistics);
+
+    CyberBenchReportOpcodes(false, centralProcessorStatistics->opcodes, CYBER180CP_OPCODE_COUNT);
+    CyberBenchReportOpcodes(true, peripheralProcessorStatistics->opcodes, CYBER962PP_OPCODE_COUNT);
+
+    free(centralProcessorStatistics);
+    free(peripheralProcessorStatistics);
+}
+
+
+/// Run a microbenchmark suite, writing its results as JSON.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+static bool CyberBenchRunSuite(const struct CyberBenchOptions *options)
+{
+    FILE *file = stdout;
+    if (options->jsonPath != NULL) {
+        file = fopen(options->jsonPath, "w");
+        if (file == NULL) {
+            perror(options->jsonPath);
+            return false;
+        }
+    }
+
+    struct CyberBenchJSON json;
+    CyberBenchJSONInit(&json, file);
+
+    CyberBenchJSONBeginObject(&json, NULL);
+    CyberBenchJSONWriteString(&json, "suite", options->suite);
+    CyberBenchJSONWriteNumber(&json, "caseSeconds", options->suiteOptions.caseSeconds);
+    CyberBenchJSONWriteInteger(&json, "trials", (uint64_t)options->suiteOptions.trials);
+    CyberBenchJSONBeginArray(&json, "results");
+
+    if (strcmp(options->suite, "cp") == 0) {
+        CyberBenchRunCentralProcessorInstructionSuite(&options->suiteOptions, &json);
+    } else if (strcmp(options->suite, "pp") == 0) {
+        CyberBenchRunPeripheralProcessorInstructionSuite(&options->suiteOptions, &json);
+    } else if (strcmp(options->suite, "cm") == 0) {
+        CyberBenchRunCentralMemoryContentionSuite(&options->suiteOptions, &json);
+    } else if (strcmp(options->suite, "state") == 0) {
+        CyberBenchRunStateHandoffSuite(&options->suiteOptions, &json);
+    }
+
+    CyberBenchJSONEndArray(&json);
+    CyberBenchJSONEndObject(&json);
+
+    bool failed = (ferror(file) != 0);
+    if (file != stdout) {
+        failed = (fclose(file) != 0) || failed;
+    }
+    if (failed) {
+        fprintf(stderr, "cyberbench: couldn't write results\n");
+    }
+
+    return !failed;
+}
+
+
+/// Load the symbol maps given in `options`, loading a map shared by several Peripheral Processors only once.
+///
+/// - Returns: `true` on success, or `false` after reporting an error, with any maps that were loaded left for ``CyberBenchDisposeSymbolMaps``.
+static bool CyberBenchLoadSymbolMaps(const struct CyberBenchOptions *options, struct CyberSymbolMap * _Nullable * _Nonnull centralProcessorSymbols, struct CyberSymbolMap * _Nullable peripheralProcessorSymbols[_Nonnull 20])
+{
+    if (options->centralProcessorSymbolsPath != NULL) {
+        *centralProcessorSymbols = CyberSymbolMapCreateWithFile(options->centralProcessorSymbolsPath);
+        if (*centralProcessorSymbols == NULL) {
+            fprintf(stderr, "cyberbench: couldn't load symbol map %s\n", options->centralProcessorSymbolsPath);
+            return false;
+        }
+    }
+
+    for (int pp = 0; pp < 20; pp++) {
+        const char *path = options->peripheralProcessorSymbolsPaths[pp];
+        if (path == NULL) continue;
+
+        for (int earlier = 0; earlier < pp; earlier++) {
+            if (options->peripheralProcessorSymbolsPaths[earlier] == path) {
+                peripheralProcessorSymbols[pp] = peripheralProcessorSymbols[earlier];
+                break;
+            }
+        }
+        if (peripheralProcessorSymbols[pp] != NULL) continue;
+
+        peripheralProcessorSymbols[pp] = CyberSymbolMapCreateWithFile(path);
+        if (peripheralProcessorSymbols[pp] == NULL) {
+            fprintf(stderr, "cyberbench: couldn't load symbol map %s\n", path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/// Dispose of the symbol maps loaded by ``CyberBenchLoadSymbolMaps``.
+static void CyberBenchDisposeSymbolMaps(struct CyberSymbolMap * _Nullable centralProcessorSymbols, struct CyberSymbolMap * _Nullable peripheralProcessorSymbols[_Nonnull 20])
+{
+    CyberSymbolMapDispose(centralProcessorSymbols);
+
+    for (int pp = 0; pp < 20; pp++) {
+        bool shared = false;
+        for (int later = pp + 1; later < 20; later++) {
+            shared |= (peripheralProcessorSymbols[later] == peripheralProcessorSymbols[pp]);
+        }
+        if (!shared) {
+            CyberSymbolMapDispose(peripheralProcessorSymbols[pp]);
+        }
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    struct CyberBenchOptions options;
+    if (!CyberBenchParseOptions(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+
+    if (options.suite != NULL) {
+        return CyberBenchRunSuite(&options) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.replayPath != NULL) {
+        return CyberBenchReplayInstructionTrace(options.replayPath, options.replayLimit) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (options.exportTimelinePath != NULL) {
+        return CyberBenchExportTimeline(options.exportTimelinePath, options.jsonPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    struct CyberSymbolMap *centralProcessorSymbols = NULL;
+    struct CyberSymbolMap *peripheralProcessorSymbols[20] = { NULL };
+    if (!CyberBenchLoadSymbolMaps(&options, &centralProcessorSymbols, peripheralProcessorSymbols)) {
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    // Count host cycles from before the processor threads exist, so every one of them is counted.
+    const int hostCycleCounter = CyberBenchOpenHostCycleCounter();
+
+    struct Cyber962 *system = Cyber962CreateWithConfiguration("cyberbench", &options.configuration);
+    if (system == NULL) {
+        fprintf(stderr, "cyberbench: couldn't create system\n");
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    if (!CyberBenchLoadCode(system, &options)) {
+        Cyber962Dispose(system);
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    if ((options.instructionTracePath != NULL) && !Cyber962StartInstructionTrace(system, options.instructionTracePath)) {
+        perror(options.instructionTracePath);
+        Cyber962Dispose(system);
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    if ((options.timelineTracePath != NULL) && !Cyber962StartTimelineTrace(system, options.timelineTracePath)) {
+        perror(options.timelineTracePath);
+        Cyber962Dispose(system);
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    if ((options.profilePath != NULL) && !Cyber962StartProfiler(system, options.profileRate)) {
+        fprintf(stderr, "cyberbench: couldn't start the profiler\n");
+        Cyber962Dispose(system);
+        CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+        return EXIT_FAILURE;
+    }
+
+    struct CyberBenchResult result = { 0 };
+    CyberBenchRun(system, &options, hostCycleCounter, &result);
+
+    bool succeeded = true;
+    if (options.profilePath != NULL) {
+        struct CyberProfile *profile = Cyber962StopProfiler(system);
+        succeeded = (profile != NULL) && CyberBenchWriteProfile(profile, options.profilePath, centralProcessorSymbols, peripheralProcessorSymbols);
+        CyberProfileDispose(profile);
+    }
+
+    // The processors are paused or, in lockstep, idle, so every traced instruction is in the rings by now.
+    if (options.instructionTracePath != NULL) {
+        uint64_t dropped = 0;
+        if (Cyber962StopInstructionTrace(system, &dropped)) {
+            printf("trace:      %s, %llu records dropped\n", options.instructionTracePath, (unsigned long long)dropped);
+        } else {
+            fprintf(stderr, "cyberbench: couldn't write %s\n", options.instructionTracePath);
+            succeeded = false;
+        }
+    }
+    if (options.timelineTracePath != NULL) {
+        uint64_t dropped = 0;
+        if (Cyber962StopTimelineTrace(system, &dropped)) {
+            printf("timeline:   %s, %llu records dropped\n", options.timelineTracePath, (unsigned long long)dropped);
+        } else {
+            fprintf(stderr, "cyberbench: couldn't write %s\n", options.timelineTracePath);
+            succeeded = false;
+        }
+    }
+
+    CyberBenchReport(&options, &result);
+    CyberBenchReportCentralMemoryPorts(system, &result);
+    CyberBenchReportOpcodeStatistics(system);
+
+    if (!Cyber962Dispose(system)) {
+        fprintf(stderr, "cyberbench: processor threads didn't exit\n");
+        succeeded = false;
+    }
+    CyberBenchDisposeSymbolMaps(centralProcessorSymbols, peripheralProcessorSymbols);
+    if (hostCycleCounter >= 0) {
+        close(hostCycleCounter);
+    }
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
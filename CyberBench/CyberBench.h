@@ -0,0 +1,215 @@
+//
+//  CyberBench.h
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <Cyber/CyberTypes.h>
+
+#include <stdio.h>
+
+#ifndef __CYBERBENCH_CYBERBENCH_H__
+#define __CYBERBENCH_CYBERBENCH_H__
+
+CYBER_HEADER_BEGIN
+
+
+// MARK: - Timing
+
+/// Get the current value of the monotonic clock in seconds.
+double CyberBenchGetTime(void);
+
+
+// MARK: - JSON Output
+
+/// A writer of JSON to a file, tracking just enough nesting to place commas and indentation.
+struct CyberBenchJSON {
+
+    /// The file to write to.
+    FILE *_file;
+
+    /// The current nesting depth.
+    int _depth;
+
+    /// Whether the container at each depth already has an element, and so needs a comma before the next.
+    bool _hasElement[16];
+};
+
+/// Start writing JSON to `file`.
+void CyberBenchJSONInit(struct CyberBenchJSON *json, FILE *file);
+
+/// Begin an object, as the value of `key` in an enclosing object or as an element when `key` is `NULL`.
+void CyberBenchJSONBeginObject(struct CyberBenchJSON *json, const char * _Nullable key);
+
+/// End the innermost object.
+void CyberBenchJSONEndObject(struct CyberBenchJSON *json);
+
+/// Begin an array, as the value of `key` in an enclosing object or as an element when `key` is `NULL`.
+void CyberBenchJSONBeginArray(struct CyberBenchJSON *json, const char * _Nullable key);
+
+/// End the innermost array.
+void CyberBenchJSONEndArray(struct CyberBenchJSON *json);
+
+/// Write a string value.
+void CyberBenchJSONWriteString(struct CyberBenchJSON *json, const char * _Nullable key, const char *value);
+
+/// Write an integer value.
+void CyberBenchJSONWriteInteger(struct CyberBenchJSON *json, const char * _Nullable key, uint64_t value);
+
+/// Write a floating-point value.
+void CyberBenchJSONWriteNumber(struct CyberBenchJSON *json, const char * _Nullable key, double value);
+
+/// Write a number with exactly `places` digits after the decimal point, for values like timestamps that need more precision than ``CyberBenchJSONWriteNumber`` gives.
+void CyberBenchJSONWriteDecimal(struct CyberBenchJSON *json, const char * _Nullable key, double value, int places);
+
+
+// MARK: - Microbenchmark Suites
+
+/// Which address ranges the ports in a Central Memory contention case access.
+enum CyberBenchRanges {
+
+    /// Measure both shared and disjoint ranges.
+    CyberBenchRangesAll = 0,
+
+    /// All ports access the same range.
+    CyberBenchRangesShared = 1,
+
+    /// Each port accesses a range of its own.
+    CyberBenchRangesDisjoint = 2,
+};
+
+
+/// A mix of Central Memory accesses, as relative weights of each kind.
+struct CyberBenchMix {
+
+    /// The name of the mix.
+    const char *name;
+
+    /// The weight of single-word reads.
+    int read;
+
+    /// The weight of single-word writes.
+    int write;
+
+    /// The weight of block moves, which read a block and write it elsewhere.
+    int block;
+
+    /// The weight of read-modify-writes, like those `RDSL` and `RDCL` do.
+    int readModifyWrite;
+};
+
+
+/// Parse a mix specified as comma-separated `kind=weight` pairs, where the kinds are `read`, `write`, `block`, and `rmw`.
+///
+/// - Returns: `true` on success, or `false` if the specification is malformed or has no weight at all.
+bool CyberBenchParseMix(const char *specification, struct CyberBenchMix *mix);
+
+
+/// The options shared by microbenchmark suites.
+struct CyberBenchSuiteOptions {
+
+    /// The number of seconds to spend measuring each case.
+    double caseSeconds;
+
+    /// The number of timed trials to split each case into; the fastest is reported.
+    int trials;
+
+    /// The number of Central Memory ports to drive concurrently, or 0 for each number from 1 to 5.
+    int ports;
+
+    /// The address ranges for Central Memory contention cases.
+    enum CyberBenchRanges ranges;
+
+    /// The access mix for Central Memory contention cases, or `NULL` for a standard set of mixes.
+    const struct CyberBenchMix * _Nullable mix;
+
+    /// The number of words in each Central Memory block move.
+    int blockWords;
+};
+
+/// The result of timing a microbenchmark case.
+struct CyberBenchMeasurement {
+
+    /// The number of instructions executed across all trials.
+    uint64_t instructions;
+
+    /// The fastest trial's time per instruction.
+    double nanosecondsPerInstruction;
+};
+
+/// A function that executes one batch of a microbenchmark case.
+typedef void (*CyberBenchBatch)(void *context);
+
+/// Time a case by running batches of it, each executing `instructionsPerBatch` instructions, for the time and number of trials given in `options`.
+///
+/// One untimed batch is run first to warm up caches and branch predictors.
+struct CyberBenchMeasurement CyberBenchMeasure(const struct CyberBenchSuiteOptions *options, CyberBenchBatch batch, void *context, uint64_t instructionsPerBatch);
+
+/// Write a measurement as an object that's the value of `key`.
+void CyberBenchWriteMeasurement(struct CyberBenchJSON *json, const char *key, const struct CyberBenchMeasurement *measurement);
+
+/// Run the Central Processor instruction suite, writing its results to `json` as elements of the current array.
+void CyberBenchRunCentralProcessorInstructionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json);
+
+/// Run the Central Memory port contention suite, writing its results to `json` as elements of the current array.
+void CyberBenchRunCentralMemoryContentionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json);
+
+/// Run the Peripheral Processor instruction suite, including Central Memory transfers, writing its results to `json` as elements of the current array.
+void CyberBenchRunPeripheralProcessorInstructionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json);
+
+/// Run the thread handoff suite, which passes a value back and forth between two threads through ``CyberState``, writing its results to `json` as elements of the current array.
+///
+/// Each handoff counts as one instruction of the measurement.
+void CyberBenchRunStateHandoffSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json);
+
+
+
+// MARK: - Instruction Traces
+
+/// Decode an instruction trace, printing the first `limit` instructions along with the registers each changed, and then a summary.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+bool CyberBenchReplayInstructionTrace(const char *path, uint64_t limit);
+
+
+// MARK: - Timelines
+
+/// Convert the timeline trace at `tracePath` to Chrome trace event JSON, which Perfetto and `chrome://tracing` can show, written to `jsonPath` or standard output if it's `NULL`.
+///
+/// Each processor is a thread, grouped into a process for the Central Processors and one for each I/O Unit, and each channel a Peripheral Processor activates gets a thread of its own in its I/O Unit.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+bool CyberBenchExportTimeline(const char *tracePath, const char * _Nullable jsonPath);
+
+
+// MARK: - Profiles
+
+struct CyberProfile;
+struct CyberSymbolMap;
+
+/// Write a profile to `path` as folded stacks, one line per stack with its sample count, as taken by flame graph tools.
+///
+/// Each stack is a Central Processor, or an I/O Unit and one of its Peripheral Processors, followed by the symbol covering the sampled address in the processor's symbol map, or the address itself if there's no map or no symbol.
+///
+/// - Returns: `true` on success, or `false` after reporting an error.
+bool CyberBenchWriteProfile(struct CyberProfile *profile, const char *path,
+                            struct CyberSymbolMap * _Nullable centralProcessorSymbols,
+                            struct CyberSymbolMap * _Nullable const peripheralProcessorSymbols[_Nonnull 20]);
+
+
+CYBER_HEADER_END
+
+#endif /* __CYBERBENCH_CYBERBENCH_H__ */
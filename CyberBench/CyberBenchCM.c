@@ -0,0 +1,516 @@
+//
+//  CyberBenchCM.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+#include <Cyber/CyberThread.h>
+
+#include <assert.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The largest number of ports a Central Memory has: one for each of 2 CPs and 3 IOUs.
+#define CYBER_BENCH_CM_MAX_PORTS 5
+
+/// The size of the address range each port accesses.
+#define CYBER_BENCH_CM_RANGE_BYTES (64 * 1024)
+
+/// Where the first address range starts; disjoint ranges follow it.
+#define CYBER_BENCH_CM_RANGE_BASE 0x100000
+
+/// How many accesses a worker makes per call of its loop function.
+#define CYBER_BENCH_CM_BATCH 64
+
+/// A worker times one in this many accesses, to keep the timer's own cost out of the throughput.
+#define CYBER_BENCH_CM_SAMPLE_INTERVAL 8
+
+/// How many latency samples a worker keeps for each kind of access; beyond this, samples are kept by reservoir sampling.
+#define CYBER_BENCH_CM_SAMPLES 16384
+
+/// The largest block move.
+#define CYBER_BENCH_CM_MAX_BLOCK_WORDS 4096
+
+
+/// The kinds of access, in the order they appear in a ``CyberBenchMix``.
+enum CyberBenchCMAccess {
+    CyberBenchCMAccessRead = 0,
+    CyberBenchCMAccessWrite = 1,
+    CyberBenchCMAccessBlock = 2,
+    CyberBenchCMAccessReadModifyWrite = 3,
+    CyberBenchCMAccessCount = 4,
+};
+
+static const char * const CyberBenchCMAccessNames[CyberBenchCMAccessCount] = { "read", "write", "block", "rmw" };
+
+
+/// The standard mixes measured when no mix is given.
+static const struct CyberBenchMix CyberBenchCMStandardMixes[] = {
+    { "read",   100,   0,   0,   0 },
+    { "write",    0, 100,   0,   0 },
+    { "block",    0,   0, 100,   0 },
+    { "rmw",      0,   0,   0, 100 },
+    { "mixed",   70,  20,   5,   5 },
+};
+
+
+/// The phases of a case, which all workers follow.
+enum CyberBenchCMPhase {
+    CyberBenchCMPhaseWaiting = 0,
+    CyberBenchCMPhaseRunning = 1,
+    CyberBenchCMPhaseDone = 2,
+};
+
+
+/// The state shared by all workers in a case.
+struct CyberBenchCMShared {
+
+    /// The current phase.
+    _Atomic int phase;
+
+    /// The number of workers that have started and are waiting to run.
+    _Atomic int ready;
+};
+
+
+/// A worker driving one port, on a thread of its own.
+///
+/// Each worker is on cache lines of its own so that its counters don't contend with other workers'.
+struct CyberBenchCMWorker {
+
+    /// The shared state of the case.
+    struct CyberBenchCMShared *shared;
+
+    /// The port this worker drives.
+    struct Cyber180CMPort *port;
+
+    /// The first address of this worker's range.
+    CyberWord48 rangeBase;
+
+    /// The number of words in each block move.
+    int blockWords;
+
+    /// The cumulative weights of each kind of access, for choosing one.
+    int cumulativeWeights[CyberBenchCMAccessCount];
+
+    /// The sum of all weights.
+    int totalWeight;
+
+    /// The state of this worker's random number generator.
+    uint64_t random;
+
+    /// Whether this worker has counted itself as ready.
+    bool counted;
+
+    /// The number of accesses of each kind made while running.
+    uint64_t accesses[CyberBenchCMAccessCount];
+
+    /// The number of accesses of each kind that were timed, which may exceed the number of samples kept.
+    uint64_t sampled[CyberBenchCMAccessCount];
+
+    /// The latency samples kept for each kind of access, in nanoseconds.
+    uint32_t *samples[CyberBenchCMAccessCount];
+
+    /// A buffer for block moves.
+    CyberWord64 block[CYBER_BENCH_CM_MAX_BLOCK_WORDS];
+} CYBER_CACHE_ALIGNED;
+
+
+/// Get the current value of the monotonic clock in nanoseconds.
+static inline uint64_t CyberBenchCMGetNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
+/// Get the next value from a worker's random number generator (xorshift64).
+static inline uint64_t CyberBenchCMRandom(struct CyberBenchCMWorker *worker)
+{
+    uint64_t x = worker->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->random = x;
+    return x;
+}
+
+
+/// Get a random word-aligned address within a worker's range, leaving room for `words` words.
+static inline CyberWord48 CyberBenchCMRandomAddress(struct CyberBenchCMWorker *worker, int words)
+{
+    uint64_t rangeWords = (CYBER_BENCH_CM_RANGE_BYTES / 8) - (uint64_t)words + 1;
+    return worker->rangeBase + ((CyberBenchCMRandom(worker) % rangeWords) * 8);
+}
+
+
+/// Make a single access of the given kind.
+static inline void CyberBenchCMAccess(struct CyberBenchCMWorker *worker, enum CyberBenchCMAccess access)
+{
+    switch (access) {
+        case CyberBenchCMAccessRead: {
+            (void) Cyber180CMPortReadWordPhysical(worker->port, CyberBenchCMRandomAddress(worker, 1));
+        } break;
+
+        case CyberBenchCMAccessWrite: {
+            Cyber180CMPortWriteWordPhysical(worker->port, CyberBenchCMRandomAddress(worker, 1), worker->random);
+        } break;
+
+        case CyberBenchCMAccessBlock: {
+            Cyber180CMPortReadWordsPhysical(worker->port, CyberBenchCMRandomAddress(worker, worker->blockWords), worker->block, (CyberWord32)worker->blockWords);
+            Cyber180CMPortWriteWordsPhysical(worker->port, CyberBenchCMRandomAddress(worker, worker->blockWords), worker->block, (CyberWord32)worker->blockWords);
+        } break;
+
+        case CyberBenchCMAccessReadModifyWrite: {
+            // Alternate between setting and clearing bits, as RDSL and RDCL do.
+            CyberWord48 address = CyberBenchCMRandomAddress(worker, 1);
+            if (worker->random & 1) {
+                (void) Cyber180CMPortFetchOr64(worker->port, address, 1ULL << (worker->random % 64));
+            } else {
+                (void) Cyber180CMPortFetchAnd64(worker->port, address, ~(1ULL << (worker->random % 64)));
+            }
+        } break;
+
+        default:
+            assert(false); // should be unreachable
+            break;
+    }
+}
+
+
+/// Keep a latency sample, replacing an earlier one at random once a kind's samples are full.
+static inline void CyberBenchCMRecord(struct CyberBenchCMWorker *worker, enum CyberBenchCMAccess access, uint64_t nanoseconds)
+{
+    uint64_t seen = worker->sampled[access]++;
+    uint32_t sample = (nanoseconds > UINT32_MAX) ? UINT32_MAX : (uint32_t)nanoseconds;
+
+    if (seen < CYBER_BENCH_CM_SAMPLES) {
+        worker->samples[access][seen] = sample;
+    } else {
+        uint64_t slot = CyberBenchCMRandom(worker) % (seen + 1);
+        if (slot < CYBER_BENCH_CM_SAMPLES) {
+            worker->samples[access][slot] = sample;
+        }
+    }
+}
+
+
+/// The loop function of a worker's thread, which makes a batch of accesses while the case is running.
+static void CyberBenchCMWorkerLoop(struct CyberThread *thread, void * _Nullable workerv)
+{
+    struct CyberBenchCMWorker *worker = workerv;
+    struct CyberBenchCMShared *shared = worker->shared;
+
+    int phase = atomic_load_explicit(&shared->phase, memory_order_acquire);
+    if (phase != CyberBenchCMPhaseRunning) {
+        if ((phase == CyberBenchCMPhaseWaiting) && !worker->counted) {
+            worker->counted = true;
+            atomic_fetch_add_explicit(&shared->ready, 1, memory_order_release);
+        }
+        sched_yield();
+        return;
+    }
+
+    for (int i = 0; i < CYBER_BENCH_CM_BATCH; i++) {
+        int choice = (int)(CyberBenchCMRandom(worker) % (uint64_t)worker->totalWeight);
+        enum CyberBenchCMAccess access = CyberBenchCMAccessRead;
+        while (choice >= worker->cumulativeWeights[access]) {
+            access++;
+        }
+
+        if ((i % CYBER_BENCH_CM_SAMPLE_INTERVAL) == 0) {
+            uint64_t start = CyberBenchCMGetNanoseconds();
+            CyberBenchCMAccess(worker, access);
+            uint64_t end = CyberBenchCMGetNanoseconds();
+            CyberBenchCMRecord(worker, access, end - start);
+        } else {
+            CyberBenchCMAccess(worker, access);
+        }
+
+        worker->accesses[access] += 1;
+    }
+}
+
+
+/// Compare two latency samples for sorting.
+static int CyberBenchCMCompareSamples(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+/// Write the latency percentiles of a set of samples, sorting them in place, as the value of `key`.
+static void CyberBenchCMWriteLatency(struct CyberBenchJSON *json, const char *key, uint32_t *samples, size_t count)
+{
+    CyberBenchJSONBeginObject(json, key);
+    CyberBenchJSONWriteInteger(json, "samples", count);
+    if (count > 0) {
+        qsort(samples, count, sizeof(uint32_t), CyberBenchCMCompareSamples);
+        CyberBenchJSONWriteInteger(json, "p50Ns", samples[(count * 50) / 100]);
+        CyberBenchJSONWriteInteger(json, "p99Ns", samples[(count * 99) / 100]);
+        CyberBenchJSONWriteInteger(json, "maxNs", samples[count - 1]);
+    }
+    CyberBenchJSONEndObject(json);
+}
+
+
+/// Estimate the cost of reading the clock twice, which is included in every latency sample.
+static uint64_t CyberBenchCMMeasureTimerOverhead(void)
+{
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = CyberBenchCMGetNanoseconds();
+        uint64_t end = CyberBenchCMGetNanoseconds();
+        if ((end - start) < best) best = end - start;
+    }
+    return best;
+}
+
+
+/// Run and report one case: `ports` workers with the given mix and ranges.
+static void CyberBenchCMRunCase(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json, struct Cyber180CM *cm, int ports, enum CyberBenchRanges ranges, const struct CyberBenchMix *mix, uint64_t timerOverhead)
+{
+    struct CyberBenchCMShared shared = { .phase = CyberBenchCMPhaseWaiting, .ready = 0 };
+    struct CyberBenchCMWorker *workers[CYBER_BENCH_CM_MAX_PORTS] = { NULL };
+    struct CyberThread *threads[CYBER_BENCH_CM_MAX_PORTS] = { NULL };
+
+    const int weights[CyberBenchCMAccessCount] = { mix->read, mix->write, mix->block, mix->readModifyWrite };
+
+    for (int p = 0; p < ports; p++) {
+        struct CyberBenchCMWorker *worker = NULL;
+        int err = posix_memalign((void **)&worker, CYBER_CACHE_LINE_SIZE, sizeof(struct CyberBenchCMWorker));
+        if (err != 0) {
+            assert(err == 0); // halt here in debug builds
+            abort();
+        }
+        memset(worker, 0, sizeof(struct CyberBenchCMWorker));
+
+        worker->shared = &shared;
+        worker->port = Cyber180CMGetPortAtIndex(cm, p);
+        worker->rangeBase = CYBER_BENCH_CM_RANGE_BASE + ((ranges == CyberBenchRangesDisjoint) ? (CyberWord48)(p * CYBER_BENCH_CM_RANGE_BYTES) : 0);
+        worker->blockWords = options->blockWords;
+        worker->random = 0x9E3779B97F4A7C15ULL * (uint64_t)(p + 1);
+
+        int total = 0;
+        for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+            total += weights[a];
+            worker->cumulativeWeights[a] = total;
+            worker->samples[a] = calloc(CYBER_BENCH_CM_SAMPLES, sizeof(uint32_t));
+            assert(worker->samples[a] != NULL);
+        }
+        worker->totalWeight = total;
+
+        workers[p] = worker;
+    }
+
+    struct CyberThreadFunctions functions = { .loop = CyberBenchCMWorkerLoop };
+    for (int p = 0; p < ports; p++) {
+        char name[32];
+        snprintf(name, sizeof(name), "cyberbench.cm.%d", p);
+        threads[p] = CyberThreadCreate(name, &functions, workers[p]);
+        assert(threads[p] != NULL);
+        CyberThreadStart(threads[p]);
+    }
+
+    // Only start the clock once every worker is ready, so slow thread startup doesn't count against throughput.
+    while (atomic_load_explicit(&shared.ready, memory_order_acquire) < ports) {
+        sched_yield();
+    }
+
+    const double start = CyberBenchGetTime();
+    atomic_store_explicit(&shared.phase, CyberBenchCMPhaseRunning, memory_order_release);
+
+    const struct timespec interval = { .tv_sec = 0, .tv_nsec = 1000000 };
+    while ((CyberBenchGetTime() - start) < options->caseSeconds) {
+        nanosleep(&interval, NULL);
+    }
+
+    atomic_store_explicit(&shared.phase, CyberBenchCMPhaseDone, memory_order_release);
+    const double seconds = CyberBenchGetTime() - start;
+
+    for (int p = 0; p < ports; p++) {
+        CyberThreadDispose(threads[p]);
+    }
+
+    // Gather the results across workers.
+    uint64_t accesses[CyberBenchCMAccessCount] = { 0 };
+    uint64_t totalAccesses = 0;
+    uint32_t *samples[CyberBenchCMAccessCount];
+    size_t sampleCounts[CyberBenchCMAccessCount] = { 0 };
+    uint32_t *allSamples = calloc((size_t)ports * CyberBenchCMAccessCount * CYBER_BENCH_CM_SAMPLES, sizeof(uint32_t));
+    size_t allSampleCount = 0;
+    assert(allSamples != NULL);
+
+    for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+        samples[a] = calloc((size_t)ports * CYBER_BENCH_CM_SAMPLES, sizeof(uint32_t));
+        assert(samples[a] != NULL);
+
+        for (int p = 0; p < ports; p++) {
+            size_t kept = (workers[p]->sampled[a] < CYBER_BENCH_CM_SAMPLES) ? (size_t)workers[p]->sampled[a] : CYBER_BENCH_CM_SAMPLES;
+            memcpy(&samples[a][sampleCounts[a]], workers[p]->samples[a], kept * sizeof(uint32_t));
+            memcpy(&allSamples[allSampleCount], workers[p]->samples[a], kept * sizeof(uint32_t));
+            sampleCounts[a] += kept;
+            allSampleCount += kept;
+            accesses[a] += workers[p]->accesses[a];
+        }
+        totalAccesses += accesses[a];
+    }
+
+    CyberBenchJSONBeginObject(json, NULL);
+    CyberBenchJSONWriteInteger(json, "ports", (uint64_t)ports);
+    CyberBenchJSONWriteString(json, "ranges", (ranges == CyberBenchRangesShared) ? "shared" : "disjoint");
+    CyberBenchJSONBeginObject(json, "mix");
+    CyberBenchJSONWriteString(json, "name", mix->name);
+    for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+        CyberBenchJSONWriteInteger(json, CyberBenchCMAccessNames[a], (uint64_t)weights[a]);
+    }
+    CyberBenchJSONEndObject(json);
+    CyberBenchJSONWriteInteger(json, "blockWords", (uint64_t)options->blockWords);
+    CyberBenchJSONWriteNumber(json, "seconds", seconds);
+    CyberBenchJSONWriteInteger(json, "accesses", totalAccesses);
+    CyberBenchJSONWriteNumber(json, "accessesPerSecond", (double)totalAccesses / seconds);
+    CyberBenchJSONWriteInteger(json, "timerOverheadNs", timerOverhead);
+    CyberBenchCMWriteLatency(json, "latency", allSamples, allSampleCount);
+    CyberBenchJSONBeginObject(json, "byKind");
+    for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+        if (weights[a] == 0) continue;
+        CyberBenchJSONBeginObject(json, CyberBenchCMAccessNames[a]);
+        CyberBenchJSONWriteInteger(json, "accesses", accesses[a]);
+        CyberBenchJSONWriteNumber(json, "accessesPerSecond", (double)accesses[a] / seconds);
+        CyberBenchCMWriteLatency(json, "latency", samples[a], sampleCounts[a]);
+        CyberBenchJSONEndObject(json);
+    }
+    CyberBenchJSONEndObject(json);
+    CyberBenchJSONEndObject(json);
+
+    fprintf(stderr, "%d port%s %-8s %-6s %12.0f accesses/s  p50 %6u ns  p99 %6u ns\n",
+            ports, (ports == 1) ? " " : "s",
+            (ranges == CyberBenchRangesShared) ? "shared" : "disjoint",
+            mix->name,
+            (double)totalAccesses / seconds,
+            (allSampleCount > 0) ? allSamples[(allSampleCount * 50) / 100] : 0,
+            (allSampleCount > 0) ? allSamples[(allSampleCount * 99) / 100] : 0);
+
+    for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+        free(samples[a]);
+    }
+    free(allSamples);
+
+    for (int p = 0; p < ports; p++) {
+        for (int a = 0; a < CyberBenchCMAccessCount; a++) {
+            free(workers[p]->samples[a]);
+        }
+        free(workers[p]);
+    }
+}
+
+
+bool CyberBenchParseMix(const char *specification, struct CyberBenchMix *mix)
+{
+    *mix = (struct CyberBenchMix){ .name = specification };
+
+    const char *cursor = specification;
+    while (*cursor != '\0') {
+        const char *equals = strchr(cursor, '=');
+        if (equals == NULL) return false;
+
+        char *end = NULL;
+        long weight = strtol(equals + 1, &end, 10);
+        if ((end == equals + 1) || (weight < 0) || (weight > 1000)) return false;
+
+        size_t length = (size_t)(equals - cursor);
+        if ((length == 4) && (strncmp(cursor, "read", 4) == 0)) {
+            mix->read = (int)weight;
+        } else if ((length == 5) && (strncmp(cursor, "write", 5) == 0)) {
+            mix->write = (int)weight;
+        } else if ((length == 5) && (strncmp(cursor, "block", 5) == 0)) {
+            mix->block = (int)weight;
+        } else if ((length == 3) && (strncmp(cursor, "rmw", 3) == 0)) {
+            mix->readModifyWrite = (int)weight;
+        } else {
+            return false;
+        }
+
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return false;
+        }
+        cursor = end;
+    }
+
+    return (mix->read + mix->write + mix->block + mix->readModifyWrite) > 0;
+}
+
+
+void CyberBenchRunCentralMemoryContentionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json)
+{
+    assert((options->blockWords > 0) && (options->blockWords <= CYBER_BENCH_CM_MAX_BLOCK_WORDS));
+
+    // The system is only needed to own the Central Memory; its processors are never started.
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 1,
+    };
+    struct Cyber962 *system = Cyber962CreateWithConfiguration("cyberbench", &configuration);
+    assert(system != NULL);
+
+    struct Cyber180CM *cm = Cyber180CMCreate(system, (64 * 1024 * 1024), CYBER_BENCH_CM_MAX_PORTS);
+    assert(cm != NULL);
+
+    const uint64_t timerOverhead = CyberBenchCMMeasureTimerOverhead();
+
+    const int firstPorts = (options->ports != 0) ? options->ports : 1;
+    const int lastPorts = (options->ports != 0) ? options->ports : CYBER_BENCH_CM_MAX_PORTS;
+
+    const struct CyberBenchMix *mixes = (options->mix != NULL) ? options->mix : CyberBenchCMStandardMixes;
+    const size_t mixCount = (options->mix != NULL) ? 1 : (sizeof(CyberBenchCMStandardMixes) / sizeof(CyberBenchCMStandardMixes[0]));
+
+    for (int ports = firstPorts; ports <= lastPorts; ports++) {
+        for (enum CyberBenchRanges ranges = CyberBenchRangesShared; ranges <= CyberBenchRangesDisjoint; ranges++) {
+            if ((options->ranges != CyberBenchRangesAll) && (options->ranges != ranges)) continue;
+
+            // With one port, shared and disjoint ranges are the same thing.
+            if ((ports == 1) && (ranges == CyberBenchRangesDisjoint) && (options->ranges == CyberBenchRangesAll)) continue;
+
+            for (size_t m = 0; m < mixCount; m++) {
+                CyberBenchCMRunCase(options, json, cm, ports, ranges, &mixes[m], timerOverhead);
+            }
+        }
+    }
+
+    Cyber180CMDispose(cm);
+    Cyber962Dispose(system);
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,268 @@
+//
+//  CyberBenchCP.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include "Cyber180CP_Internal.h"
+#include "Cyber180CPInstructions_Internal.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+// Instruction words, in the same layout as `union Cyber180CPInstructionWord._raw`.
+
+#define CYBER_BENCH_JK(opcode, j, k)          ((((CyberWord32)(opcode)) << 24) | ((j) << 20) | ((k) << 16))
+#define CYBER_BENCH_JKQ(opcode, j, k, Q)      ((((CyberWord32)(opcode)) << 24) | ((j) << 20) | ((k) << 16) | ((Q) & 0xFFFF))
+#define CYBER_BENCH_JKID(opcode, j, k, i, D)  ((((CyberWord32)(opcode)) << 24) | ((j) << 20) | ((k) << 16) | ((i) << 12) | ((D) & 0xFFF))
+#define CYBER_BENCH_SJKID(S, j, k, i, D)      ((((CyberWord32)0xD) << 28) | ((S) << 24) | ((j) << 20) | ((k) << 16) | ((i) << 12) | ((D) & 0xFFF))
+
+
+/// Where the instructions executed via ``Cyber180CPSingleStep`` are placed in Central Memory.
+static const CyberWord48 CyberBenchCPCodeAddress = 0x1000;
+
+/// How many copies of an instruction are executed per batch; the code is this many copies back-to-back.
+#define CYBER_BENCH_CP_BATCH 1024
+
+/// Where operands in Central Memory are placed; `A1` points here, or just past here for unaligned cases.
+static const CyberWord48 CyberBenchCPDataAddress = 0x10000;
+
+
+/// A single instruction and operand pattern to measure.
+struct CyberBenchCPCase {
+
+    /// The instruction mnemonic.
+    const char *instruction;
+
+    /// The operand pattern.
+    const char *variant;
+
+    /// The instruction word.
+    CyberWord32 word;
+
+    /// The offset of `A1` from ``CyberBenchCPDataAddress``.
+    CyberWord48 offset;
+
+    /// The value of `X0`, which gives the byte count for some instructions.
+    CyberWord64 X0;
+};
+
+
+/// The cases to measure, which cover every implemented instruction the suite is interested in.
+///
+/// Register conventions: `A1` points at the operand area, `X1` is a source, `X2` a destination, and `X3` an index (of 0).
+///
+/// - Note: The BRxxx family isn't covered yet because its handlers aren't implemented.
+static const struct CyberBenchCPCase CyberBenchCPCases[] = {
+    { "INCX",   "X2+1",             CYBER_BENCH_JK(0x10, 1, 2),             0, 0 },
+    { "DECX",   "X2-1",             CYBER_BENCH_JK(0x11, 1, 2),             0, 0 },
+    { "ADDR",   "X2R+X1R",          CYBER_BENCH_JK(0x20, 1, 2),             0, 0 },
+    { "ADDX",   "X2+X1",            CYBER_BENCH_JK(0x24, 1, 2),             0, 0 },
+    { "ENTP",   "X2=1",             CYBER_BENCH_JK(0x3D, 1, 2),             0, 0 },
+    { "ENTE",   "X2=Q",             CYBER_BENCH_JKQ(0x8D, 0, 2, 0x1234),    0, 0 },
+
+    { "LX",     "aligned",          CYBER_BENCH_JKQ(0x82, 1, 2, 1),         0, 0 },
+    { "LX",     "unaligned",        CYBER_BENCH_JKQ(0x82, 1, 2, 1),         3, 0 },
+    { "SX",     "aligned",          CYBER_BENCH_JKQ(0x83, 1, 2, 1),         0, 0 },
+    { "SX",     "unaligned",        CYBER_BENCH_JKQ(0x83, 1, 2, 1),         3, 0 },
+    { "LXI",    "aligned",          CYBER_BENCH_JKID(0xA2, 1, 2, 3, 1),     0, 0 },
+    { "LXI",    "unaligned",        CYBER_BENCH_JKID(0xA2, 1, 2, 3, 1),     4, 0 },
+
+    { "LBYT",   "aligned,1",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 0 },
+    { "LBYT",   "aligned,2",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 1 },
+    { "LBYT",   "aligned,3",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 2 },
+    { "LBYT",   "aligned,4",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 3 },
+    { "LBYT",   "aligned,5",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 4 },
+    { "LBYT",   "aligned,6",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 5 },
+    { "LBYT",   "aligned,7",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 6 },
+    { "LBYT",   "aligned,8",        CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     0, 7 },
+    { "LBYT",   "unaligned,1",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 0 },
+    { "LBYT",   "unaligned,2",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 1 },
+    { "LBYT",   "unaligned,3",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 2 },
+    { "LBYT",   "unaligned,4",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 3 },
+    { "LBYT",   "unaligned,5",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 4 },
+    { "LBYT",   "unaligned,6",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 5 },
+    { "LBYT",   "unaligned,7",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 6 },
+    { "LBYT",   "unaligned,8",      CYBER_BENCH_JKID(0xA4, 1, 2, 3, 0),     3, 7 },
+
+    { "LBYTS",  "aligned,1",        CYBER_BENCH_SJKID(0, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,2",        CYBER_BENCH_SJKID(1, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,3",        CYBER_BENCH_SJKID(2, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,4",        CYBER_BENCH_SJKID(3, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,5",        CYBER_BENCH_SJKID(4, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,6",        CYBER_BENCH_SJKID(5, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,7",        CYBER_BENCH_SJKID(6, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "aligned,8",        CYBER_BENCH_SJKID(7, 1, 2, 3, 0),       0, 0 },
+    { "LBYTS",  "unaligned,1",      CYBER_BENCH_SJKID(0, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,2",      CYBER_BENCH_SJKID(1, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,3",      CYBER_BENCH_SJKID(2, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,4",      CYBER_BENCH_SJKID(3, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,5",      CYBER_BENCH_SJKID(4, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,6",      CYBER_BENCH_SJKID(5, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,7",      CYBER_BENCH_SJKID(6, 1, 2, 3, 0),       3, 0 },
+    { "LBYTS",  "unaligned,8",      CYBER_BENCH_SJKID(7, 1, 2, 3, 0),       3, 0 },
+
+    { "SBYTS",  "aligned,1",        CYBER_BENCH_SJKID(8, 1, 2, 3, 0),       0, 0 },
+    { "SBYTS",  "aligned,2",        CYBER_BENCH_SJKID(9, 1, 2, 3, 0),       0, 0 },
+    { "SBYTS",  "aligned,3",        CYBER_BENCH_SJKID(10, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "aligned,4",        CYBER_BENCH_SJKID(11, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "aligned,5",        CYBER_BENCH_SJKID(12, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "aligned,6",        CYBER_BENCH_SJKID(13, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "aligned,7",        CYBER_BENCH_SJKID(14, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "aligned,8",        CYBER_BENCH_SJKID(15, 1, 2, 3, 0),      0, 0 },
+    { "SBYTS",  "unaligned,1",      CYBER_BENCH_SJKID(8, 1, 2, 3, 0),       3, 0 },
+    { "SBYTS",  "unaligned,2",      CYBER_BENCH_SJKID(9, 1, 2, 3, 0),       3, 0 },
+    { "SBYTS",  "unaligned,3",      CYBER_BENCH_SJKID(10, 1, 2, 3, 0),      3, 0 },
+    { "SBYTS",  "unaligned,4",      CYBER_BENCH_SJKID(11, 1, 2, 3, 0),      3, 0 },
+    { "SBYTS",  "unaligned,5",      CYBER_BENCH_SJKID(12, 1, 2, 3, 0),      3, 0 },
+    { "SBYTS",  "unaligned,6",      CYBER_BENCH_SJKID(13, 1, 2, 3, 0),      3, 0 },
+    { "SBYTS",  "unaligned,7",      CYBER_BENCH_SJKID(14, 1, 2, 3, 0),      3, 0 },
+    { "SBYTS",  "unaligned,8",      CYBER_BENCH_SJKID(15, 1, 2, 3, 0),      3, 0 },
+
+    { "ISOM",   "pos=8,len=16",     CYBER_BENCH_JKID(0xAC, 0, 2, 0, (8 << 6) | 16), 0, 0 },
+};
+
+
+/// The state needed to execute batches of a case.
+struct CyberBenchCPContext {
+
+    /// The processor executing the case.
+    struct Cyber180CP *cp;
+
+    /// The handler for the case's instruction.
+    Cyber180CPInstruction handler;
+
+    /// The case's instruction word.
+    union Cyber180CPInstructionWord word;
+};
+
+
+/// Put a processor's registers into the state a case expects.
+static void CyberBenchCPPrepare(struct Cyber180CP *cp, const struct CyberBenchCPCase *benchCase)
+{
+    Cyber180CPSetA(cp, 1, CyberBenchCPDataAddress + benchCase->offset);
+    Cyber180CPSetX(cp, 0, benchCase->X0);
+    Cyber180CPSetX(cp, 1, 0x0123456789ABCDEF);
+    Cyber180CPSetX(cp, 2, 0);
+    Cyber180CPSetX(cp, 3, 0);
+}
+
+
+/// Execute a batch of a case by calling its handler directly, which isolates the handler from fetch and decode.
+static void CyberBenchCPRunHandlerBatch(void *contextv)
+{
+    struct CyberBenchCPContext *context = contextv;
+
+    for (int i = 0; i < CYBER_BENCH_CP_BATCH; i++) {
+        (void) context->handler(context->cp, context->word, CyberBenchCPCodeAddress);
+    }
+}
+
+
+/// Execute a batch of a case via ``Cyber180CPSingleStep``, which includes instruction fetch and decode.
+static void CyberBenchCPRunStepBatch(void *contextv)
+{
+    struct CyberBenchCPContext *context = contextv;
+
+    context->cp->_regP = CyberBenchCPCodeAddress;
+    for (int i = 0; i < CYBER_BENCH_CP_BATCH; i++) {
+        Cyber180CPSingleStep(context->cp);
+    }
+}
+
+
+void CyberBenchRunCentralProcessorInstructionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json)
+{
+    // A lockstep system never starts processor threads, so its CP can be driven directly from here.
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 1,
+    };
+    struct Cyber962 *system = Cyber962CreateWithConfiguration("cyberbench", &configuration);
+    assert(system != NULL);
+
+    struct Cyber180CP *cp = Cyber962GetCentralProcessor(system, 0);
+    struct Cyber180CMPort *port = Cyber180CPGetCentralMemoryPort(cp);
+
+    // Give loads something other than zeroes to read.
+    CyberWord8 data[256];
+    for (int i = 0; i < 256; i++) {
+        data[i] = (CyberWord8)i;
+    }
+    Cyber180CMPortWriteBytesPhysical(port, CyberBenchCPDataAddress, data, sizeof(data));
+
+    const size_t caseCount = sizeof(CyberBenchCPCases) / sizeof(CyberBenchCPCases[0]);
+    for (size_t c = 0; c < caseCount; c++) {
+        const struct CyberBenchCPCase *benchCase = &CyberBenchCPCases[c];
+
+        // Lay out a batch's worth of copies of the instruction, in Cyber (big-endian) byte order.
+        union Cyber180CPInstructionWord word = { ._raw = benchCase->word };
+        CyberWord32 advance = (CyberWord32)Cyber180CPInstructionAdvance(word);
+        CyberWord8 bytes[4] = {
+            (CyberWord8)(benchCase->word >> 24),
+            (CyberWord8)(benchCase->word >> 16),
+            (CyberWord8)(benchCase->word >>  8),
+            (CyberWord8)(benchCase->word >>  0),
+        };
+        for (int i = 0; i < CYBER_BENCH_CP_BATCH; i++) {
+            Cyber180CMPortWriteBytesPhysical(port, CyberBenchCPCodeAddress + (i * advance), bytes, advance);
+        }
+
+        struct CyberBenchCPContext context = {
+            .cp = cp,
+            .handler = Cyber180CPInstructionDecode(cp, word, CyberBenchCPCodeAddress),
+            .word = word,
+        };
+        assert(context.handler != NULL);
+
+        CyberBenchCPPrepare(cp, benchCase);
+        struct CyberBenchMeasurement handler = CyberBenchMeasure(options, CyberBenchCPRunHandlerBatch, &context, CYBER_BENCH_CP_BATCH);
+
+        CyberBenchCPPrepare(cp, benchCase);
+        struct CyberBenchMeasurement step = CyberBenchMeasure(options, CyberBenchCPRunStepBatch, &context, CYBER_BENCH_CP_BATCH);
+
+        char opcode[8];
+        snprintf(opcode, sizeof(opcode), "0x%02x", (unsigned)(benchCase->word >> 24));
+
+        CyberBenchJSONBeginObject(json, NULL);
+        CyberBenchJSONWriteString(json, "instruction", benchCase->instruction);
+        CyberBenchJSONWriteString(json, "variant", benchCase->variant);
+        CyberBenchJSONWriteString(json, "opcode", opcode);
+        CyberBenchWriteMeasurement(json, "handler", &handler);
+        CyberBenchWriteMeasurement(json, "step", &step);
+        CyberBenchJSONEndObject(json);
+
+        fprintf(stderr, "%-6s %-14s handler %7.2f ns  step %7.2f ns\n",
+                benchCase->instruction, benchCase->variant,
+                handler.nanosecondsPerInstruction, step.nanosecondsPerInstruction);
+    }
+
+    Cyber962Dispose(system);
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,159 @@
+//
+//  CyberBenchJSON.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <assert.h>
+#include <math.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// Write whatever needs to precede a new value: a comma if needed, indentation, and the key if any.
+static void CyberBenchJSONBeginValue(struct CyberBenchJSON *json, const char * _Nullable key)
+{
+    if (json->_depth > 0) {
+        fputs(json->_hasElement[json->_depth] ? ",\n" : "\n", json->_file);
+        json->_hasElement[json->_depth] = true;
+        fprintf(json->_file, "%*s", json->_depth * 2, "");
+    }
+
+    if (key != NULL) {
+        fprintf(json->_file, "\"%s\": ", key);
+    }
+}
+
+
+/// Begin a container, opened with `bracket`.
+static void CyberBenchJSONBeginContainer(struct CyberBenchJSON *json, const char * _Nullable key, char bracket)
+{
+    CyberBenchJSONBeginValue(json, key);
+    fputc(bracket, json->_file);
+
+    json->_depth += 1;
+    assert(json->_depth < (int)(sizeof(json->_hasElement) / sizeof(json->_hasElement[0])));
+    json->_hasElement[json->_depth] = false;
+}
+
+
+/// End a container, closed with `bracket`.
+static void CyberBenchJSONEndContainer(struct CyberBenchJSON *json, char bracket)
+{
+    assert(json->_depth > 0);
+
+    bool hadElement = json->_hasElement[json->_depth];
+    json->_depth -= 1;
+
+    if (hadElement) {
+        fprintf(json->_file, "\n%*s", json->_depth * 2, "");
+    }
+    fputc(bracket, json->_file);
+
+    if (json->_depth == 0) {
+        fputc('\n', json->_file);
+    }
+}
+
+
+void CyberBenchJSONInit(struct CyberBenchJSON *json, FILE *file)
+{
+    assert(json != NULL);
+    assert(file != NULL);
+
+    *json = (struct CyberBenchJSON){ ._file = file };
+}
+
+
+void CyberBenchJSONBeginObject(struct CyberBenchJSON *json, const char * _Nullable key)
+{
+    CyberBenchJSONBeginContainer(json, key, '{');
+}
+
+
+void CyberBenchJSONEndObject(struct CyberBenchJSON *json)
+{
+    CyberBenchJSONEndContainer(json, '}');
+}
+
+
+void CyberBenchJSONBeginArray(struct CyberBenchJSON *json, const char * _Nullable key)
+{
+    CyberBenchJSONBeginContainer(json, key, '[');
+}
+
+
+void CyberBenchJSONEndArray(struct CyberBenchJSON *json)
+{
+    CyberBenchJSONEndContainer(json, ']');
+}
+
+
+void CyberBenchJSONWriteString(struct CyberBenchJSON *json, const char * _Nullable key, const char *value)
+{
+    CyberBenchJSONBeginValue(json, key);
+
+    // Only the characters JSON requires are escaped; benchmark names and paths don't need more.
+    fputc('"', json->_file);
+    for (const char *c = value; *c != '\0'; c++) {
+        if ((*c == '"') || (*c == '\\')) {
+            fprintf(json->_file, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(json->_file, "\\u%04x", (unsigned char)*c);
+        } else {
+            fputc(*c, json->_file);
+        }
+    }
+    fputc('"', json->_file);
+}
+
+
+void CyberBenchJSONWriteInteger(struct CyberBenchJSON *json, const char * _Nullable key, uint64_t value)
+{
+    CyberBenchJSONBeginValue(json, key);
+    fprintf(json->_file, "%llu", (unsigned long long)value);
+}
+
+
+void CyberBenchJSONWriteNumber(struct CyberBenchJSON *json, const char * _Nullable key, double value)
+{
+    CyberBenchJSONBeginValue(json, key);
+
+    // JSON has no representation for infinities or NaN.
+    if (isfinite(value)) {
+        fprintf(json->_file, "%.6g", value);
+    } else {
+        fputs("null", json->_file);
+    }
+}
+
+
+void CyberBenchJSONWriteDecimal(struct CyberBenchJSON *json, const char * _Nullable key, double value, int places)
+{
+    CyberBenchJSONBeginValue(json, key);
+
+    if (isfinite(value)) {
+        fprintf(json->_file, "%.*f", places, value);
+    } else {
+        fputs("null", json->_file);
+    }
+}
+
+
+CYBER_SOURCE_END
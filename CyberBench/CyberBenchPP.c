@@ -0,0 +1,325 @@
+//
+//  CyberBenchPP.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include "Cyber962PP_Internal.h"
+#include "Cyber962PPInstructions_Internal.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// A PP instruction word for an opcode written as it is in the decoder (`g` as the octal 01000 bit, then `f`) and a `d` field.
+#define CYBER_BENCH_PP(opcode, d)  ((CyberWord16)((((opcode) >> 9) & 01) | (((opcode) & 077) << 4) | (((d) & 077) << 10)))
+
+
+// PP memory layout. PP memory is only 8192 words, so everything has to fit below that.
+
+/// The direct cell operated on by `(d)` instructions.
+#define CYBER_BENCH_PP_DIRECT 010
+
+/// The direct cell that `((d))` instructions start their indirection from.
+#define CYBER_BENCH_PP_INDIRECT 011
+
+/// The direct cell that `(m+(d))` instructions index by; it holds 0, so the address is just `m`.
+#define CYBER_BENCH_PP_INDEX 012
+
+/// The direct cell that holds the word count for block transfers.
+#define CYBER_BENCH_PP_COUNT 013
+
+/// The 4 direct cells that `RDSL` and `RDCL` operate on.
+#define CYBER_BENCH_PP_LOCK 020
+
+/// The 5 direct cells that `CRD` and `CWD` transfer.
+#define CYBER_BENCH_PP_WORD 030
+
+/// Where the instructions executed via ``Cyber962PPSingleStep`` are placed.
+#define CYBER_BENCH_PP_CODE 00100
+
+/// The operand area for indirect and memory addressing, which is also `m` for those instructions.
+#define CYBER_BENCH_PP_DATA 03000
+
+/// The start of PP memory for block transfers, which is `m` for them.
+#define CYBER_BENCH_PP_BLOCK 04000
+
+/// How many copies of an instruction are executed per batch; the code is this many copies back-to-back.
+#define CYBER_BENCH_PP_BATCH 256
+
+/// The Central Memory address that transfers use, with the high bit of `A` set so `R` isn't involved.
+#define CYBER_BENCH_PP_CM_ADDRESS 0x1000
+
+
+/// A single instruction and operand pattern to measure.
+struct CyberBenchPPCase {
+
+    /// The instruction mnemonic.
+    const char *instruction;
+
+    /// The operand pattern.
+    const char *variant;
+
+    /// The instruction word.
+    CyberWord16 word;
+
+    /// The `m` word following the instruction word, for two-word instructions.
+    CyberWord16 m;
+
+    /// Whether the instruction has an `m` word.
+    bool hasM;
+
+    /// The value of `A`.
+    CyberWord18 A;
+
+    /// The number of words a block transfer moves, or 0 if this isn't a block transfer.
+    CyberWord16 count;
+
+    /// Whether the instruction is a jump to `m+(d)` whose `m` word is the next copy's address rather than `m`.
+    bool jumpsToNext;
+};
+
+
+#define CYBER_BENCH_PP_ONE(name, variant, opcode, d, A)       { name, variant, CYBER_BENCH_PP(opcode, d), 0, false, A, 0 }
+#define CYBER_BENCH_PP_TWO(name, variant, opcode, d, m, A)    { name, variant, CYBER_BENCH_PP(opcode, d), m, true, A, 0 }
+#define CYBER_BENCH_PP_CM_A                                   (0x20000 | CYBER_BENCH_PP_CM_ADDRESS)
+#define CYBER_BENCH_PP_BLOCK_CASE(name, opcode, count)        { name, #count, CYBER_BENCH_PP(opcode, CYBER_BENCH_PP_COUNT), CYBER_BENCH_PP_BLOCK, true, CYBER_BENCH_PP_CM_A, count }
+#define CYBER_BENCH_PP_JUMP(name, variant, opcode)            { name, variant, CYBER_BENCH_PP(opcode, CYBER_BENCH_PP_INDEX), 0, true, 0, 0, true }
+
+
+/// The cases to measure.
+///
+/// Branches use a displacement of +1 and `LJM` jumps to the copy after it, so stepping a branch executes every copy in turn like any other case, whether or not it's taken; taken and not-taken cases differ only in which way the branch goes.
+///
+/// Block transfers are limited by the size of PP memory: A `CRM` of 1024 words fills 5120 PP words, which with the rest of the layout is about as large as fits.
+static const struct CyberBenchPPCase CyberBenchPPCases[] = {
+    CYBER_BENCH_PP_ONE("LDN",  "d",         00014, 5, 0),
+    CYBER_BENCH_PP_ONE("LCN",  "d",         00015, 5, 0),
+    CYBER_BENCH_PP_TWO("LDC",  "d,m",       00020, 1, 02345, 0),
+    CYBER_BENCH_PP_ONE("LDD",  "(d)",       00030, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("LDDL", "(d)",       01030, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("LDI",  "((d))",     00040, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_ONE("LDIL", "((d))",     01040, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_TWO("LDM",  "(m)",       00050, 0, CYBER_BENCH_PP_DATA, 0),
+    CYBER_BENCH_PP_TWO("LDM",  "(m+(d))",   00050, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+    CYBER_BENCH_PP_TWO("LDML", "(m+(d))",   01050, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+
+    CYBER_BENCH_PP_ONE("ADN",  "d",         00016, 5, 0),
+    CYBER_BENCH_PP_TWO("ADC",  "d,m",       00021, 1, 02345, 0),
+    CYBER_BENCH_PP_ONE("ADD",  "(d)",       00031, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("ADDL", "(d)",       01031, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("ADI",  "((d))",     00041, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_ONE("ADIL", "((d))",     01041, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_TWO("ADM",  "(m+(d))",   00051, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+    CYBER_BENCH_PP_TWO("ADML", "(m+(d))",   01051, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+
+    CYBER_BENCH_PP_ONE("RAD",  "(d)",       00035, CYBER_BENCH_PP_DIRECT, 1),
+    CYBER_BENCH_PP_ONE("RADL", "(d)",       01035, CYBER_BENCH_PP_DIRECT, 1),
+    CYBER_BENCH_PP_ONE("RAI",  "((d))",     00045, CYBER_BENCH_PP_INDIRECT, 1),
+    CYBER_BENCH_PP_ONE("RAIL", "((d))",     01045, CYBER_BENCH_PP_INDIRECT, 1),
+    CYBER_BENCH_PP_TWO("RAM",  "(m+(d))",   00055, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 1),
+    CYBER_BENCH_PP_TWO("RAML", "(m+(d))",   01055, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 1),
+
+    CYBER_BENCH_PP_ONE("AOD",  "(d)",       00036, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("AODL", "(d)",       01036, CYBER_BENCH_PP_DIRECT, 0),
+    CYBER_BENCH_PP_ONE("AOI",  "((d))",     00046, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_ONE("AOIL", "((d))",     01046, CYBER_BENCH_PP_INDIRECT, 0),
+    CYBER_BENCH_PP_TWO("AOM",  "(m+(d))",   00056, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+    CYBER_BENCH_PP_TWO("AOML", "(m+(d))",   01056, CYBER_BENCH_PP_INDEX, CYBER_BENCH_PP_DATA, 0),
+
+    CYBER_BENCH_PP_ONE("UJN",  "taken",     00003, 1, 0),
+    CYBER_BENCH_PP_ONE("ZJN",  "taken",     00004, 1, 0),
+    CYBER_BENCH_PP_ONE("ZJN",  "not taken", 00004, 1, 1),
+    CYBER_BENCH_PP_ONE("NJN",  "taken",     00005, 1, 1),
+    CYBER_BENCH_PP_ONE("NJN",  "not taken", 00005, 1, 0),
+    CYBER_BENCH_PP_ONE("PJN",  "taken",     00006, 1, 1),
+    CYBER_BENCH_PP_ONE("PJN",  "not taken", 00006, 1, 0x20000),
+    CYBER_BENCH_PP_ONE("MJN",  "taken",     00007, 1, 0x20000),
+    CYBER_BENCH_PP_ONE("MJN",  "not taken", 00007, 1, 1),
+    CYBER_BENCH_PP_JUMP("LJM", "(m+(d))",   00001),
+
+    CYBER_BENCH_PP_ONE("CRD",  "(A),d",     00060, CYBER_BENCH_PP_WORD, CYBER_BENCH_PP_CM_A),
+    CYBER_BENCH_PP_ONE("CRDL", "(A),d",     01060, CYBER_BENCH_PP_WORD, CYBER_BENCH_PP_CM_A),
+    CYBER_BENCH_PP_ONE("CWD",  "(A),d",     00062, CYBER_BENCH_PP_WORD, CYBER_BENCH_PP_CM_A),
+    CYBER_BENCH_PP_ONE("CWDL", "(A),d",     01062, CYBER_BENCH_PP_WORD, CYBER_BENCH_PP_CM_A),
+    CYBER_BENCH_PP_ONE("RDSL", "d,(A)",     01000, CYBER_BENCH_PP_LOCK, CYBER_BENCH_PP_CM_A),
+    CYBER_BENCH_PP_ONE("RDCL", "d,(A)",     01001, CYBER_BENCH_PP_LOCK, CYBER_BENCH_PP_CM_A),
+
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 1),
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 4),
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 16),
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 64),
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 256),
+    CYBER_BENCH_PP_BLOCK_CASE("CRM",  00061, 1024),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 1),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 4),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 16),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 64),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 256),
+    CYBER_BENCH_PP_BLOCK_CASE("CRML", 01061, 1024),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 1),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 4),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 16),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 64),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 256),
+    CYBER_BENCH_PP_BLOCK_CASE("CWM",  00063, 1024),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 1),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 4),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 16),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 64),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 256),
+    CYBER_BENCH_PP_BLOCK_CASE("CWML", 01063, 1024),
+};
+
+
+/// The state needed to execute batches of a case.
+struct CyberBenchPPContext {
+
+    /// The processor executing the case.
+    struct Cyber962PP *pp;
+
+    /// The case being executed.
+    const struct CyberBenchPPCase *benchCase;
+
+    /// The handler for the case's instruction.
+    Cyber962PPInstruction handler;
+};
+
+
+/// Put a processor's registers and memory into the state a case expects, and lay out a batch's worth of copies of its instruction.
+static void CyberBenchPPPrepare(struct Cyber962PP *pp, const struct CyberBenchPPCase *benchCase)
+{
+    pp->_regA = benchCase->A;
+    pp->_regR = 0;
+    pp->_regP = CYBER_BENCH_PP_CODE;
+
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_DIRECT, 01234);
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_INDIRECT, CYBER_BENCH_PP_DATA);
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_INDEX, 0);
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_COUNT, benchCase->count);
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_DATA, CYBER_BENCH_PP_DATA + 1);
+    Cyber962PPWriteSingle(pp, CYBER_BENCH_PP_DATA + 1, 04321);
+
+    CyberWord16 address = CYBER_BENCH_PP_CODE;
+    for (int i = 0; i < CYBER_BENCH_PP_BATCH; i++) {
+        Cyber962PPWriteSingle(pp, address++, benchCase->word);
+        if (benchCase->hasM) {
+            const CyberWord16 m = benchCase->jumpsToNext ? (address + 1) : benchCase->m;
+            Cyber962PPWriteSingle(pp, address++, m);
+        }
+    }
+    assert(address <= CYBER_BENCH_PP_DATA);
+}
+
+
+/// Execute a batch of a case by calling its handler directly, which isolates the handler from fetch and decode.
+///
+/// Handlers only return how far to advance `P`, so every call executes the first copy.
+static void CyberBenchPPRunHandlerBatch(void *contextv)
+{
+    struct CyberBenchPPContext *context = contextv;
+    struct Cyber962PP *pp = context->pp;
+    union Cyber962PPInstructionWord word = { ._raw = context->benchCase->word };
+
+    pp->_regP = CYBER_BENCH_PP_CODE;
+    for (int i = 0; i < CYBER_BENCH_PP_BATCH; i++) {
+        (void) context->handler(pp, word);
+    }
+}
+
+
+/// Execute a batch of a case via ``Cyber962PPSingleStep``, which includes instruction fetch and decode.
+static void CyberBenchPPRunStepBatch(void *contextv)
+{
+    struct CyberBenchPPContext *context = contextv;
+    struct Cyber962PP *pp = context->pp;
+
+    pp->_regP = CYBER_BENCH_PP_CODE;
+    for (int i = 0; i < CYBER_BENCH_PP_BATCH; i++) {
+        Cyber962PPSingleStep(pp);
+    }
+
+    // Every case, branches included, executes each copy once.
+    assert(pp->_regP == (CYBER_BENCH_PP_CODE + (CYBER_BENCH_PP_BATCH * (context->benchCase->hasM ? 2 : 1))));
+}
+
+
+void CyberBenchRunPeripheralProcessorInstructionSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json)
+{
+    // A lockstep system never starts processor threads, so its PP can be driven directly from here.
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 1,
+    };
+    struct Cyber962 *system = Cyber962CreateWithConfiguration("cyberbench", &configuration);
+    assert(system != NULL);
+
+    struct Cyber962PP *pp = Cyber962IOUGetPeripheralProcessor(Cyber962GetInputOutputUnit(system, 0), 0);
+
+    const size_t caseCount = sizeof(CyberBenchPPCases) / sizeof(CyberBenchPPCases[0]);
+    for (size_t c = 0; c < caseCount; c++) {
+        const struct CyberBenchPPCase *benchCase = &CyberBenchPPCases[c];
+        union Cyber962PPInstructionWord word = { ._raw = benchCase->word };
+
+        struct CyberBenchPPContext context = {
+            .pp = pp,
+            .benchCase = benchCase,
+            .handler = Cyber962PPInstructionDecode(pp, word, CYBER_BENCH_PP_CODE),
+        };
+        assert(context.handler != NULL);
+
+        CyberBenchPPPrepare(pp, benchCase);
+        struct CyberBenchMeasurement handler = CyberBenchMeasure(options, CyberBenchPPRunHandlerBatch, &context, CYBER_BENCH_PP_BATCH);
+
+        CyberBenchPPPrepare(pp, benchCase);
+        struct CyberBenchMeasurement step = CyberBenchMeasure(options, CyberBenchPPRunStepBatch, &context, CYBER_BENCH_PP_BATCH);
+
+        char opcode[8];
+        snprintf(opcode, sizeof(opcode), "%04o", (unsigned)((word._d.g << 9) | word._d.f));
+
+        CyberBenchJSONBeginObject(json, NULL);
+        CyberBenchJSONWriteString(json, "instruction", benchCase->instruction);
+        CyberBenchJSONWriteString(json, "variant", benchCase->variant);
+        CyberBenchJSONWriteString(json, "opcode", opcode);
+        if (benchCase->count != 0) {
+            // Block transfers also report their throughput in Central Memory words.
+            CyberBenchJSONWriteInteger(json, "words", benchCase->count);
+            CyberBenchJSONWriteNumber(json, "wordsPerSecond", (1e9 / step.nanosecondsPerInstruction) * benchCase->count);
+        }
+        CyberBenchWriteMeasurement(json, "handler", &handler);
+        CyberBenchWriteMeasurement(json, "step", &step);
+        CyberBenchJSONEndObject(json);
+
+        fprintf(stderr, "%-6s %-10s handler %9.2f ns  step %9.2f ns\n",
+                benchCase->instruction, benchCase->variant,
+                handler.nanosecondsPerInstruction, step.nanosecondsPerInstruction);
+    }
+
+    Cyber962Dispose(system);
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,118 @@
+//
+//  CyberBenchProfile.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <string.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The longest folded stack written, which is plenty for a processor and a symbol name.
+#define CYBER_BENCH_PROFILE_MAX_STACK 512
+
+
+/// Format the folded stack for a profile entry: the processor's frames, then the symbol covering its address or the address itself.
+static void CyberBenchProfileFormatStack(char *stack, size_t size, const struct CyberProfileEntry *entry,
+                                         struct CyberSymbolMap * _Nullable centralProcessorSymbols,
+                                         struct CyberSymbolMap * _Nullable const peripheralProcessorSymbols[_Nonnull 20])
+{
+    const bool central = (entry->processorKind == CyberTraceProcessorKindCentral);
+    struct CyberSymbolMap *symbols = central ? centralProcessorSymbols : peripheralProcessorSymbols[entry->processorIndex];
+    const char *name = (symbols != NULL) ? CyberSymbolMapLookup(symbols, entry->address, NULL) : NULL;
+
+    int length;
+    if (central) {
+        length = snprintf(stack, size, "CP %d;", entry->processorIndex);
+    } else {
+        length = snprintf(stack, size, "IOU %d;PP %02o;", entry->inputOutputUnit, entry->processorIndex);
+    }
+
+    // PP addresses are conventionally written in octal.
+    if (name != NULL) {
+        snprintf(stack + length, size - (size_t)length, "%s", name);
+    } else if (central) {
+        snprintf(stack + length, size - (size_t)length, "0x%" PRIx64, entry->address);
+    } else {
+        snprintf(stack + length, size - (size_t)length, "%04" PRIo64, entry->address);
+    }
+
+    // Semicolons separate frames, so one in a name would split it.
+    for (char *c = stack + length; *c != '\0'; c++) {
+        if (*c == ';') *c = ':';
+    }
+}
+
+
+bool CyberBenchWriteProfile(struct CyberProfile *profile, const char *path,
+                            struct CyberSymbolMap * _Nullable centralProcessorSymbols,
+                            struct CyberSymbolMap * _Nullable const peripheralProcessorSymbols[_Nonnull 20])
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    size_t count = 0;
+    const struct CyberProfileEntry *entries = CyberProfileGetEntries(profile, &count);
+
+    // Entries are sorted by processor and address, so every address a symbol covers is adjacent and they can be merged into one line.
+    char stack[CYBER_BENCH_PROFILE_MAX_STACK];
+    char previous[CYBER_BENCH_PROFILE_MAX_STACK] = "";
+    uint64_t samples = 0;
+    uint64_t stacks = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        CyberBenchProfileFormatStack(stack, sizeof(stack), &entries[i], centralProcessorSymbols, peripheralProcessorSymbols);
+
+        if ((samples > 0) && (strcmp(stack, previous) != 0)) {
+            fprintf(file, "%s %" PRIu64 "\n", previous, samples);
+            stacks += 1;
+            samples = 0;
+        }
+
+        memcpy(previous, stack, sizeof(stack));
+        samples += entries[i].samples;
+    }
+    if (samples > 0) {
+        fprintf(file, "%s %" PRIu64 "\n", previous, samples);
+        stacks += 1;
+    }
+
+    bool failed = (ferror(file) != 0);
+    failed = (fclose(file) != 0) || failed;
+    if (failed) {
+        fprintf(stderr, "cyberbench: couldn't write profile\n");
+        return false;
+    }
+
+    printf("profile:    %s, %" PRIu64 " samples over %.3f s in %" PRIu64 " stacks\n",
+           path, CyberProfileGetSampleCount(profile), CyberProfileGetSeconds(profile), stacks);
+
+    return true;
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,138 @@
+//
+//  CyberBenchReplay.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include <assert.h>
+#include <inttypes.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The number of instruction trace streams, one for each Central Processor.
+#define CYBER_BENCH_REPLAY_STREAMS 2
+
+
+/// Print one decoded instruction and the registers it changed, as they are after it executed.
+static void CyberBenchReplayPrint(uint32_t stream, const struct CyberInstructionTraceState *state, const struct CyberInstructionRecord *record)
+{
+    if (record->length == 4) {
+        printf("CP %" PRIu32 " %012" PRIx64 "  %08" PRIx32, stream, record->address, record->instruction);
+    } else {
+        printf("CP %" PRIu32 " %012" PRIx64 "  %04" PRIx32 "    ", stream, record->address, record->instruction >> 16);
+    }
+
+    if (record->keyframe) {
+        printf("  (keyframe)");
+    } else {
+        for (int r = 0; r < 16; r++) {
+            if (record->changedRegisters & (1U << r)) {
+                printf("  X%X=%016" PRIx64, r, state->x[r]);
+            }
+        }
+        for (int r = 0; r < 16; r++) {
+            if (record->changedRegisters & (1U << (16 + r))) {
+                printf("  A%X=%012" PRIx64, r, state->a[r]);
+            }
+        }
+    }
+
+    if (state->address != (record->address + record->length)) {
+        printf("  -> %012" PRIx64, state->address);
+    }
+
+    putchar('\n');
+}
+
+
+bool CyberBenchReplayInstructionTrace(const char *path, uint64_t limit)
+{
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(path);
+    if (reader == NULL) {
+        fprintf(stderr, "cyberbench: %s isn't a trace file\n", path);
+        return false;
+    }
+
+    if (CyberTraceReaderGetHeader(reader)->kind != CyberTraceKindInstruction) {
+        fprintf(stderr, "cyberbench: %s isn't an instruction trace\n", path);
+        CyberTraceReaderClose(reader);
+        return false;
+    }
+
+    struct CyberInstructionTraceState states[CYBER_BENCH_REPLAY_STREAMS] = { 0 };
+    uint64_t instructions[CYBER_BENCH_REPLAY_STREAMS] = { 0 };
+    uint64_t keyframes[CYBER_BENCH_REPLAY_STREAMS] = { 0 };
+    uint64_t bytes = 0;
+    uint64_t printed = 0;
+    bool malformed = false;
+
+    struct CyberTraceChunkHeader chunk;
+    const CyberWord8 *records;
+    while (!malformed && ((records = CyberTraceReaderNextChunk(reader, &chunk)) != NULL)) {
+        if (chunk.stream >= CYBER_BENCH_REPLAY_STREAMS) {
+            malformed = true;
+            break;
+        }
+
+        struct CyberInstructionTraceState *state = &states[chunk.stream];
+        size_t offset = 0;
+        while (offset < chunk.length) {
+            struct CyberInstructionRecord record;
+            size_t used = CyberInstructionTraceDecode(state, records + offset, chunk.length - offset, &record);
+            if (used == 0) {
+                malformed = true;
+                break;
+            }
+            offset += used;
+
+            instructions[chunk.stream] += 1;
+            if (record.keyframe) keyframes[chunk.stream] += 1;
+
+            if (printed < limit) {
+                CyberBenchReplayPrint(chunk.stream, state, &record);
+                printed += 1;
+            }
+        }
+        bytes += chunk.length;
+    }
+
+    CyberTraceReaderClose(reader);
+
+    if (malformed) {
+        fprintf(stderr, "cyberbench: %s has a malformed record\n", path);
+        return false;
+    }
+
+    uint64_t total = 0;
+    for (int cp = 0; cp < CYBER_BENCH_REPLAY_STREAMS; cp++) {
+        if (instructions[cp] == 0) continue;
+        printf("CP %d:       %" PRIu64 " instructions, %" PRIu64 " keyframes, ending at P %012" PRIx64 "\n",
+               cp, instructions[cp], keyframes[cp], states[cp].address);
+        total += instructions[cp];
+    }
+    printf("trace:      %" PRIu64 " bytes, %.2f bytes per instruction\n", bytes, (total > 0) ? ((double)bytes / (double)total) : 0.0);
+
+    return true;
+}
+
+
+CYBER_SOURCE_END
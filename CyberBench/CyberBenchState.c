@@ -0,0 +1,110 @@
+//
+//  CyberBenchState.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+#include "CyberBench.h"
+
+#include <Cyber/CyberState.h>
+
+#include <assert.h>
+#include <pthread.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The number of round trips in each batch of the handoff case.
+#define CYBER_BENCH_STATE_BATCH 1000
+
+
+/// Two states that a value is passed back and forth through, one for each direction.
+struct CyberBenchStateContext {
+
+    /// The state the benchmark sets and the echo thread awaits.
+    struct CyberState *request;
+
+    /// The state the echo thread sets and the benchmark awaits.
+    struct CyberState *reply;
+
+    /// The last value sent.
+    int value;
+};
+
+
+/// Echo every value set in the request state back through the reply state, until it's negative.
+static void * _Nullable CyberBenchStateEcho(void * _Nullable contextv)
+{
+    struct CyberBenchStateContext *context = contextv;
+    int value = 0;
+
+    for (;;) {
+        value = CyberStateAwaitValueChange(value, context->request);
+        if (value < 0) break;
+        CyberStateSetValue(context->reply, value);
+    }
+
+    return NULL;
+}
+
+
+/// Make a batch of round trips through the echo thread.
+static void CyberBenchStateRunHandoffBatch(void *contextv)
+{
+    struct CyberBenchStateContext *context = contextv;
+
+    for (int i = 0; i < CYBER_BENCH_STATE_BATCH; i++) {
+        int previous = context->value++;
+        CyberStateSetValue(context->request, context->value);
+        (void) CyberStateAwaitValueChange(previous, context->reply);
+    }
+}
+
+
+void CyberBenchRunStateHandoffSuite(const struct CyberBenchSuiteOptions *options, struct CyberBenchJSON *json)
+{
+    struct CyberBenchStateContext context = {
+        .request = CyberStateCreate(0),
+        .reply = CyberStateCreate(0),
+        .value = 0,
+    };
+    assert(context.request != NULL);
+    assert(context.reply != NULL);
+
+    pthread_t echo;
+    int echo_err = pthread_create(&echo, NULL, CyberBenchStateEcho, &context);
+    assert(echo_err == 0); // halt here in debug builds
+    (void) echo_err;
+
+    // Each round trip is two handoffs, one in each direction.
+    struct CyberBenchMeasurement handoff = CyberBenchMeasure(options, CyberBenchStateRunHandoffBatch, &context, 2 * CYBER_BENCH_STATE_BATCH);
+
+    CyberStateSetValue(context.request, -1);
+    (void) pthread_join(echo, NULL);
+
+    CyberStateDispose(context.request);
+    CyberStateDispose(context.reply);
+
+    CyberBenchJSONBeginObject(json, NULL);
+    CyberBenchJSONWriteString(json, "case", "handoff");
+    CyberBenchWriteMeasurement(json, "handoff", &handoff);
+    CyberBenchJSONEndObject(json);
+
+    fprintf(stderr, "%-20s %7.2f ns\n", "handoff", handoff.nanosecondsPerInstruction);
+}
+
+
+CYBER_SOURCE_END
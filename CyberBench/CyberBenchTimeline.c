@@ -0,0 +1,437 @@
+//
+//  CyberBenchTimeline.c
+//  CyberBench
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CyberBench.h"
+
+#include <Cyber/Cyber.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+CYBER_SOURCE_BEGIN
+
+
+/// The number of channels in an I/O Unit.
+#define CYBER_BENCH_TIMELINE_CHANNELS 20
+
+/// The thread ID of a channel's track within its I/O Unit's process, clear of the Peripheral Processors' thread IDs.
+#define CYBER_BENCH_TIMELINE_CHANNEL_THREAD(channel) (100 + (channel))
+
+
+/// What's known about one stream of a timeline while converting it.
+struct CyberBenchTimelineStream {
+
+    /// Whether the stream's thread has been named.
+    bool named;
+
+    /// The state the processor is in, or 0 before its first state and after its timeline ends.
+    uint16_t state;
+
+    /// When the processor entered `state`.
+    uint64_t stateTicks;
+
+    /// Whether the processor's most recent event was an exchange jump, so one it keeps retrying shows only once.
+    bool exchanged;
+
+    /// The address of the most recent exchange jump.
+    uint64_t exchangeAddress;
+
+    /// The channels the processor has active, bit `c` for channel `c`.
+    uint32_t activeChannels;
+
+    /// When each active channel was activated.
+    uint64_t channelActiveTicks[CYBER_BENCH_TIMELINE_CHANNELS];
+};
+
+
+/// A timeline being converted.
+struct CyberBenchTimeline {
+
+    /// Where the converted timeline is written.
+    struct CyberBenchJSON json;
+
+    /// The host cycle counter when tracing started.
+    uint64_t startTicks;
+
+    /// The host cycle counter ticks per microsecond, the unit of trace event timestamps.
+    double ticksPerMicrosecond;
+
+    /// The latest time any event ended, to end any states left open by a truncated trace.
+    uint64_t lastTicks;
+
+    /// The number of events read.
+    uint64_t events;
+
+    /// Whether each process, the Central Processors and then each I/O Unit, has been named.
+    bool processNamed[4];
+
+    /// Whether each channel of each I/O Unit has been named.
+    bool channelNamed[3][CYBER_BENCH_TIMELINE_CHANNELS];
+
+    /// What's known about each stream.
+    struct CyberBenchTimelineStream streams[CYBER_TRACE_STREAM_COUNT];
+};
+
+
+/// Get the process ID for a stream: 0 for the Central Processors, or 1 more than the index of a Peripheral Processor's I/O Unit.
+static int CyberBenchTimelineGetProcess(uint32_t stream)
+{
+    return (stream < 2) ? 0 : (1 + (int)((stream - 2) / 20));
+}
+
+/// Get the thread ID for a stream: the index of its processor.
+static int CyberBenchTimelineGetThread(uint32_t stream)
+{
+    return (stream < 2) ? (int)stream : (int)((stream - 2) % 20);
+}
+
+
+/// Get the name of a processor state.
+static const char *CyberBenchTimelineGetStateName(uint16_t state)
+{
+    switch (state) {
+        case CyberTimelineEventRunning: return "running";
+        case CyberTimelineEventParked: return "parked";
+        case CyberTimelineEventStopped: return "stopped";
+        default: return "unknown";
+    }
+}
+
+
+/// Begin a trace event object, leaving it open for arguments.
+static void CyberBenchTimelineBeginEvent(struct CyberBenchTimeline *timeline, const char *name, const char *category, const char *phase, int process, int thread, uint64_t ticks)
+{
+    struct CyberBenchJSON *json = &timeline->json;
+
+    CyberBenchJSONBeginObject(json, NULL);
+    CyberBenchJSONWriteString(json, "name", name);
+    CyberBenchJSONWriteString(json, "cat", category);
+    CyberBenchJSONWriteString(json, "ph", phase);
+    CyberBenchJSONWriteInteger(json, "pid", (uint64_t)process);
+    CyberBenchJSONWriteInteger(json, "tid", (uint64_t)thread);
+
+    // Timestamps are in microseconds since tracing started; events recorded as it started may be a few ticks earlier.
+    double microseconds = (double)(int64_t)(ticks - timeline->startTicks) / timeline->ticksPerMicrosecond;
+    CyberBenchJSONWriteDecimal(json, "ts", microseconds, 3);
+}
+
+/// Begin a complete event, one with a duration, leaving it open for arguments.
+static void CyberBenchTimelineBeginSlice(struct CyberBenchTimeline *timeline, const char *name, const char *category, int process, int thread, uint64_t ticks, uint64_t duration)
+{
+    CyberBenchTimelineBeginEvent(timeline, name, category, "X", process, thread, ticks);
+    CyberBenchJSONWriteDecimal(&timeline->json, "dur", (double)duration / timeline->ticksPerMicrosecond, 3);
+}
+
+
+/// Write a metadata event naming a process or thread.
+static void CyberBenchTimelineWriteName(struct CyberBenchTimeline *timeline, const char *kind, int process, int thread, const char *name)
+{
+    struct CyberBenchJSON *json = &timeline->json;
+
+    CyberBenchJSONBeginObject(json, NULL);
+    CyberBenchJSONWriteString(json, "name", kind);
+    CyberBenchJSONWriteString(json, "ph", "M");
+    CyberBenchJSONWriteInteger(json, "pid", (uint64_t)process);
+    CyberBenchJSONWriteInteger(json, "tid", (uint64_t)thread);
+    CyberBenchJSONBeginObject(json, "args");
+    CyberBenchJSONWriteString(json, "name", name);
+    CyberBenchJSONEndObject(json);
+    CyberBenchJSONEndObject(json);
+}
+
+/// Name a stream's process and thread the first time the stream is seen.
+static void CyberBenchTimelineNameStream(struct CyberBenchTimeline *timeline, uint32_t stream)
+{
+    struct CyberBenchTimelineStream *state = &timeline->streams[stream];
+    if (state->named) return;
+    state->named = true;
+
+    const int process = CyberBenchTimelineGetProcess(stream);
+    const int thread = CyberBenchTimelineGetThread(stream);
+    char name[32];
+
+    if (!timeline->processNamed[process]) {
+        timeline->processNamed[process] = true;
+        if (process == 0) {
+            snprintf(name, sizeof(name), "Central Processors");
+        } else {
+            snprintf(name, sizeof(name), "I/O Unit %d", process - 1);
+        }
+        CyberBenchTimelineWriteName(timeline, "process_name", process, 0, name);
+    }
+
+    snprintf(name, sizeof(name), (process == 0) ? "CP %d" : "PP %02o", thread);
+    CyberBenchTimelineWriteName(timeline, "thread_name", process, thread, name);
+}
+
+/// Name a channel's thread the first time it's used.
+static void CyberBenchTimelineNameChannel(struct CyberBenchTimeline *timeline, int process, int channel)
+{
+    if (timeline->channelNamed[process - 1][channel]) return;
+    timeline->channelNamed[process - 1][channel] = true;
+
+    char name[32];
+    snprintf(name, sizeof(name), "Channel %02o", channel);
+    CyberBenchTimelineWriteName(timeline, "thread_name", process, CYBER_BENCH_TIMELINE_CHANNEL_THREAD(channel), name);
+}
+
+
+/// End a processor's current state at `ticks`, writing it as a slice.
+static void CyberBenchTimelineEndState(struct CyberBenchTimeline *timeline, uint32_t stream, uint64_t ticks)
+{
+    struct CyberBenchTimelineStream *state = &timeline->streams[stream];
+    if (state->state == 0) return;
+
+    CyberBenchTimelineBeginSlice(timeline, CyberBenchTimelineGetStateName(state->state), "state",
+                                 CyberBenchTimelineGetProcess(stream), CyberBenchTimelineGetThread(stream), state->stateTicks, ticks - state->stateTicks);
+    CyberBenchJSONEndObject(&timeline->json);
+
+    state->state = 0;
+}
+
+/// End the time a processor had a channel active at `ticks`, writing it as a slice on the channel's thread.
+static void CyberBenchTimelineEndChannel(struct CyberBenchTimeline *timeline, uint32_t stream, int channel, uint64_t ticks)
+{
+    struct CyberBenchTimelineStream *state = &timeline->streams[stream];
+    if ((state->activeChannels & (1U << channel)) == 0) return;
+
+    const int process = CyberBenchTimelineGetProcess(stream);
+    const int thread = CyberBenchTimelineGetThread(stream);
+    char name[32];
+    snprintf(name, sizeof(name), "active (PP %02o)", thread);
+
+    CyberBenchTimelineBeginSlice(timeline, name, "channel", process, CYBER_BENCH_TIMELINE_CHANNEL_THREAD(channel),
+                                 state->channelActiveTicks[channel], ticks - state->channelActiveTicks[channel]);
+    CyberBenchJSONBeginObject(&timeline->json, "args");
+    CyberBenchJSONWriteInteger(&timeline->json, "pp", (uint64_t)thread);
+    CyberBenchJSONEndObject(&timeline->json);
+    CyberBenchJSONEndObject(&timeline->json);
+
+    state->activeChannels &= ~(1U << channel);
+}
+
+
+/// Convert one timeline record.
+///
+/// - Returns: `true` on success, or `false` if the record is malformed.
+static bool CyberBenchTimelineConvertRecord(struct CyberBenchTimeline *timeline, uint32_t stream, const struct CyberTimelineRecord *record)
+{
+    struct CyberBenchJSON *json = &timeline->json;
+    struct CyberBenchTimelineStream *state = &timeline->streams[stream];
+    const int process = CyberBenchTimelineGetProcess(stream);
+    const int thread = CyberBenchTimelineGetThread(stream);
+    const bool peripheral = (process != 0);
+
+    CyberBenchTimelineNameStream(timeline, stream);
+
+    if ((record->ticks + record->duration) > timeline->lastTicks) {
+        timeline->lastTicks = record->ticks + record->duration;
+    }
+    timeline->events += 1;
+
+    char hex[24];
+
+    switch (record->event) {
+        case CyberTimelineEventRunning:
+        case CyberTimelineEventParked:
+        case CyberTimelineEventStopped:
+            CyberBenchTimelineEndState(timeline, stream, record->ticks);
+            state->state = record->event;
+            state->stateTicks = record->ticks;
+            state->exchanged = false;
+            break;
+
+        case CyberTimelineEventEnd:
+            CyberBenchTimelineEndState(timeline, stream, record->ticks);
+            for (int channel = 0; channel < CYBER_BENCH_TIMELINE_CHANNELS; channel++) {
+                CyberBenchTimelineEndChannel(timeline, stream, channel, record->ticks);
+            }
+            break;
+
+        case CyberTimelineEventExchange:
+            // An exchange jump that can't complete is retried, so only show the first of a run of them.
+            if (state->exchanged && (state->exchangeAddress == record->value)) break;
+            state->exchanged = true;
+            state->exchangeAddress = record->value;
+
+            snprintf(hex, sizeof(hex), "%" PRIx64, record->value);
+            CyberBenchTimelineBeginEvent(timeline, "exchange", "exchange", "i", process, thread, record->ticks);
+            CyberBenchJSONWriteString(json, "s", "t");
+            CyberBenchJSONBeginObject(json, "args");
+            CyberBenchJSONWriteString(json, "P", hex);
+            CyberBenchJSONEndObject(json);
+            CyberBenchJSONEndObject(json);
+            break;
+
+        case CyberTimelineEventInterrupt:
+            snprintf(hex, sizeof(hex), "%" PRIx64, record->value);
+            CyberBenchTimelineBeginEvent(timeline, "monitor condition", "interrupt", "i", process, thread, record->ticks);
+            CyberBenchJSONWriteString(json, "s", "t");
+            CyberBenchJSONBeginObject(json, "args");
+            CyberBenchJSONWriteString(json, "condition", hex);
+            CyberBenchJSONEndObject(json);
+            CyberBenchJSONEndObject(json);
+            break;
+
+        case CyberTimelineEventChannelActivate:
+            if (!peripheral || (record->unit >= CYBER_BENCH_TIMELINE_CHANNELS)) return false;
+
+            // An activation that's retried while the channel is busy doesn't restart the slice.
+            if ((state->activeChannels & (1U << record->unit)) == 0) {
+                CyberBenchTimelineNameChannel(timeline, process, record->unit);
+                state->activeChannels |= (1U << record->unit);
+                state->channelActiveTicks[record->unit] = record->ticks;
+            }
+            break;
+
+        case CyberTimelineEventChannelDeactivate:
+            if (!peripheral || (record->unit >= CYBER_BENCH_TIMELINE_CHANNELS)) return false;
+
+            CyberBenchTimelineEndChannel(timeline, stream, record->unit, record->ticks);
+            break;
+
+        case CyberTimelineEventChannelInput:
+        case CyberTimelineEventChannelOutput:
+            if (!peripheral || (record->unit >= CYBER_BENCH_TIMELINE_CHANNELS)) return false;
+
+            CyberBenchTimelineBeginSlice(timeline, (record->event == CyberTimelineEventChannelInput) ? "input" : "output", "channel",
+                                         process, thread, record->ticks, record->duration);
+            CyberBenchJSONBeginObject(json, "args");
+            CyberBenchJSONWriteInteger(json, "channel", record->unit);
+            CyberBenchJSONWriteInteger(json, "words", record->value);
+            CyberBenchJSONEndObject(json);
+            CyberBenchJSONEndObject(json);
+            break;
+
+        case CyberTimelineEventLockWait:
+            CyberBenchTimelineBeginSlice(timeline, "CM lock wait", "memory", process, thread, record->ticks, record->duration);
+            CyberBenchJSONBeginObject(json, "args");
+            CyberBenchJSONWriteInteger(json, "port", record->unit);
+            CyberBenchJSONEndObject(json);
+            CyberBenchJSONEndObject(json);
+            break;
+
+        default:
+            // Skip events from newer versions of the format.
+            break;
+    }
+
+    return true;
+}
+
+
+bool CyberBenchExportTimeline(const char *tracePath, const char * _Nullable jsonPath)
+{
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(tracePath);
+    if (reader == NULL) {
+        fprintf(stderr, "cyberbench: %s isn't a trace file\n", tracePath);
+        return false;
+    }
+
+    const struct CyberTraceFileHeader *header = CyberTraceReaderGetHeader(reader);
+    if (header->kind != CyberTraceKindTimeline) {
+        fprintf(stderr, "cyberbench: %s isn't a timeline trace\n", tracePath);
+        CyberTraceReaderClose(reader);
+        return false;
+    }
+
+    FILE *file = stdout;
+    if (jsonPath != NULL) {
+        file = fopen(jsonPath, "w");
+        if (file == NULL) {
+            perror(jsonPath);
+            CyberTraceReaderClose(reader);
+            return false;
+        }
+    }
+
+    // This is too big for the stack.
+    struct CyberBenchTimeline *timeline = calloc(1, sizeof(struct CyberBenchTimeline));
+    if (timeline == NULL) {
+        fprintf(stderr, "cyberbench: out of memory\n");
+        if (file != stdout) fclose(file);
+        CyberTraceReaderClose(reader);
+        return false;
+    }
+    timeline->startTicks = header->startTicks;
+    timeline->lastTicks = header->startTicks;
+    timeline->ticksPerMicrosecond = (header->ticksPerSecond > 0) ? ((double)header->ticksPerSecond / 1e6) : 1.0;
+
+    struct CyberBenchJSON *json = &timeline->json;
+    CyberBenchJSONInit(json, file);
+    CyberBenchJSONBeginObject(json, NULL);
+    CyberBenchJSONWriteString(json, "displayTimeUnit", "ns");
+    CyberBenchJSONBeginArray(json, "traceEvents");
+
+    bool malformed = false;
+    struct CyberTraceChunkHeader chunk;
+    const CyberWord8 *records;
+    while (!malformed && ((records = CyberTraceReaderNextChunk(reader, &chunk)) != NULL)) {
+        if ((chunk.stream >= CYBER_TRACE_STREAM_COUNT) || ((chunk.length % sizeof(struct CyberTimelineRecord)) != 0)) {
+            malformed = true;
+            break;
+        }
+
+        for (uint32_t offset = 0; offset < chunk.length; offset += sizeof(struct CyberTimelineRecord)) {
+            struct CyberTimelineRecord record;
+            memcpy(&record, records + offset, sizeof(record));
+            if (!CyberBenchTimelineConvertRecord(timeline, chunk.stream, &record)) {
+                malformed = true;
+                break;
+            }
+        }
+    }
+
+    CyberTraceReaderClose(reader);
+
+    // A trace that wasn't stopped cleanly has no end records, so end whatever's still open with the last event.
+    for (uint32_t stream = 0; stream < CYBER_TRACE_STREAM_COUNT; stream++) {
+        CyberBenchTimelineEndState(timeline, stream, timeline->lastTicks);
+        for (int channel = 0; channel < CYBER_BENCH_TIMELINE_CHANNELS; channel++) {
+            CyberBenchTimelineEndChannel(timeline, stream, channel, timeline->lastTicks);
+        }
+    }
+
+    CyberBenchJSONEndArray(json);
+    CyberBenchJSONEndObject(json);
+
+    bool failed = (ferror(file) != 0);
+    if (file != stdout) {
+        failed = (fclose(file) != 0) || failed;
+    }
+
+    if (malformed) {
+        fprintf(stderr, "cyberbench: %s has a malformed record\n", tracePath);
+    } else if (failed) {
+        fprintf(stderr, "cyberbench: couldn't write timeline\n");
+    } else if (jsonPath != NULL) {
+        printf("timeline:   %s, %" PRIu64 " events over %.3f ms\n", jsonPath, timeline->events,
+               (double)(timeline->lastTicks - timeline->startTicks) / timeline->ticksPerMicrosecond / 1e3);
+    }
+
+    free(timeline);
+
+    return !malformed && !failed;
+}
+
+
+CYBER_SOURCE_END
@@ -0,0 +1,235 @@
+//
+//  CentralMemoryTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for Central Memory access via ports.
+@interface CentralMemoryTests : CyberTestCase
+@end
+
+
+@implementation CentralMemoryTests {
+    struct Cyber962 *_system;
+    struct Cyber180CM *_memory;
+    struct Cyber180CMPort *_port;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _system = Cyber962Create("Test", (64 * 1024 * 1024), 1, 1);
+    XCTAssertNotEqual(_system, NULL);
+
+    _memory = Cyber962GetCentralMemory(_system);
+    XCTAssertNotEqual(_memory, NULL);
+
+    _port = Cyber180CMGetPortAtIndex(_memory, 0);
+    XCTAssertNotEqual(_port, NULL);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+- (void)testMapRangeForReading
+{
+    CyberWord8 bytes[5] = {0x12, 0x34, 0x56, 0x78, 0x9a};
+    Cyber180CMPortWriteBytesPhysical(_port, 0x1003, bytes, 5);
+
+    struct Cyber180CMSpan span;
+    Cyber180CMPortMapRange(_port, 0x1003, 5, Cyber180CMAccess_Read, &span);
+    XCTAssertNotEqual(span.bytes, NULL);
+    XCTAssertEqual(0x1003, span.address);
+    XCTAssertEqual(5, span.length);
+    XCTAssert(memcmp(bytes, span.bytes, 5) == 0);
+    Cyber180CMPortUnmapRange(_port, &span);
+
+    XCTAssertEqual(span.bytes, NULL);
+}
+
+- (void)testMapRangeForWriting
+{
+    struct Cyber180CMSpan span;
+    Cyber180CMPortMapRange(_port, 0x2000, 16, Cyber180CMAccess_Write, &span);
+    for (CyberWord32 i = 0; i < span.length; i++) {
+        span.bytes[i] = 0xA0 + i;
+    }
+    Cyber180CMPortUnmapRange(_port, &span);
+
+    CyberWord8 bytes[16];
+    Cyber180CMPortReadBytesPhysical(_port, 0x2000, bytes, 16);
+    for (CyberWord32 i = 0; i < 16; i++) {
+        XCTAssertEqual(0xA0 + i, bytes[i]);
+    }
+}
+
+- (void)testMapRangeAtEndOfMemory
+{
+    // A span may end exactly at the end of Central Memory.
+    struct Cyber180CMSpan span;
+    Cyber180CMPortMapRange(_port, (64 * 1024 * 1024) - 8, 8, Cyber180CMAccess_ReadWrite, &span);
+    span.bytes[7] = 0x5A;
+    Cyber180CMPortUnmapRange(_port, &span);
+
+    CyberWord8 byte = 0;
+    Cyber180CMPortReadBytesPhysical(_port, (64 * 1024 * 1024) - 1, &byte, 1);
+    XCTAssertEqual(0x5A, byte);
+}
+
+- (void)testReadWordsSwapped
+{
+    // Use an odd number of words so the vector implementations also have to handle a tail.
+    CyberWord8 bytes[9 * 8];
+    for (int i = 0; i < (9 * 8); i++) {
+        bytes[i] = i;
+    }
+    Cyber180CMPortWriteBytesPhysical(_port, 0x3000, bytes, 9 * 8);
+
+    CyberWord64 words[9];
+    Cyber180CMPortReadWordsSwapped(_port, 0x3000, words, 9);
+    for (int i = 0; i < 9; i++) {
+        CyberWord64 b = i * 8;
+        CyberWord64 expected = (  ((b + 0) << 56) | ((b + 1) << 48) | ((b + 2) << 40) | ((b + 3) << 32)
+                                | ((b + 4) << 24) | ((b + 5) << 16) | ((b + 6) <<  8) | ((b + 7) <<  0));
+        XCTAssertEqual(expected, words[i], @"Expected %llx got %llx at word %d", expected, words[i], i);
+    }
+}
+
+- (void)testWriteWordsSwapped
+{
+    CyberWord64 words[5] = {
+        0x0123456789abcdef,
+        0x1122334455667788,
+        0x99aabbccddeeff00,
+        0xfedcba9876543210,
+        0x123456789abcdef0,
+    };
+    Cyber180CMPortWriteWordsSwapped(_port, 0x4000, words, 5);
+
+    CyberWord8 bytes[5 * 8];
+    Cyber180CMPortReadBytesPhysical(_port, 0x4000, bytes, 5 * 8);
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 8; j++) {
+            CyberWord8 expected = (words[i] >> (56 - (j * 8))) & 0xFF;
+            XCTAssertEqual(expected, bytes[(i * 8) + j]);
+        }
+    }
+}
+
+- (void)testFetchOr64
+{
+    CyberWord64 word = 0x00FF00FF00FF00FF;
+    Cyber180CMPortWriteWordsPhysical(_port, 0x5000, &word, 1);
+
+    CyberWord64 previous = Cyber180CMPortFetchOr64(_port, 0x5000, 0x0F0F0F0F0F0F0F0F);
+    XCTAssertEqual(0x00FF00FF00FF00FF, previous);
+
+    Cyber180CMPortReadWordsPhysical(_port, 0x5000, &word, 1);
+    XCTAssertEqual(0x0FFF0FFF0FFF0FFF, word);
+}
+
+- (void)testFetchAnd64
+{
+    CyberWord64 word = 0x00FF00FF00FF00FF;
+    Cyber180CMPortWriteWordsPhysical(_port, 0x5000, &word, 1);
+
+    CyberWord64 previous = Cyber180CMPortFetchAnd64(_port, 0x5000, 0x0F0F0F0F0F0F0F0F);
+    XCTAssertEqual(0x00FF00FF00FF00FF, previous);
+
+    Cyber180CMPortReadWordsPhysical(_port, 0x5000, &word, 1);
+    XCTAssertEqual(0x000F000F000F000F, word);
+}
+
+- (void)testCompareExchange64
+{
+    CyberWord64 word = 0x1111111111111111;
+    Cyber180CMPortWriteWordsPhysical(_port, 0x5000, &word, 1);
+
+    // A mismatched expectation leaves memory alone and reports what's there.
+    CyberWord64 expected = 0x2222222222222222;
+    XCTAssertFalse(Cyber180CMPortCompareExchange64(_port, 0x5000, &expected, 0x3333333333333333));
+    XCTAssertEqual(0x1111111111111111, expected);
+
+    // A matched expectation replaces the word.
+    XCTAssertTrue(Cyber180CMPortCompareExchange64(_port, 0x5000, &expected, 0x3333333333333333));
+
+    Cyber180CMPortReadWordsPhysical(_port, 0x5000, &word, 1);
+    XCTAssertEqual(0x3333333333333333, word);
+}
+
+- (void)testPortStatistics
+{
+    struct Cyber180CMPortStatistics before;
+    Cyber180CMPortGetStatistics(_port, &before);
+
+    CyberWord64 words[4] = {0};
+    Cyber180CMPortWriteWordsPhysical(_port, 0x6000, words, 4);
+    Cyber180CMPortReadWordsPhysical(_port, 0x6000, words, 4);
+    (void) Cyber180CMPortReadWordPhysical(_port, 0x6000);
+    (void) Cyber180CMPortFetchOr64(_port, 0x6000, 1);
+
+    // A read-modify-write counts as both a read and a write; only the multiple-word accesses take the lock.
+    struct Cyber180CMPortStatistics after;
+    Cyber180CMPortGetStatistics(_port, &after);
+    XCTAssertEqual(3, after.reads - before.reads);
+    XCTAssertEqual(48, after.bytesRead - before.bytesRead);
+    XCTAssertEqual(2, after.writes - before.writes);
+    XCTAssertEqual(40, after.bytesWritten - before.bytesWritten);
+    XCTAssertEqual(2, after.lockAcquisitions - before.lockAcquisitions);
+    XCTAssertEqual(0, after.contendedLockAcquisitions - before.contendedLockAcquisitions);
+}
+
+- (void)testSparseStorage
+{
+    // A 1GB Central Memory should only commit host memory for what's touched.
+    const size_t capacity = 1024 * 1024 * 1024;
+    struct Cyber180CM *memory = Cyber180CMCreateWithStorage(_system, capacity, 2, Cyber180CMStorageSparse);
+    XCTAssertNotEqual(memory, NULL);
+    XCTAssertEqual(capacity, Cyber180CMGetCapacity(memory));
+
+    struct Cyber180CMPort *port = Cyber180CMGetPortAtIndex(memory, 0);
+
+    CyberWord64 word = 0;
+    Cyber180CMPortReadWordsPhysical(port, capacity - 8, &word, 1);
+    XCTAssertEqual(0, word);
+
+    word = 0x123456789abcdef0;
+    Cyber180CMPortWriteWordsPhysical(port, 0x30000000, &word, 1);
+    word = 0;
+    Cyber180CMPortReadWordsPhysical(port, 0x30000000, &word, 1);
+    XCTAssertEqual(0x123456789abcdef0, word);
+
+    XCTAssertLessThan(Cyber180CMGetCommittedSize(memory), (size_t)(1024 * 1024));
+
+    Cyber180CMDispose(memory);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
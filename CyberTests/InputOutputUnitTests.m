@@ -0,0 +1,98 @@
+//
+//  InputOutputUnitTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber962IOU_Internal.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for Input/Output Units.
+@interface InputOutputUnitTests : CyberTestCase
+@end
+
+
+@implementation InputOutputUnitTests {
+    struct Cyber962 *_system;
+    struct Cyber962IOU *_inputOutputUnit;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _system = Cyber962Create("Test", (64 * 1024 * 1024), 1, 1);
+    XCTAssertNotEqual(_system, NULL);
+
+    _inputOutputUnit = Cyber962GetInputOutputUnit(_system, 0);
+    XCTAssertNotEqual(_inputOutputUnit, NULL);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+- (void)testPeripheralProcessorsCreatedOnFirstUse
+{
+    for (int pp = 0; pp < 20; pp++) {
+        XCTAssertEqual(NULL, _inputOutputUnit->_peripheralProcessors[pp]);
+    }
+
+    struct Cyber962PP *peripheralProcessor = Cyber962IOUGetPeripheralProcessor(_inputOutputUnit, 7);
+    XCTAssertNotEqual(NULL, peripheralProcessor);
+    XCTAssertEqual(peripheralProcessor, Cyber962IOUGetPeripheralProcessor(_inputOutputUnit, 7));
+
+    for (int pp = 0; pp < 20; pp++) {
+        if (pp == 7) continue;
+        XCTAssertEqual(NULL, _inputOutputUnit->_peripheralProcessors[pp]);
+    }
+}
+
+- (void)testIOChannelsCreatedOnFirstUse
+{
+    for (int ioc = 0; ioc < 20; ioc++) {
+        XCTAssertEqual(NULL, _inputOutputUnit->_inputOutputChannels[ioc]);
+    }
+
+    struct Cyber962IOChannel *inputOutputChannel = Cyber962IOUGetIOChannelAtIndex(_inputOutputUnit, 12);
+    XCTAssertNotEqual(NULL, inputOutputChannel);
+    XCTAssertEqual(12, Cyber962IOChannelGetIndex(inputOutputChannel));
+    XCTAssertEqual(inputOutputChannel, Cyber962IOUGetIOChannelAtIndex(_inputOutputUnit, 12));
+}
+
+- (void)testPerformanceCreateAndDisposeSystem
+{
+    [self measureBlock:^{
+        for (int i = 0; i < 10; i++) {
+            struct Cyber962 *system = Cyber962Create("Test", (64 * 1024 * 1024), 1, 1);
+            Cyber962Dispose(system);
+        }
+    }];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
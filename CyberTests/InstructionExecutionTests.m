@@ -76,6 +76,36 @@ NS_ASSUME_NONNULL_BEGIN
     XCTAssertEqual(0x3E00000000000000LL, Cyber180CPInstruction_CalculateBitMask(2,5));
 }
 
+- (void)testDecodeDispatchesByOpcode
+{
+    // Spot-check opcodes across the whole table, so a missing or extra entry anywhere shifts at least one of them.
+    struct {
+        CyberWord8 opcode;
+        Cyber180CPInstruction instruction;
+    } expectations[] = {
+        { 0x10, Cyber180CPInstruction_INCX },
+        { 0x3d, Cyber180CPInstruction_ENTP },
+        { 0x5e, Cyber180CPInstruction_SCTIV },
+        { 0x5f, NULL },
+        { 0x70, Cyber180CPInstruction_ADDN },
+        { 0x82, Cyber180CPInstruction_LX },
+        { 0x8d, Cyber180CPInstruction_ENTE },
+        { 0xa2, Cyber180CPInstruction_LXI },
+        { 0xac, Cyber180CPInstruction_ISOM },
+        { 0xd0, Cyber180CPInstruction_LBYTS },
+        { 0xdf, Cyber180CPInstruction_SBYTS },
+        { 0xe4, Cyber180CPInstruction_SCLN },
+        { 0xfb, Cyber180CPInstruction_ADDI },
+        { 0xff, NULL },
+    };
+
+    for (size_t e = 0; e < (sizeof(expectations) / sizeof(expectations[0])); e++) {
+        union Cyber180CPInstructionWord instruction = { ._raw = ((CyberWord32)expectations[e].opcode) << 24 };
+        Cyber180CPInstruction decoded = Cyber180CPInstructionDecode(_processor, instruction, 0x00);
+        XCTAssertEqual(expectations[e].instruction, decoded, @"opcode %02x", expectations[e].opcode);
+    }
+}
+
 - (void)testInstruction_INCX
 {
     // Xk = Xk + j
@@ -321,6 +351,92 @@ NS_ASSUME_NONNULL_BEGIN
     XCTAssert(memcmp(expectedBytes, wordBytes, 8) == 0);
 }
 
+- (void)testInstruction_LX_AddressSpecificationError
+{
+    // Xk = (Aj + 8*Q), with Aj not on a word boundary
+    union Cyber180CPInstructionWord instruction;
+    instruction._jkQ.opcode = 0x82;
+    instruction._jkQ.j = 0x1;
+    instruction._jkQ.k = 0x2;
+    instruction._jkQ.Q = 0x3;
+
+    // Set up the registers and memory.
+    Cyber180CPSetA(_processor, 0x1, 0x101);
+    Cyber180CPSetX(_processor, 0x2, 0x5555);
+
+    // The fault leaves P at the instruction.
+    CyberWord64 advance = Cyber180CPInstruction_LX(_processor, instruction, 0x00);
+    XCTAssertEqual((CyberWord64)~0x0, advance);
+    XCTAssertEqual(0x5555, Cyber180CPGetX(_processor, 2));
+    XCTAssertEqual(Cyber180CPMonitorConditionAddressSpecificationError, _processor->_regMCR);
+}
+
+- (void)testInstruction_SX_AddressSpecificationError
+{
+    // (Aj + 8*Q) = Xk, with Aj not on a word boundary
+    union Cyber180CPInstructionWord instruction;
+    instruction._jkQ.opcode = 0x83;
+    instruction._jkQ.j = 0x1;
+    instruction._jkQ.k = 0x2;
+    instruction._jkQ.Q = 0x3;
+
+    // Set up the registers and memory.
+    Cyber180CPSetA(_processor, 0x1, 0x104);
+    Cyber180CPSetX(_processor, 0x2, 0x123456789abcdef0);
+    CyberWord8 zeroBytes[8] = {0};
+    Cyber180CPWriteBytes(_processor, 0x104 + (0x3 * 8), zeroBytes, 8);
+
+    // The fault leaves P at the instruction.
+    CyberWord64 advance = Cyber180CPInstruction_SX(_processor, instruction, 0x00);
+    XCTAssertEqual((CyberWord64)~0x0, advance);
+    XCTAssertEqual(Cyber180CPMonitorConditionAddressSpecificationError, _processor->_regMCR);
+
+    CyberWord8 wordBytes[8];
+    Cyber180CPReadBytes(_processor, 0x104 + (0x3 * 8), wordBytes, 8);
+    XCTAssert(memcmp(zeroBytes, wordBytes, 8) == 0);
+}
+
+- (void)testInstruction_LA
+{
+    // Ak = (Aj + Q)
+    union Cyber180CPInstructionWord instruction;
+    instruction._jkQ.opcode = 0x84;
+    instruction._jkQ.j = 0x1;
+    instruction._jkQ.k = 0x2;
+    instruction._jkQ.Q = 0x3;
+
+    // Set up the registers and memory.
+    Cyber180CPSetA(_processor, 0x1, 0x100);
+    CyberWord8 addressBytes[6] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+    Cyber180CPWriteBytes(_processor, 0x100 + 0x3, addressBytes, 6);
+
+    CyberWord64 advance = Cyber180CPInstruction_LA(_processor, instruction, 0x00);
+    XCTAssertEqual(4, advance);
+    XCTAssertEqual(0x123456789abc, Cyber180CPGetA(_processor, 2));
+}
+
+- (void)testInstruction_SA
+{
+    // (Aj + Q) = Ak
+    union Cyber180CPInstructionWord instruction;
+    instruction._jkQ.opcode = 0x85;
+    instruction._jkQ.j = 0x1;
+    instruction._jkQ.k = 0x2;
+    instruction._jkQ.Q = 0x3;
+
+    // Set up the registers and memory.
+    Cyber180CPSetA(_processor, 0x1, 0x100);
+    Cyber180CPSetA(_processor, 0x2, 0x123456789abc);
+
+    CyberWord64 advance = Cyber180CPInstruction_SA(_processor, instruction, 0x00);
+    XCTAssertEqual(4, advance);
+
+    CyberWord8 addressBytes[6];
+    Cyber180CPReadBytes(_processor, 0x100 + 0x3, addressBytes, 6);
+    CyberWord8 expectedBytes[6] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+    XCTAssert(memcmp(expectedBytes, addressBytes, 6) == 0);
+}
+
 - (void)testInstruction_ADDXQ
 {
     // Xk = Xk + Xj + Q
@@ -0,0 +1,355 @@
+//
+//  LockstepTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber180CP_Internal.h"
+#import "Cyber962PP_Internal.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for running a system in lockstep mode.
+@interface LockstepTests : CyberTestCase
+@end
+
+
+@implementation LockstepTests {
+    struct Cyber962 *_system;
+    struct Cyber180CP *_processor;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 3,
+    };
+    _system = Cyber962CreateWithConfiguration("Test", &configuration);
+    XCTAssertNotEqual(_system, NULL);
+    XCTAssertEqual(Cyber962RunModeLockstep, Cyber962GetRunMode(_system));
+
+    _processor = Cyber962GetCentralProcessor(_system, 0);
+    XCTAssertNotEqual(_processor, NULL);
+
+    // Fill the start of memory with INCX X2,3 instructions.
+    CyberWord8 program[64];
+    for (int i = 0; i < 64; i += 2) {
+        program[i + 0] = 0x10;
+        program[i + 1] = 0x32;
+    }
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0000, program, 64);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+- (void)testNoThreads
+{
+    XCTAssertEqual(NULL, _processor->_thread);
+}
+
+- (void)testStoppedProcessorDoesNotRun
+{
+    Cyber962RunLockstepRounds(_system, 5);
+
+    XCTAssertEqual(0, _processor->_regP);
+    XCTAssertEqual(0, Cyber180CPGetX(_processor, 2));
+}
+
+- (void)testInstructionsPerRound
+{
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 5);
+
+    // 5 rounds of 3 instructions of 2 bytes each.
+    XCTAssertEqual(30, _processor->_regP);
+    XCTAssertEqual(45, Cyber180CPGetX(_processor, 2));
+
+    Cyber180CPStop(_processor);
+    Cyber962RunLockstepRounds(_system, 5);
+
+    XCTAssertEqual(30, _processor->_regP);
+}
+
+- (void)testMonitorConditionStopsProcessor
+{
+    // INCX X2,3 and then LX X2,(A1+3*8) with A1 not on a word boundary.
+    CyberWord8 program[4] = { 0x82, 0x12, 0x00, 0x03 };
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0002, program, 4);
+    Cyber180CPSetA(_processor, 1, 0x101);
+
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 2);
+
+    // The Address Specification Error stops the CP at the LX, so the rest of the round and the next one don't run.
+    XCTAssertEqual(Cyber180CPMonitorConditionAddressSpecificationError, _processor->_regMCR);
+    XCTAssertFalse(_processor->_running);
+    XCTAssertEqual(2, _processor->_regP);
+    XCTAssertEqual(3, Cyber180CPGetX(_processor, 2));
+    XCTAssertEqual(2, Cyber180CPGetInstructionCount(_processor));
+}
+
+- (void)testStatistics
+{
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 5);
+
+    struct Cyber962Statistics statistics;
+    Cyber962GetStatistics(_system, &statistics);
+    XCTAssertNotEqual(0, statistics.nanoseconds);
+
+    // A Central Processor starts out in monitor mode.
+    XCTAssertEqual(1, statistics.centralProcessorCount);
+    XCTAssertEqual(0, statistics.centralProcessors[0].jobInstructions);
+    XCTAssertEqual(15, statistics.centralProcessors[0].monitorInstructions);
+    XCTAssertEqual(15, Cyber180CPGetInstructionCount(_processor));
+
+    // No PPs have been created, so none have run.
+    XCTAssertEqual(1, statistics.inputOutputUnitCount);
+    for (int pp = 0; pp < 20; pp++) {
+        XCTAssertEqual(0, statistics.peripheralProcessorInstructions[0][pp]);
+    }
+
+    // Each instruction was fetched through the CP's port, and the setup wrote through it.
+    XCTAssertEqual(2, statistics.centralMemoryPortCount);
+    XCTAssertGreaterThanOrEqual(statistics.centralMemoryPorts[0].reads, 15);
+    XCTAssertEqual(1, statistics.centralMemoryPorts[0].writes);
+    XCTAssertEqual(64, statistics.centralMemoryPorts[0].bytesWritten);
+    XCTAssertEqual(0, statistics.centralMemoryPorts[1].reads);
+}
+
+- (void)testPeripheralProcessorPortStatistics
+{
+    // Fill two PPs with CRD instructions, which each read one word through the I/O Unit's shared port.
+    struct Cyber962IOU *inputOutputUnit = Cyber962GetInputOutputUnit(_system, 0);
+    for (int index = 0; index < 2; index++) {
+        struct Cyber962PP *peripheralProcessor = Cyber962IOUGetPeripheralProcessor(inputOutputUnit, index);
+        XCTAssertNotEqual(peripheralProcessor, NULL);
+
+        for (CyberWord16 address = 0100; address < 0200; address++) {
+            Cyber962PPWriteSingle(peripheralProcessor, address, (010 << 10) | (060 << 4)); // CRD 10
+        }
+        peripheralProcessor->_regP = 0100;
+        peripheralProcessor->_regA = 0x20000 | 0x1000;
+        Cyber962PPStart(peripheralProcessor);
+    }
+
+    Cyber962RunLockstepRounds(_system, 10);
+
+    // Each PP counts its accesses separately, and they're added together for the port.
+    struct Cyber962Statistics statistics;
+    Cyber962GetStatistics(_system, &statistics);
+    XCTAssertEqual(10, statistics.peripheralProcessorInstructions[0][0]);
+    XCTAssertEqual(10, statistics.peripheralProcessorInstructions[0][1]);
+    XCTAssertEqual(20, statistics.centralMemoryPorts[1].reads);
+    XCTAssertEqual(160, statistics.centralMemoryPorts[1].bytesRead);
+    XCTAssertEqual(0, statistics.centralMemoryPorts[1].writes);
+}
+
+- (void)testOpcodeStatistics
+{
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 5);
+
+    struct Cyber180CPOpcodeStatistics *statistics = calloc(1, sizeof(struct Cyber180CPOpcodeStatistics));
+    bool enabled = Cyber962GetCentralProcessorOpcodeStatistics(_system, statistics);
+    XCTAssertEqual(CyberOpcodeStatisticsAreEnabled(), enabled);
+
+    // When statistics are compiled out, nothing is counted.
+    uint64_t expected = enabled ? 15 : 0;
+    XCTAssertEqual(expected, statistics->opcodes[0x10].count);
+
+    uint64_t histogramTotal = 0;
+    for (int bucket = 0; bucket < CYBER_OPCODE_HISTOGRAM_BUCKETS; bucket++) {
+        histogramTotal += statistics->opcodes[0x10].histogram[bucket];
+    }
+    XCTAssertEqual(expected, histogramTotal);
+
+    for (int opcode = 0; opcode < CYBER180CP_OPCODE_COUNT; opcode++) {
+        if (opcode == 0x10) continue;
+        XCTAssertEqual(0, statistics->opcodes[opcode].count);
+    }
+
+    free(statistics);
+}
+
+
+- (void)testKeypointTrace
+{
+    // ENTX X1,0x25 followed by KEYPOINT class 3, code X1 + 0x10, then the INCX instructions.
+    CyberWord8 program[6] = { 0x39, 0x25, 0xB1, 0x31, 0x00, 0x10 };
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0000, program, 6);
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue(Cyber962StartKeypointTrace(_system, path.fileSystemRepresentation));
+
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 2);
+
+    // The keypoint advances P like any other jkQ instruction.
+    XCTAssertEqual(14, _processor->_regP);
+    uint64_t dropped = UINT64_MAX;
+    XCTAssertTrue(Cyber962StopKeypointTrace(_system, &dropped));
+    XCTAssertEqual(0, dropped);
+
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(path.fileSystemRepresentation);
+    XCTAssertNotEqual(NULL, reader);
+
+    const struct CyberTraceFileHeader *header = CyberTraceReaderGetHeader(reader);
+    XCTAssertEqual(CYBER_TRACE_VERSION, header->version);
+    XCTAssertEqual(CyberTraceKindKeypoint, header->kind);
+
+    struct CyberTraceChunkHeader chunk;
+    const struct CyberKeypointRecord *records = CyberTraceReaderNextChunk(reader, &chunk);
+    XCTAssertNotEqual(NULL, records);
+    XCTAssertEqual(CYBER_TRACE_CP_STREAM(0), chunk.stream);
+    XCTAssertEqual(sizeof(struct CyberKeypointRecord), chunk.length);
+    XCTAssertEqual(CyberTraceProcessorKindCentral, records[0].processorKind);
+    XCTAssertEqual(0, records[0].processorIndex);
+    XCTAssertEqual(3, records[0].keypointClass);
+    XCTAssertEqual(0x35, records[0].code);
+    XCTAssertEqual(2, records[0].address);
+    XCTAssertGreaterThanOrEqual(records[0].ticks, header->startTicks);
+
+    XCTAssertEqual(NULL, CyberTraceReaderNextChunk(reader, &chunk));
+
+    CyberTraceReaderClose(reader);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+
+- (void)testTimelineTrace
+{
+    // INCX X2,3 followed by an EXCHANGE, which doesn't advance P yet, so it's executed for the rest of the round.
+    CyberWord8 program[2] = { 0x02, 0x00 };
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0002, program, 2);
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue(Cyber962StartTimelineTrace(_system, path.fileSystemRepresentation));
+
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 1);
+    Cyber180CPStop(_processor);
+    uint64_t dropped = UINT64_MAX;
+    XCTAssertTrue(Cyber962StopTimelineTrace(_system, &dropped));
+    XCTAssertEqual(0, dropped);
+
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(path.fileSystemRepresentation);
+    XCTAssertNotEqual(NULL, reader);
+    const struct CyberTraceFileHeader *header = CyberTraceReaderGetHeader(reader);
+    XCTAssertEqual(CyberTraceKindTimeline, header->kind);
+
+    // The drain thread may have split the stream into several chunks.
+    struct CyberTimelineRecord records[8];
+    size_t count = 0;
+    struct CyberTraceChunkHeader chunk;
+    const struct CyberTimelineRecord *chunkRecords;
+    while ((chunkRecords = CyberTraceReaderNextChunk(reader, &chunk)) != NULL) {
+        XCTAssertEqual(CYBER_TRACE_CP_STREAM(0), chunk.stream);
+        for (size_t i = 0; (i < (chunk.length / sizeof(struct CyberTimelineRecord))) && (count < 8); i++) {
+            records[count++] = chunkRecords[i];
+        }
+    }
+
+    // The processor starts out stopped, runs an INCX and two EXCHANGEs, stops, and then the timeline ends.
+    XCTAssertEqual(6, count);
+    XCTAssertEqual(CyberTimelineEventStopped, records[0].event);
+    XCTAssertEqual(CyberTimelineEventRunning, records[1].event);
+    XCTAssertEqual(CyberTimelineEventExchange, records[2].event);
+    XCTAssertEqual(2, records[2].value);
+    XCTAssertEqual(CyberTimelineEventExchange, records[3].event);
+    XCTAssertEqual(CyberTimelineEventStopped, records[4].event);
+    XCTAssertEqual(CyberTimelineEventEnd, records[5].event);
+    for (size_t i = 1; i < count; i++) {
+        XCTAssertGreaterThanOrEqual(records[i].ticks, records[i - 1].ticks);
+    }
+
+    CyberTraceReaderClose(reader);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+
+- (void)testInstructionTrace
+{
+    Cyber180CPSetA(_processor, 5, 0x123456789abc);
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue(Cyber962StartInstructionTrace(_system, path.fileSystemRepresentation));
+
+    Cyber180CPStart(_processor);
+    Cyber962RunLockstepRounds(_system, 5);
+    uint64_t dropped = UINT64_MAX;
+    XCTAssertTrue(Cyber962StopInstructionTrace(_system, &dropped));
+    XCTAssertEqual(0, dropped);
+
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(path.fileSystemRepresentation);
+    XCTAssertNotEqual(NULL, reader);
+    XCTAssertEqual(CyberTraceKindInstruction, CyberTraceReaderGetHeader(reader)->kind);
+
+    // Replaying the trace reconstructs every INCX X2,3 and the registers after it.
+    struct CyberInstructionTraceState state = { 0 };
+    struct CyberTraceChunkHeader chunk;
+    const CyberWord8 *records;
+    int instructions = 0;
+    while ((records = CyberTraceReaderNextChunk(reader, &chunk)) != NULL) {
+        XCTAssertEqual(CYBER_TRACE_CP_STREAM(0), chunk.stream);
+
+        size_t offset = 0;
+        while (offset < chunk.length) {
+            struct CyberInstructionRecord record;
+            size_t used = CyberInstructionTraceDecode(&state, records + offset, chunk.length - offset, &record);
+            XCTAssertNotEqual(0, used);
+            if (used == 0) break;
+            offset += used;
+
+            XCTAssertEqual(instructions * 2, record.address);
+            XCTAssertEqual(0x10320000, record.instruction);
+            XCTAssertEqual(2, record.length);
+            XCTAssertEqual(instructions == 0, record.keyframe);
+            if (!record.keyframe) {
+                XCTAssertEqual(1U << 2, record.changedRegisters);
+            }
+            instructions += 1;
+            XCTAssertEqual(instructions * 3, state.x[2]);
+        }
+    }
+    XCTAssertEqual(15, instructions);
+    XCTAssertEqual(_processor->_regP, state.address);
+    XCTAssertEqual(0x123456789abc, state.a[5]);
+
+    CyberTraceReaderClose(reader);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,149 @@
+//
+//  PeripheralProcessorInstructionTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber962PP_Internal.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// A PP instruction word for an opcode written as it is in the decoder (`g` as the octal 01000 bit, then `f`) and a `d` field.
+#define PP_WORD(opcode, d)  ((CyberWord16)((((opcode) >> 9) & 01) | (((opcode) & 077) << 4) | (((d) & 077) << 10)))
+
+
+/// Tests for executing Peripheral Processor instructions.
+@interface PeripheralProcessorInstructionTests : CyberTestCase
+@end
+
+
+@implementation PeripheralProcessorInstructionTests {
+    struct Cyber962 *_system;
+    struct Cyber962PP *_processor;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    // A lockstep system never starts processor threads, so its PP can be stepped directly.
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 1,
+    };
+    _system = Cyber962CreateWithConfiguration("Test", &configuration);
+    XCTAssertNotEqual(_system, NULL);
+
+    _processor = Cyber962IOUGetPeripheralProcessor(Cyber962GetInputOutputUnit(_system, 0), 0);
+    XCTAssertNotEqual(_processor, NULL);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+/// Step a single instruction at address 0100 with the given `A`, and get the resulting `P`.
+- (CyberWord16)stepInstruction:(CyberWord16)word m:(CyberWord16)m A:(CyberWord18)A
+{
+    Cyber962PPWriteSingle(_processor, 0100, word);
+    Cyber962PPWriteSingle(_processor, 0101, m);
+    _processor->_regA = A;
+    _processor->_regP = 0100;
+
+    Cyber962PPSingleStep(_processor);
+    return _processor->_regP;
+}
+
+- (void)testPassAdvancesP
+{
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(00000, 0) m:0 A:0]);
+}
+
+- (void)testShortBranchTaken
+{
+    // Displacements are 6-bit one's complement, so 073 is -4.
+    XCTAssertEqual(0105, [self stepInstruction:PP_WORD(00003, 5) m:0 A:0]); // UJN +5
+    XCTAssertEqual(0074, [self stepInstruction:PP_WORD(00003, 073) m:0 A:0]); // UJN -4
+    XCTAssertEqual(0102, [self stepInstruction:PP_WORD(00004, 2) m:0 A:0]); // ZJN +2
+    XCTAssertEqual(0102, [self stepInstruction:PP_WORD(00005, 2) m:0 A:1]); // NJN +2
+    XCTAssertEqual(0102, [self stepInstruction:PP_WORD(00006, 2) m:0 A:1]); // PJN +2
+    XCTAssertEqual(0102, [self stepInstruction:PP_WORD(00007, 2) m:0 A:0x20000]); // MJN +2
+}
+
+- (void)testShortBranchNotTaken
+{
+    // An untaken branch continues with the next instruction, whatever its displacement.
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(00004, 5) m:0 A:1]); // ZJN
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(00005, 5) m:0 A:0]); // NJN
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(00006, 5) m:0 A:0x20000]); // PJN
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(00007, 5) m:0 A:1]); // MJN
+}
+
+- (void)testLongJump
+{
+    // Jump to m+(d), indexing by a direct cell.
+    Cyber962PPWriteSingle(_processor, 012, 3);
+    XCTAssertEqual(02003, [self stepInstruction:PP_WORD(00001, 012) m:02000 A:0]); // LJM 2000+(12)
+    XCTAssertEqual(00043, [self stepInstruction:PP_WORD(00001, 012) m:00040 A:0]); // LJM 40+(12)
+}
+
+- (void)testReturnJump
+{
+    // The return address, just past the RJM, is stored at m+(d), and execution continues after it.
+    Cyber962PPWriteSingle(_processor, 012, 0);
+    XCTAssertEqual(02001, [self stepInstruction:PP_WORD(00002, 012) m:02000 A:0]); // RJM 2000+(12)
+    XCTAssertEqual(0102, Cyber962PPReadSingle(_processor, 02000));
+}
+
+- (void)testOneWordInstructionsAdvanceP
+{
+    // These once fell through to returning an advance of 0, so stepping them executed the same copy forever.
+    Cyber962PPWriteSingle(_processor, 011, 03000);
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(01045, 011) m:0 A:0]); // RAIL ((11))
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(01000, 020) m:0 A:(0x20000 | 0x1000)]); // RDSL 20,(A)
+    XCTAssertEqual(0101, [self stepInstruction:PP_WORD(01001, 020) m:0 A:(0x20000 | 0x1000)]); // RDCL 20,(A)
+}
+
+- (void)testLoopRepeats
+{
+    // Three PSNs followed by a UJN back to the first execute as a loop.
+    for (CyberWord16 address = 0100; address < 0103; address++) {
+        Cyber962PPWriteSingle(_processor, address, PP_WORD(00000, 0));
+    }
+    Cyber962PPWriteSingle(_processor, 0103, PP_WORD(00003, 074)); // UJN -3
+    _processor->_regP = 0100;
+
+    for (int step = 0; step < 8; step++) {
+        Cyber962PPSingleStep(_processor);
+    }
+    XCTAssertEqual(0100, _processor->_regP);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,71 @@
+//
+//  ProcessorLayoutTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber180CP_Internal.h"
+#import "Cyber962PP_Internal.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests that each processor's state is laid out on cache lines of its own.
+///
+/// What this layout gains when every processor runs at once is measured by the `compare-layouts` target of the CMake build, which runs `cyberbench` against `cyberbench-packed`.
+@interface ProcessorLayoutTests : CyberTestCase
+@end
+
+
+@implementation ProcessorLayoutTests {
+    struct Cyber962 *_system;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _system = Cyber962Create("Test", (64 * 1024 * 1024), 2, 1);
+    XCTAssertNotEqual(_system, NULL);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+- (void)testProcessorLayoutDoesNotShareCacheLines
+{
+    // The registers of every processor must start on a cache line of their own.
+    struct Cyber180CP *centralProcessor = Cyber962GetCentralProcessor(_system, 0);
+    XCTAssertEqual(0, ((uintptr_t)&centralProcessor->_regP) % CYBER_CACHE_LINE_SIZE);
+    XCTAssertEqual(0, sizeof(struct Cyber180CP) % CYBER_CACHE_LINE_SIZE);
+
+    struct Cyber962PP *peripheralProcessor = Cyber962IOUGetPeripheralProcessor(Cyber962GetInputOutputUnit(_system, 0), 0);
+    XCTAssertEqual(0, ((uintptr_t)&peripheralProcessor->_regA) % CYBER_CACHE_LINE_SIZE);
+    XCTAssertEqual(0, sizeof(struct Cyber962PP) % CYBER_CACHE_LINE_SIZE);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
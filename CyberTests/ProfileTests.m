@@ -0,0 +1,171 @@
+//
+//  ProfileTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber180CP_Internal.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for sampling where processors spend their time, and for symbol maps.
+@interface ProfileTests : CyberTestCase
+@end
+
+
+@implementation ProfileTests {
+    struct Cyber962 *_system;
+    struct Cyber180CP *_processor;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeLockstep,
+        .centralProcessorInstructionsPerRound = 1,
+    };
+    _system = Cyber962CreateWithConfiguration("Test", &configuration);
+    XCTAssertNotEqual(_system, NULL);
+
+    _processor = Cyber962GetCentralProcessor(_system, 0);
+    XCTAssertNotEqual(_processor, NULL);
+
+    // INCX X2,3 followed by an EXCHANGE, which doesn't advance P yet, so the processor stays there.
+    CyberWord8 program[4] = { 0x10, 0x32, 0x02, 0x00 };
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0000, program, 4);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+/// Write `contents` to a new temporary file, returning its path.
+- (NSString *)temporaryFileWithContents:(NSString *)contents
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue([contents writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:NULL]);
+    return path;
+}
+
+- (void)testProfileRunningProcessor
+{
+    XCTAssertTrue(Cyber962StartProfiler(_system, 2000));
+
+    Cyber180CPStart(_processor);
+    NSDate *end = [NSDate dateWithTimeIntervalSinceNow:0.05];
+    while ([end timeIntervalSinceNow] > 0) {
+        Cyber962RunLockstepRounds(_system, 1000);
+    }
+
+    struct CyberProfile *profile = Cyber962StopProfiler(_system);
+    XCTAssertNotEqual(NULL, profile);
+    XCTAssertGreaterThan(CyberProfileGetSampleCount(profile), 0);
+    XCTAssertGreaterThanOrEqual(CyberProfileGetSeconds(profile), 0.05);
+
+    // Every sample finds the CP at the INCX or, almost always, spinning on the EXCHANGE.
+    size_t count = 0;
+    const struct CyberProfileEntry *entries = CyberProfileGetEntries(profile, &count);
+    XCTAssertGreaterThanOrEqual(count, 1);
+    XCTAssertLessThanOrEqual(count, 2);
+
+    uint64_t samples = 0;
+    for (size_t i = 0; i < count; i++) {
+        XCTAssertEqual(CyberTraceProcessorKindCentral, entries[i].processorKind);
+        XCTAssertEqual(0, entries[i].processorIndex);
+        XCTAssertTrue((entries[i].address == 0) || (entries[i].address == 2));
+        samples += entries[i].samples;
+    }
+    XCTAssertEqual(CyberProfileGetSampleCount(profile), samples);
+    XCTAssertEqual(2, entries[count - 1].address);
+
+    CyberProfileDispose(profile);
+}
+
+- (void)testProfileSkipsStoppedProcessors
+{
+    XCTAssertTrue(Cyber962StartProfiler(_system, 2000));
+    usleep(20000);
+
+    struct CyberProfile *profile = Cyber962StopProfiler(_system);
+    XCTAssertNotEqual(NULL, profile);
+    XCTAssertEqual(0, CyberProfileGetSampleCount(profile));
+
+    size_t count = 1;
+    (void) CyberProfileGetEntries(profile, &count);
+    XCTAssertEqual(0, count);
+
+    CyberProfileDispose(profile);
+}
+
+- (void)testStopWithoutStart
+{
+    XCTAssertEqual(NULL, Cyber962StopProfiler(_system));
+}
+
+- (void)testSymbolMapLookup
+{
+    NSString *path = [self temporaryFileWithContents:@"# CP symbols\n"
+                      "\n"
+                      "0x2000 second\n"
+                      "1000 first\n"
+                      "0o20000  third with spaces  \n"];
+
+    struct CyberSymbolMap *map = CyberSymbolMapCreateWithFile(path.fileSystemRepresentation);
+    XCTAssertNotEqual(NULL, map);
+    XCTAssertEqual(3, CyberSymbolMapGetCount(map));
+
+    uint64_t offset = 0;
+    XCTAssertEqual(NULL, CyberSymbolMapLookup(map, 0x0FFF, &offset));
+    XCTAssertEqualObjects(@"first", @(CyberSymbolMapLookup(map, 0x1000, &offset)));
+    XCTAssertEqual(0, offset);
+    XCTAssertEqualObjects(@"first", @(CyberSymbolMapLookup(map, 0x1FFE, &offset)));
+    XCTAssertEqual(0xFFE, offset);
+    XCTAssertEqualObjects(@"third with spaces", @(CyberSymbolMapLookup(map, 0x2000, &offset)));
+    XCTAssertEqual(0, offset);
+    XCTAssertEqualObjects(@"third with spaces", @(CyberSymbolMapLookup(map, 0xFFFFFF, NULL)));
+
+    CyberSymbolMapDispose(map);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testMalformedSymbolMap
+{
+    NSString *path = [self temporaryFileWithContents:@"1000 first\nzzz second\n"];
+    XCTAssertEqual(NULL, CyberSymbolMapCreateWithFile(path.fileSystemRepresentation));
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+
+    path = [self temporaryFileWithContents:@"1000\n"];
+    XCTAssertEqual(NULL, CyberSymbolMapCreateWithFile(path.fileSystemRepresentation));
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
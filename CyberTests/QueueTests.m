@@ -0,0 +1,215 @@
+//
+//  QueueTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "CyberQueue.h"
+
+#import <pthread.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for the CyberQueue ring buffer.
+@interface QueueTests : CyberTestCase
+@end
+
+
+/// The number of elements each producer and consumer thread handles in the concurrency test.
+static const intptr_t QueueTestsElementsPerThread = 100000;
+
+
+static void *QueueTestsProducer(void *qv)
+{
+    struct CyberQueue *q = qv;
+
+    for (intptr_t i = 1; i <= QueueTestsElementsPerThread; i++) {
+        CyberQueueEnqueue(q, (void *)i);
+    }
+
+    return NULL;
+}
+
+static void *QueueTestsConsumer(void *qv)
+{
+    struct CyberQueue *q = qv;
+    intptr_t sum = 0;
+
+    for (intptr_t i = 1; i <= QueueTestsElementsPerThread; i++) {
+        sum += (intptr_t)CyberQueueDequeue(q);
+    }
+
+    return (void *)sum;
+}
+
+
+@implementation QueueTests
+
+- (void)testFirstInFirstOut
+{
+    struct CyberQueue *q = CyberQueueCreateWithCapacity(8);
+    XCTAssertNotEqual(q, NULL);
+
+    for (intptr_t i = 1; i <= 5; i++) {
+        CyberQueueEnqueue(q, (void *)i);
+    }
+    for (intptr_t i = 1; i <= 5; i++) {
+        XCTAssertEqual((void *)i, CyberQueueDequeue(q));
+    }
+
+    CyberQueueDispose(q);
+}
+
+- (void)testGetCount
+{
+    struct CyberQueue *q = CyberQueueCreateWithCapacity(8);
+    XCTAssertNotEqual(q, NULL);
+    XCTAssertEqual(0, CyberQueueGetCount(q));
+
+    for (intptr_t i = 1; i <= 5; i++) {
+        CyberQueueEnqueue(q, (void *)i);
+    }
+    XCTAssertEqual(5, CyberQueueGetCount(q));
+
+    (void) CyberQueueDequeue(q);
+    (void) CyberQueueDequeue(q);
+    XCTAssertEqual(3, CyberQueueGetCount(q));
+
+    CyberQueueDispose(q);
+}
+
+- (void)testTryDequeueWhenEmpty
+{
+    struct CyberQueue *q = CyberQueueCreate();
+    XCTAssertNotEqual(q, NULL);
+
+    XCTAssertEqual(NULL, CyberQueueTryDequeue(q));
+
+    CyberQueueEnqueue(q, (void *)1);
+    XCTAssertEqual((void *)1, CyberQueueTryDequeue(q));
+    XCTAssertEqual(NULL, CyberQueueTryDequeue(q));
+
+    CyberQueueDispose(q);
+}
+
+- (void)testTryEnqueueWhenFull
+{
+    struct CyberQueue *q = CyberQueueCreateWithCapacity(4);
+    XCTAssertNotEqual(q, NULL);
+
+    // Go around the ring more than once to exercise wrapping.
+    for (int lap = 0; lap < 3; lap++) {
+        for (intptr_t i = 1; i <= 4; i++) {
+            XCTAssertTrue(CyberQueueTryEnqueue(q, (void *)i));
+        }
+        XCTAssertFalse(CyberQueueTryEnqueue(q, (void *)5));
+
+        for (intptr_t i = 1; i <= 4; i++) {
+            XCTAssertEqual((void *)i, CyberQueueTryDequeue(q));
+        }
+    }
+
+    CyberQueueDispose(q);
+}
+
+- (void)testMultipleProducersAndConsumers
+{
+    // Use a small queue so producers and consumers both have to block.
+    struct CyberQueue *q = CyberQueueCreateWithCapacity(16);
+    XCTAssertNotEqual(q, NULL);
+
+    const int threadCount = 4;
+    pthread_t producers[threadCount];
+    pthread_t consumers[threadCount];
+
+    for (int t = 0; t < threadCount; t++) {
+        pthread_create(&producers[t], NULL, QueueTestsProducer, q);
+        pthread_create(&consumers[t], NULL, QueueTestsConsumer, q);
+    }
+
+    intptr_t total = 0;
+    for (int t = 0; t < threadCount; t++) {
+        void *sum = NULL;
+        pthread_join(producers[t], NULL);
+        pthread_join(consumers[t], &sum);
+        total += (intptr_t)sum;
+    }
+
+    // Every element must have been dequeued exactly once.
+    intptr_t expected = threadCount * ((QueueTestsElementsPerThread * (QueueTestsElementsPerThread + 1)) / 2);
+    XCTAssertEqual(expected, total);
+    XCTAssertEqual(NULL, CyberQueueTryDequeue(q));
+
+    CyberQueueDispose(q);
+}
+
+- (void)testEnqueueAndDequeueMany
+{
+    struct CyberQueue *q = CyberQueueCreateWithCapacity(8);
+    XCTAssertNotEqual(q, NULL);
+
+    void *elements[10];
+    for (intptr_t i = 0; i < 10; i++) {
+        elements[i] = (void *)(i + 1);
+    }
+
+    // Only as many as fit are enqueued.
+    XCTAssertEqual(8, CyberQueueTryEnqueueMany(q, elements, 10));
+
+    void *dequeued[10];
+    XCTAssertEqual(3, CyberQueueTryDequeueMany(q, dequeued, 3));
+    for (int i = 0; i < 3; i++) {
+        XCTAssertEqual(elements[i], dequeued[i]);
+    }
+
+    // The rest wrap around the ring.
+    XCTAssertEqual(2, CyberQueueTryEnqueueMany(q, &elements[8], 2));
+
+    XCTAssertEqual(7, CyberQueueDequeueMany(q, dequeued, 10));
+    for (int i = 0; i < 7; i++) {
+        XCTAssertEqual(elements[3 + i], dequeued[i]);
+    }
+
+    XCTAssertEqual(0, CyberQueueTryDequeueMany(q, dequeued, 10));
+
+    CyberQueueDispose(q);
+}
+
+- (void)testDequeueManyWithTimeout
+{
+    struct CyberQueue *q = CyberQueueCreate();
+    XCTAssertNotEqual(q, NULL);
+
+    void *dequeued[4];
+    NSDate *start = [NSDate date];
+    XCTAssertEqual(0, CyberQueueDequeueManyWithTimeout(q, dequeued, 4, 50 * 1000000));
+    XCTAssertGreaterThanOrEqual([[NSDate date] timeIntervalSinceDate:start], 0.045);
+
+    CyberQueueEnqueue(q, (void *)1);
+    XCTAssertEqual(1, CyberQueueDequeueManyWithTimeout(q, dequeued, 4, 50 * 1000000));
+    XCTAssertEqual((void *)1, dequeued[0]);
+
+    CyberQueueDispose(q);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,154 @@
+//
+//  SafepointTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber180CP_Internal.h"
+
+#import <unistd.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for pausing a threaded system at safepoints.
+@interface SafepointTests : CyberTestCase
+@end
+
+
+@implementation SafepointTests {
+    struct Cyber962 *_system;
+    struct Cyber180CP *_processor;
+}
+
+- (void)setUp
+{
+    [super setUp];
+
+    _system = Cyber962Create("Test", (64 * 1024 * 1024), 1, 1);
+    XCTAssertNotEqual(_system, NULL);
+
+    _processor = Cyber962GetCentralProcessor(_system, 0);
+    XCTAssertNotEqual(_processor, NULL);
+}
+
+- (void)tearDown
+{
+    Cyber962Dispose(_system);
+    _system = NULL;
+
+    [super tearDown];
+}
+
+- (void)testPauseWithNothingRunning
+{
+    Cyber962PauseAll(_system);
+    XCTAssertTrue(Cyber962IsPaused(_system));
+
+    Cyber962ResumeAll(_system);
+    XCTAssertFalse(Cyber962IsPaused(_system));
+}
+
+- (void)testPausedProcessorDoesNotRun
+{
+    // Start the CP spinning on the HALT at address 0, then pause it.
+    Cyber180CPStart(_processor);
+    Cyber962PauseAll(_system);
+
+    // While paused, the machine state can be safely modified: Fill the start of memory with INCX X2,1 instructions.
+    CyberWord8 program[64];
+    for (int i = 0; i < 64; i += 2) {
+        program[i + 0] = 0x10;
+        program[i + 1] = 0x12;
+    }
+    Cyber180CMPortWriteBytesPhysical(Cyber180CPGetCentralMemoryPort(_processor), 0x0000, program, 64);
+    Cyber180CPSetX(_processor, 2, 0);
+
+    usleep(10000);
+    XCTAssertEqual(0, Cyber180CPGetX(_processor, 2));
+    XCTAssertEqual(0, _processor->_regP);
+
+    // Once resumed, the CP runs through the INCX instructions to the HALT following them.
+    Cyber962ResumeAll(_system);
+    for (int attempt = 0; (attempt < 1000) && (__atomic_load_n(&_processor->_regP, __ATOMIC_RELAXED) != 64); attempt++) {
+        usleep(1000);
+    }
+
+    Cyber962PauseAll(_system);
+    XCTAssertEqual(64, _processor->_regP);
+    XCTAssertEqual(32, Cyber180CPGetX(_processor, 2));
+
+    // Shut down the CP while it's parked; pausing again waits for it to leave its main loop.
+    Cyber180CPShutDown(_processor);
+    Cyber962ResumeAll(_system);
+    Cyber962PauseAll(_system);
+    Cyber962ResumeAll(_system);
+}
+
+- (void)testProcessorStartedWhilePausedWaits
+{
+    // A CP started during a pause doesn't even register until it's resumed, so starting a timeline trace meanwhile is the only thing recording to its stream.
+    Cyber962PauseAll(_system);
+    Cyber180CPStart(_processor);
+    usleep(10000);
+    XCTAssertFalse(_processor->_safepointRegistered);
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    XCTAssertTrue(Cyber962StartTimelineTrace(_system, path.fileSystemRepresentation));
+
+    Cyber962ResumeAll(_system);
+    for (int attempt = 0; (attempt < 1000) && !__atomic_load_n(&_processor->_safepointRegistered, __ATOMIC_RELAXED); attempt++) {
+        usleep(1000);
+    }
+
+    Cyber962PauseAll(_system);
+    uint64_t dropped = UINT64_MAX;
+    XCTAssertTrue(Cyber962StopTimelineTrace(_system, &dropped));
+    XCTAssertEqual(0, dropped);
+    Cyber962ResumeAll(_system);
+
+    struct CyberTraceReader *reader = CyberTraceReaderOpen(path.fileSystemRepresentation);
+    XCTAssertNotEqual(NULL, reader);
+
+    struct CyberTimelineRecord records[8];
+    size_t count = 0;
+    struct CyberTraceChunkHeader chunk;
+    const struct CyberTimelineRecord *chunkRecords;
+    while ((chunkRecords = CyberTraceReaderNextChunk(reader, &chunk)) != NULL) {
+        if (chunk.stream != CYBER_TRACE_CP_STREAM(0)) continue;
+        for (size_t i = 0; (i < (chunk.length / sizeof(struct CyberTimelineRecord))) && (count < 8); i++) {
+            records[count++] = chunkRecords[i];
+        }
+    }
+
+    // The CP's timeline starts out stopped, and it only starts running once resumed, spinning on the HALT at address 0 until it parks again.
+    XCTAssertEqual(4, count);
+    XCTAssertEqual(CyberTimelineEventStopped, records[0].event);
+    XCTAssertEqual(CyberTimelineEventRunning, records[1].event);
+    XCTAssertEqual(CyberTimelineEventParked, records[2].event);
+    XCTAssertEqual(CyberTimelineEventEnd, records[3].event);
+
+    CyberTraceReaderClose(reader);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
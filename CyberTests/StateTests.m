@@ -0,0 +1,154 @@
+//
+//  StateTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "CyberState_Internal.h"
+
+#import <pthread.h>
+#import <unistd.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for CyberState.
+@interface StateTests : CyberTestCase
+@end
+
+
+/// The number of round trips made in the handoff test.
+static const int StateTestsHandoffCount = 10000;
+
+/// Echo every change to the first state into the second.
+static void *StateTestsEcho(void *statesv)
+{
+    struct CyberState * _Nonnull *states = statesv;
+    int value = 0;
+
+    for (int i = 0; i < StateTestsHandoffCount; i++) {
+        value = CyberStateAwaitValueChange(value, states[0]);
+        CyberStateSetValue(states[1], value);
+    }
+
+    return NULL;
+}
+
+/// Change a state once, after a delay long enough that anything awaiting the change has to block.
+static void *StateTestsDelayedSet(void *csv)
+{
+    struct CyberState *cs = csv;
+
+    usleep(5000);
+    CyberStateSetValue(cs, CyberStateGetValue(cs) + 1);
+
+    return NULL;
+}
+
+
+@implementation StateTests
+
+- (void)testGetAndSetValue
+{
+    struct CyberState *cs = CyberStateCreate(3);
+    XCTAssertNotEqual(cs, NULL);
+
+    XCTAssertEqual(3, CyberStateGetValue(cs));
+    CyberStateSetValue(cs, -1);
+    XCTAssertEqual(-1, CyberStateGetValue(cs));
+
+    CyberStateDispose(cs);
+}
+
+- (void)testAwaitValueChangeWhenAlreadyChanged
+{
+    // A change made before awaiting must not be missed.
+    struct CyberState *cs = CyberStateCreate(1);
+    XCTAssertNotEqual(cs, NULL);
+
+    CyberStateSetValue(cs, 2);
+    XCTAssertEqual(2, CyberStateAwaitValueChange(1, cs));
+
+    CyberStateDispose(cs);
+}
+
+- (void)testAwaitValueChangeHandoff
+{
+    struct CyberState *states[2] = { CyberStateCreate(0), CyberStateCreate(0) };
+    XCTAssertNotEqual(states[0], NULL);
+    XCTAssertNotEqual(states[1], NULL);
+
+    pthread_t echo;
+    pthread_create(&echo, NULL, StateTestsEcho, states);
+
+    for (int i = 1; i <= StateTestsHandoffCount; i++) {
+        CyberStateSetValue(states[0], i);
+        XCTAssertEqual(i, CyberStateAwaitValueChange(i - 1, states[1]));
+    }
+
+    pthread_join(echo, NULL);
+
+    CyberStateDispose(states[0]);
+    CyberStateDispose(states[1]);
+}
+
+- (void)testSpinCountAdaptsToLongWaits
+{
+    struct CyberState *cs = CyberStateCreate(0);
+    XCTAssertNotEqual(cs, NULL);
+
+    // Waits that always outlast spinning should make spinning as short as allowed. (A single-CPU host never spins, so never adapts.)
+    for (int i = 0; i < 32; i++) {
+        pthread_t setter;
+        pthread_create(&setter, NULL, StateTestsDelayedSet, cs);
+        XCTAssertEqual(i + 1, CyberStateAwaitValueChange(i, cs));
+        pthread_join(setter, NULL);
+    }
+
+    uint32_t expectedSpinCount = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? CYBER_STATE_SPIN_COUNT_MIN : CYBER_STATE_SPIN_COUNT;
+    XCTAssertEqual(expectedSpinCount, atomic_load(&cs->_spinCount));
+
+    CyberStateDispose(cs);
+}
+
+- (void)testPerformanceAwaitValueChangeHandoff
+{
+    // Each iteration makes StateTestsHandoffCount round trips between two threads, so divide by twice that for the latency of one handoff.
+    [self measureBlock:^{
+        struct CyberState *states[2] = { CyberStateCreate(0), CyberStateCreate(0) };
+
+        pthread_t echo;
+        pthread_create(&echo, NULL, StateTestsEcho, states);
+
+        for (int i = 1; i <= StateTestsHandoffCount; i++) {
+            CyberStateSetValue(states[0], i);
+            (void) CyberStateAwaitValueChange(i - 1, states[1]);
+        }
+
+        pthread_join(echo, NULL);
+
+        CyberStateDispose(states[0]);
+        CyberStateDispose(states[1]);
+    }];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,187 @@
+//
+//  ThreadTests.m
+//  CyberTests
+//
+//  Copyright © 2025 Christopher M. Hanson
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CyberTestCase.h"
+
+#import "Cyber962_Internal.h"
+#import "CyberThread.h"
+
+#import <stdatomic.h>
+#import <unistd.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/// Tests for thread placement.
+@interface ThreadTests : CyberTestCase
+@end
+
+
+/// Count the iterations of a thread's loop.
+static void ThreadTestsCountingLoop(struct CyberThread *thread, void * _Nullable counterv)
+{
+    _Atomic int *counter = counterv;
+    atomic_fetch_add(counter, 1);
+}
+
+/// Terminate a thread from its own start function, as another thread might while the start function runs, and then mark the counter.
+static void ThreadTestsTerminatingStart(struct CyberThread *thread, void * _Nullable counterv)
+{
+    _Atomic int *counter = counterv;
+    CyberThreadTerminate(thread);
+    atomic_store(counter, 100);
+}
+
+
+@implementation ThreadTests
+
+- (void)testSiblingCPUMaskIncludesCPU
+{
+    int hostCPUs = CyberThreadGetHostCPUCount();
+    XCTAssertGreaterThanOrEqual(hostCPUs, 1);
+    XCTAssertLessThanOrEqual(hostCPUs, 64);
+
+    for (int cpu = 0; cpu < hostCPUs; cpu++) {
+        XCTAssertNotEqual(0, CyberThreadGetSiblingCPUMask(cpu) & (1ULL << cpu));
+    }
+}
+
+- (void)testDisposeJoinsRunningThread
+{
+    _Atomic int counter = 0;
+    struct CyberThreadFunctions functions = { .loop = ThreadTestsCountingLoop };
+
+    struct CyberThread *thread = CyberThreadCreate("Counting", &functions, &counter);
+    XCTAssertNotEqual(thread, NULL);
+
+    CyberThreadStart(thread);
+    while (atomic_load(&counter) == 0) {
+        usleep(100);
+    }
+
+    // Once disposal returns, the thread has exited, so the loop never runs again.
+    CyberThreadDispose(thread);
+    int finalCount = atomic_load(&counter);
+    usleep(10000);
+    XCTAssertEqual(finalCount, atomic_load(&counter));
+}
+
+- (void)testJoinAfterTerminate
+{
+    _Atomic int counter = 0;
+    struct CyberThreadFunctions functions = { .loop = ThreadTestsCountingLoop };
+
+    struct CyberThread *thread = CyberThreadCreate("Counting", &functions, &counter);
+    XCTAssertNotEqual(thread, NULL);
+
+    CyberThreadTerminate(thread);
+    XCTAssertTrue(CyberThreadJoin(thread, CYBER_THREAD_JOIN_TIMEOUT));
+    XCTAssertEqual(0, atomic_load(&counter));
+
+    CyberThreadDispose(thread);
+}
+
+- (void)testStartAfterTerminate
+{
+    _Atomic int counter = 0;
+    struct CyberThreadFunctions functions = { .loop = ThreadTestsCountingLoop };
+
+    struct CyberThread *thread = CyberThreadCreate("Counting", &functions, &counter);
+    XCTAssertNotEqual(thread, NULL);
+
+    // Termination is final, so neither starting nor stopping the thread afterwards brings it back.
+    CyberThreadTerminate(thread);
+    CyberThreadStart(thread);
+    CyberThreadStop(thread);
+    CyberThreadStart(thread);
+    XCTAssertTrue(CyberThreadJoin(thread, CYBER_THREAD_JOIN_TIMEOUT));
+    XCTAssertEqual(0, atomic_load(&counter));
+
+    CyberThreadDispose(thread);
+}
+
+- (void)testTerminateDuringStart
+{
+    _Atomic int counter = 0;
+    struct CyberThreadFunctions functions = { .start = ThreadTestsTerminatingStart, .loop = ThreadTestsCountingLoop };
+
+    struct CyberThread *thread = CyberThreadCreate("Counting", &functions, &counter);
+    XCTAssertNotEqual(thread, NULL);
+
+    CyberThreadStart(thread);
+    while (atomic_load(&counter) == 0) {
+        usleep(100);
+    }
+
+    // The termination requested while starting must win over the transition to running, so the loop never runs.
+    XCTAssertTrue(CyberThreadJoin(thread, CYBER_THREAD_JOIN_TIMEOUT));
+    XCTAssertEqual(100, atomic_load(&counter));
+
+    CyberThreadDispose(thread);
+}
+
+- (void)testCreateAndDisposeRunningSystems
+{
+    // Systems with running processor threads can be created and disposed of repeatedly, paused or not.
+    for (int i = 0; i < 20; i++) {
+        struct Cyber962 *system = Cyber962Create("Test", (64 * 1024 * 1024), 2, 1);
+        XCTAssertNotEqual(system, NULL);
+
+        Cyber180CPStart(Cyber962GetCentralProcessor(system, 0));
+        Cyber180CPStart(Cyber962GetCentralProcessor(system, 1));
+        Cyber962PPStart(Cyber962IOUGetPeripheralProcessor(Cyber962GetInputOutputUnit(system, 0), 0));
+
+        if ((i % 2) == 0) {
+            Cyber962PauseAll(system);
+        }
+
+        XCTAssertTrue(Cyber962Dispose(system));
+    }
+}
+
+- (void)testIsolatedPlacement
+{
+    struct Cyber962Configuration configuration = {
+        .memorySize = (64 * 1024 * 1024),
+        .centralProcessors = 1,
+        .inputOutputUnits = 1,
+        .runMode = Cyber962RunModeThreaded,
+        .centralProcessorInstructionsPerRound = 1,
+        .placementPolicy = Cyber962PlacementPolicyIsolated,
+    };
+    struct Cyber962 *system = Cyber962CreateWithConfiguration("Test", &configuration);
+    XCTAssertNotEqual(system, NULL);
+
+    // The CP is pinned to a single CPU, and no PP barrel shares its core.
+    uint64_t cpMask = system->_centralProcessorCPUMasks[0];
+    XCTAssertEqual(1, __builtin_popcountll(cpMask));
+
+    uint64_t cpCore = CyberThreadGetSiblingCPUMask(__builtin_ctzll(cpMask));
+    for (int barrel = 0; barrel < 5; barrel++) {
+        XCTAssertEqual(0, system->_barrelCPUMasks[0][barrel] & cpCore);
+    }
+
+    Cyber962Dispose(system);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END